@@ -26,24 +26,168 @@
 #include "audiofilematcher.h"
 #include "formats_in/informat.h"
 #include <QDir>
+#include <QHash>
+#include <QVector>
 #include <QLoggingCategory>
 
 namespace {
 Q_LOGGING_CATEGORY(LOG, "AudioFileMatcher")
 }
 
+/************************************************
+ * The matching is case insensitive, the same way
+ * as QRegExp::CaseInsensitive, char by char.
+ ************************************************/
+static QString toLower(const QString &str)
+{
+    QString res = str;
+    for (QChar &c : res) {
+        c = c.toLower();
+    }
+    return res;
+}
+
+/************************************************
+ * Matches "(.*\D)?0*NUM(.*\D)?" against
+ * name[from, to)
+ ************************************************/
+static bool matchNumber(const QString &name, int from, int to, const QString &num)
+{
+    for (int i = name.indexOf(num, from); i >= 0 && i + num.length() <= to; i = name.indexOf(num, i + 1)) {
+        // Only the longest run of zeros can follow the non-digit
+        int z = i;
+        while (z > from && name.at(z - 1) == '0') {
+            --z;
+        }
+
+        bool prefixOk = (z == from) || !name.at(z - 1).isDigit();
+        bool suffixOk = (i + num.length() == to) || !name.at(to - 1).isDigit();
+        if (prefixOk && suffixOk) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/************************************************
+ * The lower case names of the audio files with
+ * the hash indexes for the matching rules.
+ ************************************************/
+class AudioFileMatcher::Index
+{
+public:
+    explicit Index(const QFileInfoList &files);
+
+    int            count() const { return mNames.count(); }
+    const QString &name(int i) const { return mNames.at(i); }
+
+    // The name ends with one or more audio extensions starting
+    // from this positions, "a.wv.flac" gives positions of ".wv"
+    // and ".flac".
+    const QVector<int> &extPositions(int i) const { return mExtPositions.at(i); }
+
+    // The files with exactly this name.
+    QVector<int> byName(const QString &name) const { return mByName.value(name); }
+
+    // The files with this name followed by the audio extensions.
+    QVector<int> byBaseName(const QString &baseName) const { return mByBaseName.value(baseName); }
+
+    // The files which can contain the text, the caller should check
+    // the candidates.
+    QVector<int> candidates(const QString &text) const;
+
+private:
+    QStringList                  mNames;
+    QVector<QVector<int>>        mExtPositions;
+    QVector<int>                 mAll;
+    QHash<QString, QVector<int>> mByName;
+    QHash<QString, QVector<int>> mByBaseName;
+    QHash<QString, QVector<int>> mBigrams;
+};
+
+/************************************************
+ * All lists of the file numbers are sorted, so
+ * the first match is the same as for the full scan.
+ ************************************************/
+AudioFileMatcher::Index::Index(const QFileInfoList &files)
+{
+    QStringList exts;
+    for (const InputFormat *format : InputFormat::allFormats()) {
+        exts << "." + toLower(format->ext());
+    }
+
+    for (int i = 0; i < files.count(); ++i) {
+        const QString name = toLower(files.at(i).fileName());
+        mNames << name;
+        mAll << i;
+        mByName[name] << i;
+
+        QVector<bool> tail(name.length() + 1, false);
+        tail[name.length()] = true;
+
+        QVector<int> positions;
+        for (int p = name.length() - 1; p >= 0; --p) {
+            if (name.at(p) != '.') {
+                continue;
+            }
+
+            for (const QString &ext : qAsConst(exts)) {
+                if (p + ext.length() <= name.length() && tail[p + ext.length()] && name.midRef(p, ext.length()) == ext) {
+                    tail[p] = true;
+                    positions.prepend(p);
+                    mByBaseName[name.left(p)] << i;
+                    break;
+                }
+            }
+        }
+        mExtPositions << positions;
+
+        for (int p = 0; p + 2 <= name.length(); ++p) {
+            QVector<int> &list = mBigrams[name.mid(p, 2)];
+            if (list.isEmpty() || list.last() != i) {
+                list << i;
+            }
+        }
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+QVector<int> AudioFileMatcher::Index::candidates(const QString &text) const
+{
+    if (text.length() < 2) {
+        return mAll;
+    }
+
+    const QVector<int> *res = nullptr;
+    for (int p = 0; p + 2 <= text.length(); ++p) {
+        auto it = mBigrams.constFind(text.mid(p, 2));
+        if (it == mBigrams.constEnd()) {
+            return QVector<int>();
+        }
+
+        if (!res || it->count() < res->count()) {
+            res = &it.value();
+        }
+    }
+    return *res;
+}
+
 AudioFileMatcher::AudioFileMatcher(const QString &cueFilePath, const DiskTags &tracks) :
+    AudioFileMatcher(cueFilePath, tracks, listAudioFiles(QFileInfo(cueFilePath).dir().path()))
+{
+}
+
+AudioFileMatcher::AudioFileMatcher(const QString &cueFilePath, const DiskTags &tracks, const QFileInfoList &allAudioFiles) :
     mCueFilePath(cueFilePath),
-    mTracks(tracks)
+    mTracks(tracks),
+    mAllAudioFiles(allAudioFiles)
 {
     fillFileTags();
 
     qCDebug(LOG) << "mFileTags =" << mFileTags;
 
-    QDir        dir  = QFileInfo(mCueFilePath).dir();
-    QStringList exts = InputFormat::allFileExts();
-    mAllAudioFiles   = dir.entryInfoList(exts, QDir::Files | QDir::Readable);
-
     for (const auto &fi : qAsConst(mAllAudioFiles)) {
         qDebug(LOG) << "mAllAudioFiles: " << fi.filePath();
     }
@@ -59,10 +203,12 @@ AudioFileMatcher::AudioFileMatcher(const QString &cueFilePath, const DiskTags &t
         return;
     }
 
+    Index index(mAllAudioFiles);
+
     // Looks like this is a per-track album .....
     if (mFileTags.count() == mAllAudioFiles.count()) {
         for (const TrackTags &track : qAsConst(mTracks)) {
-            mResult[track.tag(TagId::File)] = matchAudioFilesByTrack(track);
+            mResult[track.tag(TagId::File)] = matchAudioFilesByTrack(index, track);
         }
         qCDebug(LOG) << "Return per-track album:" << mResult;
         return;
@@ -70,11 +216,16 @@ AudioFileMatcher::AudioFileMatcher(const QString &cueFilePath, const DiskTags &t
 
     // Common search ............................
     for (const QString &fileTag : qAsConst(mFileTags)) {
-        mResult[fileTag] = matchAudioFiles(fileTag);
+        mResult[fileTag] = matchAudioFiles(index, fileTag);
     }
     qCDebug(LOG) << "Return common:" << mResult;
 }
 
+QFileInfoList AudioFileMatcher::listAudioFiles(const QString &dir)
+{
+    return QDir(dir).entryInfoList(InputFormat::allFileExts(), QDir::Files | QDir::Readable);
+}
+
 QStringList AudioFileMatcher::audioFiles(int index) const
 {
     QString tag = mFileTags[index];
@@ -103,97 +254,124 @@ void AudioFileMatcher::fillFileTags()
     }
 }
 
-QStringList AudioFileMatcher::matchAudioFilesByTrack(const TrackTags &track)
+/************************************************
+ * The rules in the order of priority:
+ *   the file name is the FILE tag without extension
+ *   ".*NN.*TITLE.*"
+ *   ".*TITLE.*"
+ *   ".*NN.*"
+ *   the same rules as for the multi-file album
+ ************************************************/
+QStringList AudioFileMatcher::matchAudioFilesByTrack(const Index &index, const TrackTags &track)
 {
-    auto scan = [this](const QString &pattern) -> QString {
-        QRegExp re(QString(pattern), Qt::CaseInsensitive, QRegExp::RegExp2);
-
-        foreach (const QFileInfo &audio, mAllAudioFiles) {
-            if (re.exactMatch(audio.fileName())) {
-                return audio.filePath();
-            }
-        }
-        return "";
-    };
-
     {
-        QString res = scan(QRegExp::escape(QFileInfo(track.tag(TagId::File)).completeBaseName()));
-        if (!res.isEmpty()) {
-            return QStringList(res);
+        const QVector<int> found = index.byName(toLower(QFileInfo(track.tag(TagId::File)).completeBaseName()));
+        if (!found.isEmpty()) {
+            return QStringList(mAllAudioFiles.at(found.first()).filePath());
         }
     }
 
+    const QString num = QString("%1").arg(track.trackNum(), 2, 10, QChar('0'));
+
     if (!track.title().isEmpty()) {
-        QString res = scan(QString(".*%1.*%2.*").arg(track.trackNum(), 2, 10, QChar('0')).arg(QRegExp::escape(track.title())));
-        if (!res.isEmpty()) {
-            return QStringList(res);
+        const QString      title      = toLower(track.title());
+        const QVector<int> candidates = index.candidates(title);
+
+        for (int i : candidates) {
+            int n = index.name(i).indexOf(num);
+            if (n > -1 && index.name(i).indexOf(title, n + num.length()) > -1) {
+                return QStringList(mAllAudioFiles.at(i).filePath());
+            }
         }
 
-        res = scan(QString(".*%1.*").arg(QRegExp::escape(track.title())));
-        if (!res.isEmpty()) {
-            return QStringList(res);
+        for (int i : candidates) {
+            if (index.name(i).contains(title)) {
+                return QStringList(mAllAudioFiles.at(i).filePath());
+            }
         }
     }
 
-    {
-        QString res = scan(QString(".*%1.*").arg(track.trackNum(), 2, 10, QChar('0')));
-        if (!res.isEmpty()) {
-            return QStringList(res);
+    for (int i : index.candidates(num)) {
+        if (index.name(i).contains(num)) {
+            return QStringList(mAllAudioFiles.at(i).filePath());
         }
     }
 
     {
         QStringList res;
-        res = matchAudioFiles(track.tag(TagId::File));
+        res = matchAudioFiles(index, track.tag(TagId::File));
 
         res.removeDuplicates();
         return res;
     }
 }
 
-QStringList AudioFileMatcher::matchAudioFiles(const QString &fileTag)
+/************************************************
+ * For one FILE tag:
+ *   FILE_TAG_BASE_NAME(.ext)+
+ *   CUE_BASE_NAME.*(.ext)+
+ *
+ * For multi-file album, N is the number of the FILE tag:
+ *   FILE_TAG_BASE_NAME(.ext)+
+ *   CUE_BASE_NAME(.*\D)?0*N(.*\D)?(.ext)+
+ *   .*(disk|disc|side)(.*\D)?0*N(.*\D)?(.ext)+
+ ************************************************/
+QStringList AudioFileMatcher::matchAudioFiles(const Index &index, const QString &fileTag)
 {
     QStringList res;
 
-    QStringList patterns;
+    auto hasExt = [&index](int i, int from, const QString &num) {
+        for (int p : index.extPositions(i)) {
+            if (p >= from && (num.isEmpty() || matchNumber(index.name(i), from, p, num))) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const QString cueBaseName = toLower(QFileInfo(mCueFilePath).completeBaseName());
+
     if (mFileTags.count() == 1) {
-        patterns << QRegExp::escape(QFileInfo(mFileTags.first()).completeBaseName());
-        patterns << QRegExp::escape(QFileInfo(mCueFilePath).completeBaseName()) + ".*";
+        for (int i : index.byBaseName(toLower(QFileInfo(mFileTags.first()).completeBaseName()))) {
+            res << mAllAudioFiles.at(i).filePath();
+        }
+
+        for (int i = 0; i < index.count(); ++i) {
+            if (index.name(i).startsWith(cueBaseName) && hasExt(i, cueBaseName.length(), "")) {
+                res << mAllAudioFiles.at(i).filePath();
+            }
+        }
     }
     else {
-        int fileTagNum = mFileTags.indexOf(fileTag) + 1; // Disks are indexed from 1, not from 0!
-        patterns << QRegExp::escape(QFileInfo(fileTag).completeBaseName());
-        patterns << QRegExp::escape(QFileInfo(mCueFilePath).completeBaseName()) + QString("(.*\\D)?"
-                                                                                          "0*"
-                                                                                          "%1"
-                                                                                          "(.*\\D)?")
-                                                                                          .arg(fileTagNum);
-        patterns << QString(".*"
-                            "(disk|disc|side)"
-                            "(.*\\D)?"
-                            "0*"
-                            "%1"
-                            "(.*\\D)?")
-                            .arg(fileTagNum);
-    }
-
-    qCDebug(LOG) << "matchAudioFiles: patterns=" << patterns;
-    QString audioExt;
-    foreach (const InputFormat *format, InputFormat::allFormats()) {
-        audioExt += (audioExt.isEmpty() ? "\\." : "|\\.") + format->ext();
-    }
-
-    foreach (const QString &pattern, patterns) {
-        QRegExp re(QString("%1(%2)+").arg(pattern).arg(audioExt), Qt::CaseInsensitive, QRegExp::RegExp2);
-        foreach (const QFileInfo &audio, mAllAudioFiles) {
-            qCDebug(LOG) << "matchAudioFiles test: re=" << re << "file=" << audio.filePath();
-            if (re.exactMatch(audio.fileName())) {
-                res << audio.filePath();
-                qCDebug(LOG) << "matchAudioFiles test: MATCH";
+        const QString num = QString::number(mFileTags.indexOf(fileTag) + 1); // Disks are indexed from 1, not from 0!
+
+        for (int i : index.byBaseName(toLower(QFileInfo(fileTag).completeBaseName()))) {
+            res << mAllAudioFiles.at(i).filePath();
+        }
+
+        for (int i = 0; i < index.count(); ++i) {
+            if (index.name(i).startsWith(cueBaseName) && hasExt(i, cueBaseName.length(), num)) {
+                res << mAllAudioFiles.at(i).filePath();
+            }
+        }
+
+        static const QStringList KEYWORDS = { "disk", "disc", "side" };
+        for (int i = 0; i < index.count(); ++i) {
+            const QString &name  = index.name(i);
+            bool           found = false;
+            for (const QString &keyword : KEYWORDS) {
+                for (int n = name.indexOf(keyword); n > -1 && !found; n = name.indexOf(keyword, n + 1)) {
+                    found = hasExt(i, n + keyword.length(), num);
+                }
+            }
+
+            if (found) {
+                res << mAllAudioFiles.at(i).filePath();
             }
         }
     }
 
+    qCDebug(LOG) << "matchAudioFiles:" << fileTag << res;
     res.removeDuplicates();
     return res;
 }
@@ -34,7 +34,12 @@
 class AudioFileMatcher
 {
 public:
+    AudioFileMatcher() = default;
     AudioFileMatcher(const QString &cueFilePath, const DiskTags &tracks);
+    AudioFileMatcher(const QString &cueFilePath, const DiskTags &tracks, const QFileInfoList &allAudioFiles);
+
+    // The readable audio files in the directory, sorted by name.
+    static QFileInfoList listAudioFiles(const QString &dir);
 
     const DiskTags &tracks() const { return mTracks; }
 
@@ -51,9 +56,11 @@ private:
     QFileInfoList              mAllAudioFiles;
     QMap<QString, QStringList> mResult;
 
+    class Index;
+
     void        fillFileTags();
-    QStringList matchAudioFilesByTrack(const TrackTags &track);
-    QStringList matchAudioFiles(const QString &fileTag);
+    QStringList matchAudioFilesByTrack(const Index &index, const TrackTags &track);
+    QStringList matchAudioFiles(const Index &index, const QString &fileTag);
 };
 
 #endif // AUDIOFILEMATCHER_H
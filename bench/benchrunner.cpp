@@ -0,0 +1,165 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "benchrunner.h"
+#include "converter/converter.h"
+#include "converter/processusage.h"
+#include "profiles.h"
+#include "project.h"
+#include "settings.h"
+#include "types.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+/************************************************
+ *
+ ************************************************/
+QJsonObject BenchResult::toJson() const
+{
+    QJsonObject res;
+    res["ok"] = ok;
+    if (!error.isEmpty()) {
+        res["error"] = error;
+    }
+    res["failedTracks"]  = failedTracks;
+    res["wallTime"]      = wallTime / 1000.0;
+    res["cpuTime"]       = (flaconCpuTime + programsTime) / 1000000.0;
+    res["flaconCpuTime"] = flaconCpuTime / 1000000.0;
+    res["programsTime"]  = programsTime / 1000000.0;
+    res["realtime"]      = realtime;
+    res["peakTempBytes"] = peakTempBytes;
+    res["outputBytes"]   = outputBytes;
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+qint64 BenchRunner::dirSize(const QString &dir)
+{
+    qint64       res = 0;
+    QDirIterator it(dir, QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        res += it.fileInfo().size();
+    }
+    return res;
+}
+
+/************************************************
+ * Includes all threads of the process.
+ ************************************************/
+qint64 BenchRunner::processCpuTime()
+{
+#ifdef Q_OS_UNIX
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) {
+        return 0;
+    }
+
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000LL + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+#else
+    return 0;
+#endif
+}
+
+/************************************************
+ *
+ ************************************************/
+BenchResult BenchRunner::run(const QString &cueFile, uint durationSec, const Profile &profile, int threadsCount, const QString &workDir)
+{
+    BenchResult res;
+
+    const QString tmpDir = workDir + "/tmp";
+    const QString outDir = workDir + "/out";
+    QDir(tmpDir).removeRecursively();
+    QDir(outDir).removeRecursively();
+    QDir().mkpath(tmpDir);
+    QDir().mkpath(outDir);
+
+    Settings::i()->setValue(Settings::Encoder_ThreadCount, threadsCount);
+    Settings::i()->setValue(Settings::Encoder_TmpDir, tmpDir);
+
+    Profile prof = profile;
+    prof.setOutFileDir(outDir);
+
+    project->clear();
+    try {
+        project->addCueFile(cueFile);
+    }
+    catch (FlaconError &err) {
+        res.error = err.what();
+        return res;
+    }
+
+    Conv::Converter converter;
+    QEventLoop      loop;
+    QObject::connect(&converter, &Conv::Converter::finished, &loop, &QEventLoop::quit);
+    QObject::connect(&converter, &Conv::Converter::error, [&res](const QString &message) { res.error = message; });
+    QObject::connect(&converter, &Conv::Converter::trackFailed, [&res](const Track &, const Profile &, const QString &, const QString &) { res.failedTracks++; });
+
+    QTimer poll;
+    poll.setInterval(POLL_INTERVAL);
+    QObject::connect(&poll, &QTimer::timeout, [&res, &tmpDir]() {
+        res.peakTempBytes = qMax(res.peakTempBytes, dirSize(tmpDir));
+    });
+
+    Conv::ProcessUsageStatistic::instance()->reset();
+    qint64        cpuStart = processCpuTime();
+    QElapsedTimer timer;
+    timer.start();
+
+    converter.start(Profiles() << prof);
+    if (converter.isRunning()) {
+        poll.start();
+        loop.exec();
+        poll.stop();
+    }
+
+    res.wallTime      = qMax(qint64(1), timer.elapsed());
+    res.flaconCpuTime = processCpuTime() - cpuStart;
+
+    const QMap<QString, Conv::ProcessUsage> usage = Conv::ProcessUsageStatistic::instance()->byProgram();
+    for (const Conv::ProcessUsage &u : usage) {
+        res.programsTime += u.userTime + u.systemTime;
+    }
+
+    res.outputBytes = dirSize(outDir);
+    res.realtime    = durationSec * 1000.0 / res.wallTime;
+    res.ok          = res.error.isEmpty() && res.failedTracks == 0 && res.outputBytes > 0;
+
+    project->clear();
+    QDir(tmpDir).removeRecursively();
+    QDir(outDir).removeRecursively();
+    return res;
+}
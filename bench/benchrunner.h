@@ -0,0 +1,67 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef BENCHRUNNER_H
+#define BENCHRUNNER_H
+
+#include <QJsonObject>
+#include <QString>
+
+class Profile;
+
+struct BenchResult
+{
+    bool    ok            = false;
+    QString error;
+    int     failedTracks  = 0;
+    qint64  wallTime      = 0; // msec
+    qint64  flaconCpuTime = 0; // usec, the flacon process itself
+    qint64  programsTime  = 0; // usec, user + system time of the external programs
+    qint64  peakTempBytes = 0;
+    qint64  outputBytes   = 0;
+    double  realtime      = 0; // The audio duration divided by the wall time
+
+    QJsonObject toJson() const;
+};
+
+/************************************************
+ * Runs the real Converter for one CUE file and
+ * one profile. The temporary directory is polled
+ * while the converter works, so the peak usage is
+ * accurate up to the poll interval.
+ ************************************************/
+class BenchRunner
+{
+public:
+    static constexpr int POLL_INTERVAL = 20; // msec
+
+    BenchResult run(const QString &cueFile, uint durationSec, const Profile &profile, int threadsCount, const QString &workDir);
+
+private:
+    static qint64 dirSize(const QString &dir);
+    static qint64 processCpuTime();
+};
+
+#endif // BENCHRUNNER_H
@@ -0,0 +1,212 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "benchrunner.h"
+#include "syntheticdisc.h"
+#include "formats_out/outformat.h"
+#include "profiles.h"
+#include "settings.h"
+#include "types.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+
+/************************************************
+ *
+ ************************************************/
+static QStringList splitList(const QString &str)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+    return str.split(',', QString::SkipEmptyParts);
+#else
+    return str.split(',', Qt::SkipEmptyParts);
+#endif
+}
+
+/************************************************
+ *
+ ************************************************/
+static QList<int> parseIntList(const QString &str, bool *ok)
+{
+    QList<int> res;
+    for (const QString &s : splitList(str)) {
+        int n = s.trimmed().toInt(ok);
+        if (!*ok || n < 1) {
+            *ok = false;
+            return {};
+        }
+        res << n;
+    }
+    *ok = !res.isEmpty();
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    initTypes();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures the conversion pipeline on synthetic discs and prints the JSON report.");
+    parser.addHelpOption();
+
+    QCommandLineOption durationOption("duration", "The disc length in seconds.", "sec", "600");
+    QCommandLineOption tracksOption("tracks", "The number of tracks.", "count", "10");
+    QCommandLineOption sampleRateOption("sample-rate", "The sample rate.", "hz", "44100");
+    QCommandLineOption bitsOption("bits", "Bits per sample, 16 or 24.", "bits", "16");
+    QCommandLineOption layoutOption("layout", "Comma separated disc layouts: single (one file), multi (file per track).", "layouts", "single,multi");
+    QCommandLineOption profilesOption("profiles", "Comma separated output format IDs.", "formats", "FLAC");
+    QCommandLineOption threadsOption("threads", "Comma separated thread counts.", "counts", QString("1,%1").arg(QThread::idealThreadCount()));
+    QCommandLineOption repeatOption("repeat", "Run every combination N times.", "N", "1");
+    QCommandLineOption outputOption({ "o", "output" }, "Write the report to the file instead of stdout.", "file");
+    QCommandLineOption workDirOption("work-dir", "The directory for the synthetic discs and the results.", "dir");
+
+    parser.addOptions({ durationOption, tracksOption, sampleRateOption, bitsOption, layoutOption,
+                        profilesOption, threadsOption, repeatOption, outputOption, workDirOption });
+    parser.process(app);
+
+    QTextStream err(stderr);
+
+    SyntheticDisc::Spec spec;
+    bool                ok = true;
+    spec.durationSec       = parser.value(durationOption).toUInt(&ok);
+    ok                     = ok && spec.durationSec > 0;
+    spec.tracksCount       = ok ? parser.value(tracksOption).toInt(&ok) : 0;
+    spec.sampleRate        = ok ? parser.value(sampleRateOption).toUInt(&ok) : 0;
+    spec.bitsPerSample     = ok ? parser.value(bitsOption).toUShort(&ok) : 0;
+    int repeat             = ok ? parser.value(repeatOption).toInt(&ok) : 0;
+    QList<int> threads     = ok ? parseIntList(parser.value(threadsOption), &ok) : QList<int>();
+    if (!ok || repeat < 1) {
+        err << "Error: invalid option value\n";
+        return 1;
+    }
+
+    QList<SyntheticDisc::Layout> layouts;
+    for (const QString &s : splitList(parser.value(layoutOption))) {
+        SyntheticDisc::Layout layout;
+        if (!SyntheticDisc::layoutFromString(s.trimmed(), &layout)) {
+            err << "Error: unknown layout " << s << "\n";
+            return 1;
+        }
+        layouts << layout;
+    }
+
+    Profiles profiles;
+    for (const QString &s : splitList(parser.value(profilesOption))) {
+        OutFormat *format = OutFormat::formatForId(s.trimmed());
+        if (!format) {
+            err << "Error: unknown format " << s << "\n";
+            return 1;
+        }
+        profiles << Profile(*format, format->id());
+    }
+
+    QTemporaryDir tmp;
+    QString       workDir = parser.isSet(workDirOption) ? parser.value(workDirOption) : tmp.path();
+    if (workDir.isEmpty() || !QDir().mkpath(workDir)) {
+        err << "Error: can't create the work directory\n";
+        return 1;
+    }
+    Settings::setFileName(workDir + "/flacon.conf");
+    Settings::i()->setValue(Settings::ConvCache_Enabled, false);
+
+    QJsonObject discJson;
+    discJson["duration"]      = int(spec.durationSec);
+    discJson["tracks"]        = spec.tracksCount;
+    discJson["sampleRate"]    = int(spec.sampleRate);
+    discJson["bitsPerSample"] = spec.bitsPerSample;
+
+    QJsonArray runs;
+    for (SyntheticDisc::Layout layout : qAsConst(layouts)) {
+        spec.layout     = layout;
+        QString discDir = workDir + "/disc-" + SyntheticDisc::layoutToString(layout);
+        QString cueFile;
+        try {
+            err << "Generate " << SyntheticDisc::layoutToString(layout) << " file disc\n";
+            err.flush();
+            cueFile = SyntheticDisc::create(spec, discDir);
+        }
+        catch (FlaconError &e) {
+            err << "Error: " << e.what() << "\n";
+            return 2;
+        }
+
+        for (const Profile &profile : qAsConst(profiles)) {
+            for (int threadsCount : qAsConst(threads)) {
+                for (int n = 0; n < repeat; ++n) {
+                    BenchResult result = BenchRunner().run(cueFile, spec.durationSec, profile, threadsCount, workDir + "/run");
+
+                    QJsonObject run = result.toJson();
+                    run["layout"]   = SyntheticDisc::layoutToString(layout);
+                    run["profile"]  = profile.id();
+                    run["threads"]  = threadsCount;
+                    run["repeat"]   = n;
+                    runs << run;
+
+                    err << SyntheticDisc::layoutToString(layout) << " " << profile.id() << " threads=" << threadsCount << ": ";
+                    if (result.ok) {
+                        err << QString::number(result.realtime, 'f', 1) << "x realtime\n";
+                    }
+                    else {
+                        err << "FAILED " << result.error << "\n";
+                    }
+                    err.flush();
+                }
+            }
+        }
+    }
+
+    QJsonObject report;
+    report["cpus"] = QThread::idealThreadCount();
+    report["disc"] = discJson;
+    report["runs"] = runs;
+
+    QFile out;
+    if (parser.isSet(outputOption)) {
+        out.setFileName(parser.value(outputOption));
+        ok = out.open(QFile::WriteOnly | QFile::Truncate);
+    }
+    else {
+        ok = out.open(stdout, QFile::WriteOnly);
+    }
+
+    if (!ok) {
+        err << "Error: can't write the report: " << out.errorString() << "\n";
+        return 3;
+    }
+
+    out.write(QJsonDocument(report).toJson());
+    return 0;
+}
@@ -0,0 +1,382 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "audiofilematcher.h"
+#include "cue.h"
+#include "cuedata.h"
+#include "patternexpander.h"
+#include "types.h"
+#include "converter/replaygain.h"
+#include "converter/wavheader.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QRegExp>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTextCodec>
+
+/************************************************
+ * The input data is generated with the fixed seed,
+ * so the numbers are comparable between the runs.
+ ************************************************/
+static constexpr quint32 SEED = 2463534242u;
+
+/************************************************
+ *
+ ************************************************/
+class BenchWavHeader : public Conv::WavHeader
+{
+public:
+    BenchWavHeader(quint16 bitsPerSample, quint32 sampleRate, quint64 dataSize, bool wave64, bool extensible)
+    {
+        m64Bit         = wave64;
+        mFormat        = extensible ? Format_Extensible : Format_PCM;
+        mNumChannels   = 2;
+        mSampleRate    = sampleRate;
+        mBitsPerSample = bitsPerSample;
+        mByteRate      = mSampleRate * mBitsPerSample / 8 * mNumChannels;
+        mBlockAlign    = mBitsPerSample * mNumChannels / 8;
+        mDataSize      = dataSize;
+
+        if (extensible) {
+            mFmtSize            = FmtChunkExt;
+            mExtSize            = 22;
+            mValidBitsPerSample = bitsPerSample;
+            mChannelMask        = 0x3;
+            mSubFormat          = QByteArray("\x01\x00\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71", 16);
+        }
+
+        mDataStartPos = toByteArray().size();
+        mFileSize     = mDataStartPos + mDataSize;
+    }
+};
+
+/************************************************
+ *
+ ************************************************/
+static QByteArray randomData(int size, quint32 seed = SEED)
+{
+    QByteArray res(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        // xorshift32
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        res[i] = char(seed);
+    }
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+static void writeFile(const QString &fileName, const QByteArray &data)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        QFAIL(QString("Can't create file %1: %2").arg(fileName, file.errorString()).toLocal8Bit());
+    }
+    file.write(data);
+}
+
+/************************************************
+ *
+ ************************************************/
+class MicroBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchTrackGain_data();
+    void benchTrackGain();
+
+    void benchWavHeader_data();
+    void benchWavHeader();
+
+    void benchCueData_data();
+    void benchCueData();
+
+    void benchPatternExpander_data();
+    void benchPatternExpander();
+
+    void benchAudioFileMatcher_data();
+    void benchAudioFileMatcher();
+
+private:
+    QTemporaryDir mDir;
+
+    QByteArray createCue(int tracksCount, bool multiFile, const QString &text) const;
+};
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::initTestCase()
+{
+    initTypes();
+    QLoggingCategory::setFilterRules("*.debug=false\n");
+    QVERIFY(mDir.isValid());
+}
+
+/************************************************
+ * The CUE text is in UTF-8, the codec converts it.
+ ************************************************/
+QByteArray MicroBench::createCue(int tracksCount, bool multiFile, const QString &text) const
+{
+    QString cue;
+    cue += "REM GENRE \"Bench\"\n";
+    cue += "REM DATE 2026\n";
+    cue += QString("PERFORMER \"%1\"\n").arg(text);
+    cue += QString("TITLE \"%1\"\n").arg(text);
+
+    if (!multiFile) {
+        cue += "FILE \"disc.flac\" WAVE\n";
+    }
+
+    for (int i = 1; i <= tracksCount; ++i) {
+        if (multiFile) {
+            cue += QString("FILE \"%1 - %2.flac\" WAVE\n").arg(i, 2, 10, QChar('0')).arg(text);
+        }
+        cue += QString("  TRACK %1 AUDIO\n").arg(i, 2, 10, QChar('0'));
+        cue += QString("    TITLE \"%1 %2\"\n").arg(text).arg(i);
+        cue += QString("    PERFORMER \"%1\"\n").arg(text);
+        cue += "    FLAGS DCP\n";
+        cue += "    INDEX 00 00:00:00\n";
+        cue += QString("    INDEX 01 %1:%2:00\n").arg(i * 4 / 60, 2, 10, QChar('0')).arg(i * 4 % 60, 2, 10, QChar('0'));
+    }
+
+    return cue.toUtf8();
+}
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::benchTrackGain_data()
+{
+    QTest::addColumn<int>("bitsPerSample");
+    QTest::addColumn<int>("sampleRate");
+
+    for (int bits : { 16, 24, 32 }) {
+        for (int rate : { 44100, 48000, 96000, 192000 }) {
+            QTest::newRow(QString("%1bit %2Hz").arg(bits).arg(rate).toLocal8Bit()) << bits << rate;
+        }
+    }
+}
+
+/************************************************
+ * One second of the stereo audio per iteration.
+ ************************************************/
+void MicroBench::benchTrackGain()
+{
+    QFETCH(int, bitsPerSample);
+    QFETCH(int, sampleRate);
+
+    const int  dataSize = sampleRate * bitsPerSample / 8 * 2;
+    QByteArray header   = BenchWavHeader(bitsPerSample, sampleRate, dataSize, false, false).toByteArray();
+    QByteArray data     = randomData(dataSize);
+
+    QBENCHMARK {
+        ReplayGain::TrackGain gain;
+        gain.add(header.constData(), header.size());
+        gain.add(data.constData(), data.size());
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::benchWavHeader_data()
+{
+    QTest::addColumn<QByteArray>("header");
+
+    QTest::newRow("WAV") << BenchWavHeader(16, 44100, 1024 * 1024, false, false).toByteArray();
+    QTest::newRow("WAV extensible") << BenchWavHeader(24, 96000, 1024 * 1024, false, true).toByteArray();
+    QTest::newRow("Wave64") << BenchWavHeader(16, 44100, 1024 * 1024, true, false).toByteArray();
+    QTest::newRow("Wave64 extensible") << BenchWavHeader(24, 192000, 1024 * 1024, true, true).toByteArray();
+}
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::benchWavHeader()
+{
+    QFETCH(QByteArray, header);
+
+    QBuffer buf(&header);
+    buf.open(QBuffer::ReadOnly);
+
+    QBENCHMARK {
+        buf.seek(0);
+        Conv::WavHeader hdr(&buf);
+        QVERIFY(hdr.dataSize() > 0);
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::benchCueData_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    const QString latin    = "Ludwig van Beethoven";
+    const QString cyrillic = QString::fromUtf8("Пётр Ильич Чайковский");
+    const QString japanese = QString::fromUtf8("坂本龍一");
+
+    QByteArray utf8 = createCue(99, false, latin);
+    QTest::newRow("UTF-8") << utf8;
+    QTest::newRow("UTF-8 BOM") << QByteArray("\xEF\xBB\xBF") + createCue(99, false, cyrillic);
+
+    QTextCodec *cp1251 = QTextCodec::codecForName("Windows-1251");
+    if (cp1251) {
+        QTest::newRow("Windows-1251") << cp1251->fromUnicode(QString::fromUtf8(createCue(99, false, cyrillic)));
+    }
+
+    QTextCodec *sjis = QTextCodec::codecForName("Shift-JIS");
+    if (sjis) {
+        QTest::newRow("Shift-JIS") << sjis->fromUnicode(QString::fromUtf8(createCue(99, true, japanese)));
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::benchCueData()
+{
+    QFETCH(QByteArray, data);
+
+    QBuffer buf(&data);
+    buf.open(QBuffer::ReadOnly);
+
+    QBENCHMARK {
+        buf.seek(0);
+        CueData cue(&buf);
+        QCOMPARE(cue.tracks().count(), 99);
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::benchPatternExpander_data()
+{
+    QTest::addColumn<QString>("pattern");
+
+    QTest::newRow("simple") << "%a/%A/%n - %t";
+    QTest::newRow("optional") << "%a/{%y - }%A/{Disc %d/}%n - %t";
+    QTest::newRow("nested") << "{%g/}%a/{%y - }%A{ [%D discs]}/{{%d-}%n. }%t{ (%g)}";
+}
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::benchPatternExpander()
+{
+    QFETCH(QString, pattern);
+
+    PatternExpander expander;
+    expander.setTrackCount(12);
+    expander.setTrackNum(7);
+    expander.setDiscCount(2);
+    expander.setDiscNum(1);
+    expander.setArtist("Artist");
+    expander.setAlbum("Album");
+    expander.setTrackTtle("Title");
+    expander.setGenre("Genre");
+    expander.setDate("2026");
+
+    QBENCHMARK {
+        QVERIFY(!expander.expand(pattern).isEmpty());
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::benchAudioFileMatcher_data()
+{
+    QTest::addColumn<QString>("cueFile");
+
+    struct Case
+    {
+        const char *name;
+        int         tracks;
+        bool        multiFile;
+        int         extraFiles;
+    };
+
+    const Case cases[] = {
+        { "single file", 12, false, 0 },
+        { "single file, 40 extra", 12, false, 40 },
+        { "per-track", 30, true, 0 },
+        { "per-track, 40 extra", 30, true, 40 },
+    };
+
+    for (const Case &c : cases) {
+        QString dir = mDir.path() + "/" + QString(c.name).replace(QRegExp("\\W+"), "_");
+        QDir().mkpath(dir);
+
+        QString cueFile = dir + "/disc.cue";
+        writeFile(cueFile, createCue(c.tracks, c.multiFile, "Track"));
+
+        if (c.multiFile) {
+            for (int i = 1; i <= c.tracks; ++i) {
+                writeFile(QString("%1/%2 - Track.flac").arg(dir).arg(i, 2, 10, QChar('0')), QByteArray());
+            }
+        }
+        else {
+            writeFile(dir + "/disc.flac", QByteArray());
+        }
+
+        for (int i = 0; i < c.extraFiles; ++i) {
+            writeFile(QString("%1/other %2.wv").arg(dir).arg(i), QByteArray());
+        }
+
+        QTest::newRow(c.name) << cueFile;
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void MicroBench::benchAudioFileMatcher()
+{
+    QFETCH(QString, cueFile);
+
+    Cue cue(cueFile);
+
+    QBENCHMARK {
+        AudioFileMatcher matcher(cueFile, cue.tracks());
+        QVERIFY(!matcher.audioFiles(0).isEmpty());
+    }
+}
+
+QTEST_GUILESS_MAIN(MicroBench)
+#include "microbench.moc"
@@ -0,0 +1,220 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "syntheticdisc.h"
+#include "types.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QtEndian>
+#include <cmath>
+
+static constexpr int CHANNELS = 2;
+
+/************************************************
+ *
+ ************************************************/
+QString SyntheticDisc::layoutToString(Layout layout)
+{
+    switch (layout) {
+        case Layout::SingleFile:
+            return "single";
+        case Layout::MultiFile:
+            return "multi";
+    }
+    return "";
+}
+
+/************************************************
+ *
+ ************************************************/
+bool SyntheticDisc::layoutFromString(const QString &str, Layout *layout)
+{
+    if (str == "single") {
+        *layout = Layout::SingleFile;
+        return true;
+    }
+
+    if (str == "multi") {
+        *layout = Layout::MultiFile;
+        return true;
+    }
+
+    return false;
+}
+
+/************************************************
+ *
+ ************************************************/
+QString SyntheticDisc::create(const Spec &spec, const QString &dir)
+{
+    if (spec.tracksCount < 1 || spec.tracksCount > 99) {
+        throw FlaconError(QString("Invalid tracks count %1").arg(spec.tracksCount));
+    }
+
+    if (spec.bitsPerSample != 16 && spec.bitsPerSample != 24) {
+        throw FlaconError(QString("Unsupported bits per sample %1").arg(spec.bitsPerSample));
+    }
+
+    if (!QDir().mkpath(dir)) {
+        throw FlaconError(QString("Can't create directory %1").arg(dir));
+    }
+
+    // The track boundaries are on the CD frames, 75 per second
+    const quint64 totalFrames = quint64(spec.durationSec) * 75;
+    const quint64 trackFrames = totalFrames / spec.tracksCount;
+    if (trackFrames == 0) {
+        throw FlaconError("The disc is too short");
+    }
+
+    auto framesToSamples = [&spec](quint64 frames) { return frames * spec.sampleRate / 75; };
+
+    QString cueFile = dir + "/disc.cue";
+    QFile   file(cueFile);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        throw FlaconError(QString("Can't create file %1: %2").arg(cueFile, file.errorString()));
+    }
+
+    QTextStream cue(&file);
+    cue << "REM GENRE \"Bench\"\n";
+    cue << "REM DATE 2026\n";
+    cue << "PERFORMER \"Flacon Bench\"\n";
+    cue << "TITLE \"Synthetic disc\"\n";
+
+    if (spec.layout == Layout::SingleFile) {
+        writeWavFile(dir + "/disc.wav", spec, 0, framesToSamples(totalFrames));
+        cue << "FILE \"disc.wav\" WAVE\n";
+    }
+
+    for (int i = 0; i < spec.tracksCount; ++i) {
+        const quint64 start = i * trackFrames;
+        const quint64 len   = (i == spec.tracksCount - 1) ? totalFrames - start : trackFrames;
+
+        if (spec.layout == Layout::MultiFile) {
+            QString wav = QString("%1.wav").arg(i + 1, 2, 10, QChar('0'));
+            writeWavFile(dir + "/" + wav, spec, framesToSamples(start), framesToSamples(len));
+            cue << "FILE \"" << wav << "\" WAVE\n";
+        }
+
+        const quint64 index = (spec.layout == Layout::SingleFile) ? start : 0;
+        cue << QString("  TRACK %1 AUDIO\n").arg(i + 1, 2, 10, QChar('0'));
+        cue << QString("    TITLE \"Track %1\"\n").arg(i + 1);
+        cue << QString("    INDEX 01 %1:%2:%3\n")
+                        .arg(index / 75 / 60, 2, 10, QChar('0'))
+                        .arg(index / 75 % 60, 2, 10, QChar('0'))
+                        .arg(index % 75, 2, 10, QChar('0'));
+    }
+
+    cue.flush();
+    if (file.error() != QFile::NoError) {
+        throw FlaconError(QString("Can't write file %1: %2").arg(cueFile, file.errorString()));
+    }
+
+    return cueFile;
+}
+
+/************************************************
+ * The startSample keeps the signal continuous
+ * between the files of the multi-file disc.
+ ************************************************/
+void SyntheticDisc::writeWavFile(const QString &fileName, const Spec &spec, quint64 startSample, quint64 samplesCount)
+{
+    const int     bytesPerSample = spec.bitsPerSample / 8;
+    const quint32 blockAlign     = bytesPerSample * CHANNELS;
+    const quint64 dataSize       = samplesCount * blockAlign;
+
+    if (dataSize + 36 > 0xFFFFFFFFull) {
+        throw FlaconError(QString("The file %1 is too large for WAV").arg(fileName));
+    }
+
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        throw FlaconError(QString("Can't create file %1: %2").arg(fileName, file.errorString()));
+    }
+
+    QByteArray hdr;
+    auto       put16 = [&hdr](quint16 v) {
+        v = qToLittleEndian(v);
+        hdr.append(reinterpret_cast<const char *>(&v), 2);
+    };
+    auto put32 = [&hdr](quint32 v) {
+        v = qToLittleEndian(v);
+        hdr.append(reinterpret_cast<const char *>(&v), 4);
+    };
+
+    hdr.append("RIFF");
+    put32(quint32(36 + dataSize));
+    hdr.append("WAVEfmt ");
+    put32(16);
+    put16(1); // PCM
+    put16(CHANNELS);
+    put32(spec.sampleRate);
+    put32(spec.sampleRate * blockAlign);
+    put16(quint16(blockAlign));
+    put16(spec.bitsPerSample);
+    hdr.append("data");
+    put32(quint32(dataSize));
+    file.write(hdr);
+
+    const double maxValue = (1 << (spec.bitsPerSample - 1)) - 1;
+    const double twoPi    = 2 * M_PI;
+    quint32      noise    = 2463534242u;
+
+    QByteArray buf;
+    buf.reserve(1024 * 1024 + blockAlign);
+
+    for (quint64 n = startSample; n < startSample + samplesCount; ++n) {
+        double t = double(n) / spec.sampleRate;
+
+        // The melody changes every 2 seconds
+        double note = 220.0 * std::pow(2.0, double((n / (spec.sampleRate * 2)) % 12) / 12.0);
+        double base = 0.4 * std::sin(twoPi * note * t) + 0.2 * std::sin(twoPi * note * 1.5 * t);
+
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            // xorshift32
+            noise ^= noise << 13;
+            noise ^= noise >> 17;
+            noise ^= noise << 5;
+
+            double v      = base * (ch ? 0.9 : 1.0) + 0.02 * (double(noise) / 0xFFFFFFFFu - 0.5);
+            qint32 sample = qint32(v * maxValue);
+
+            for (int b = 0; b < bytesPerSample; ++b) {
+                buf.append(char((sample >> (8 * b)) & 0xFF));
+            }
+        }
+
+        if (buf.size() >= 1024 * 1024) {
+            file.write(buf);
+            buf.resize(0);
+        }
+    }
+    file.write(buf);
+
+    if (file.error() != QFile::NoError) {
+        throw FlaconError(QString("Can't write file %1: %2").arg(fileName, file.errorString()));
+    }
+}
@@ -0,0 +1,64 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef SYNTHETICDISC_H
+#define SYNTHETICDISC_H
+
+#include <QString>
+
+/************************************************
+ * Generates the WAV files and the CUE sheet for
+ * the benchmark. The audio is a mix of slowly
+ * changing tones and low level noise, so the
+ * encoders do a realistic amount of work.
+ ************************************************/
+class SyntheticDisc
+{
+public:
+    enum class Layout {
+        SingleFile, // One WAV file for the whole disc
+        MultiFile,  // One WAV file per track
+    };
+
+    struct Spec
+    {
+        uint    durationSec   = 600;
+        int     tracksCount   = 10;
+        quint32 sampleRate    = 44100;
+        quint16 bitsPerSample = 16;
+        Layout  layout        = Layout::SingleFile;
+    };
+
+    // Returns the CUE file name.
+    static QString create(const Spec &spec, const QString &dir) noexcept(false);
+
+    static QString layoutToString(Layout layout);
+    static bool    layoutFromString(const QString &str, Layout *layout);
+
+private:
+    static void writeWavFile(const QString &fileName, const Spec &spec, quint64 startSample, quint64 samplesCount);
+};
+
+#endif // SYNTHETICDISC_H
@@ -34,3 +34,13 @@ macro(add_tests TESTS_DIR)
     status_message("For building tests use -DBUILD_TESTS=Yes option.")
   endif()
 endmacro()
+
+macro(add_bench BENCH_DIR)
+  option(BUILD_BENCH "Build the flacon_bench benchmark." $ENV{BUILD_BENCH})
+
+  if(BUILD_BENCH)
+    add_subdirectory(${BENCH_DIR})
+  else()
+    status_message("For building the benchmark use -DBUILD_BENCH=Yes option.")
+  endif()
+endmacro()
@@ -24,7 +24,9 @@
  * END_COMMON_COPYRIGHT_HEADER */
 
 #include "consoleout.h"
+#include "converter/conversioncache.h"
 #include <QTextStream>
+#include <QRegExp>
 
 /************************************************
  *
@@ -53,7 +55,7 @@ void ConsoleOut::converterFinished()
 /************************************************
  *
  ************************************************/
-void ConsoleOut::trackProgress(const Track &track, TrackState state, Percent)
+void ConsoleOut::outputProgress(const Track &, const Profile &, const QString &resultFile, TrackState state, Percent)
 {
     QString status;
     switch (state) {
@@ -75,7 +77,27 @@ void ConsoleOut::trackProgress(const Track &track, TrackState state, Percent)
 
     QTextStream(stdout)
             << status << " "
-            << track.resultFilePath() << "\n";
+            << resultFile << "\n";
+}
+
+/************************************************
+ * The failed attempts are also collected, even if
+ * the next attempt was successful.
+ ************************************************/
+void ConsoleOut::trackFailed(const Track &, const Profile &, const QString &resultFile, const QString &message)
+{
+    QString msg(message);
+    msg.replace("<br>", " ");
+    msg.remove(QRegExp("<[^>]*>"));
+    mErrors << TrackError { resultFile, msg.trimmed() };
+}
+
+/************************************************
+ *
+ ************************************************/
+void ConsoleOut::trackStalled(const Track &, const QString &program)
+{
+    mStalls[program]++;
 }
 
 /************************************************
@@ -101,4 +123,62 @@ void ConsoleOut::printStatistic()
         str = QString("Encoding time %1 sec").arg(duration);
 
     QTextStream(stdout) << str << "\n";
+
+    Conv::ConversionCache *cache = Conv::ConversionCache::instance();
+    if (cache->isEnabled()) {
+        Conv::ConversionCache::Statistic stat = cache->statistic();
+        QTextStream(stdout) << QString("Conversion cache: %1 hits, %2 misses").arg(stat.hits).arg(stat.misses) << "\n";
+    }
+
+    printUsage("Programs", Conv::ProcessUsageStatistic::instance()->byProgram());
+    printUsage("Profiles", Conv::ProcessUsageStatistic::instance()->byTag());
+
+    if (!mStalls.isEmpty()) {
+        QStringList programs;
+        int         total = 0;
+        for (auto it = mStalls.constBegin(); it != mStalls.constEnd(); ++it) {
+            programs << QString("%1: %2").arg(it.key()).arg(it.value());
+            total += it.value();
+        }
+        QTextStream(stdout) << QString("Stalled programs: %1 (%2)").arg(total).arg(programs.join(", ")) << "\n";
+    }
+
+    if (!mErrors.isEmpty()) {
+        QTextStream out(stdout);
+        out << QString("Track errors: %1").arg(mErrors.count()) << "\n";
+        for (const TrackError &e : qAsConst(mErrors)) {
+            out << "  " << e.file << ": " << e.message << "\n";
+        }
+    }
+}
+
+/************************************************
+ * The empty tag is the splitting stage, it's
+ * shared by all profiles.
+ ************************************************/
+void ConsoleOut::printUsage(const QString &title, const QMap<QString, Conv::ProcessUsage> &usage)
+{
+    if (usage.isEmpty()) {
+        return;
+    }
+
+    auto sec = [](qint64 usec) { return QString::number(usec / 1000000.0, 'f', 1); };
+
+    QTextStream out(stdout);
+    out << title << ":\n";
+    for (auto it = usage.constBegin(); it != usage.constEnd(); ++it) {
+        const Conv::ProcessUsage &u = it.value();
+        out << QString("  %1: %2 runs, CPU %3s user %4s sys, wall %5s, max RSS %6 MiB, I/O %7/%8 blocks, ctx switches %9/%10")
+                        .arg(it.key().isEmpty() ? "(splitter)" : it.key())
+                        .arg(u.count)
+                        .arg(sec(u.userTime))
+                        .arg(sec(u.systemTime))
+                        .arg(sec(u.wallTime))
+                        .arg(QString::number(u.maxRss / 1024.0, 'f', 1))
+                        .arg(u.inBlocks)
+                        .arg(u.outBlocks)
+                        .arg(u.voluntarySwitches)
+                        .arg(u.involuntarySwitches)
+            << "\n";
+    }
 }
@@ -28,7 +28,10 @@
 
 #include <QObject>
 #include <QDateTime>
+#include <QMap>
 #include "track.h"
+#include "profiles.h"
+#include "converter/processusage.h"
 
 class ConsoleOut : public QObject
 {
@@ -39,13 +42,27 @@ public:
 public slots:
     void converterStarted();
     void converterFinished();
-    void trackProgress(const Track &track, TrackState state, Percent percent);
+    void outputProgress(const Track &track, const Profile &profile, const QString &resultFile, TrackState state, Percent percent);
+    void trackFailed(const Track &track, const Profile &profile, const QString &resultFile, const QString &message);
+    void trackStalled(const Track &track, const QString &program);
 
     void printStatistic();
 
 private:
     QDateTime mStartTime;
     QDateTime mFinishTime;
+
+    struct TrackError
+    {
+        QString file;
+        QString message;
+    };
+    QList<TrackError> mErrors;
+
+    // Program name -> number of stalls
+    QMap<QString, int> mStalls;
+
+    void printUsage(const QString &title, const QMap<QString, Conv::ProcessUsage> &usage);
 };
 
 #endif // CONSOLEOUT_H
@@ -0,0 +1,287 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "cancellationtoken.h"
+#include "extprogram.h"
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QIODevice>
+#include <QMutex>
+#include <QThread>
+#include <QLoggingCategory>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#endif
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "CancellationToken")
+}
+
+using namespace Conv;
+
+class CancellationToken::State
+{
+public:
+    QAtomicInt canceled;
+    QAtomicInt paused;
+
+    // Running attached processes, the value is the PID
+    // or the negative process group ID for ExtProgram.
+    QMutex                          mutex;
+    QHash<const QProcess *, qint64> processes;
+
+    void sendSignal(qint64 pid, int sig) const;
+    void sendSignal(int sig);
+};
+
+/************************************************
+ *
+ ************************************************/
+void CancellationToken::State::sendSignal(qint64 pid, int sig) const
+{
+#ifdef Q_OS_UNIX
+    ::kill(pid_t(pid), sig);
+#else
+    Q_UNUSED(pid)
+    Q_UNUSED(sig)
+#endif
+}
+
+/************************************************
+ *
+ ************************************************/
+void CancellationToken::State::sendSignal(int sig)
+{
+    QMutexLocker locker(&mutex);
+    for (qint64 pid : qAsConst(processes)) {
+        sendSignal(pid, sig);
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+CancellationToken::CancellationToken() :
+    mState(new State())
+{
+}
+
+/************************************************
+ *
+ ************************************************/
+void CancellationToken::cancel()
+{
+    mState->canceled.storeRelease(1);
+}
+
+/************************************************
+ *
+ ************************************************/
+bool CancellationToken::isCanceled() const
+{
+    return mState->canceled.loadAcquire() != 0;
+}
+
+/************************************************
+ *
+ ************************************************/
+void CancellationToken::throwIfCanceled() const
+{
+    if (isCanceled()) {
+        throw CanceledError();
+    }
+}
+
+/************************************************
+ * The flag is set before the processes are
+ * stopped, so the process started at the same
+ * time is stopped by its started handler.
+ ************************************************/
+void CancellationToken::pause()
+{
+    if (!mState->paused.testAndSetOrdered(0, 1)) {
+        return;
+    }
+
+#ifdef Q_OS_UNIX
+    mState->sendSignal(SIGSTOP);
+#endif
+}
+
+/************************************************
+ *
+ ************************************************/
+void CancellationToken::resume()
+{
+    if (!mState->paused.testAndSetOrdered(1, 0)) {
+        return;
+    }
+
+#ifdef Q_OS_UNIX
+    mState->sendSignal(SIGCONT);
+#endif
+}
+
+/************************************************
+ *
+ ************************************************/
+bool CancellationToken::isPaused() const
+{
+    return mState->paused.loadAcquire() != 0;
+}
+
+/************************************************
+ *
+ ************************************************/
+void CancellationToken::waitIfPaused() const
+{
+    while (isPaused() && !isCanceled()) {
+        QThread::msleep(POLL_INTERVAL);
+    }
+    throwIfCanceled();
+}
+
+/************************************************
+ * The handlers are called in the thread of the
+ * process, the pause() from the main thread.
+ ************************************************/
+void CancellationToken::attach(QProcess *process) const
+{
+    QSharedPointer<State> state = mState;
+
+    QObject::connect(process, &QProcess::started, process, [state, process]() {
+        qint64 pid = process->processId();
+        if (dynamic_cast<ExtProgram *>(process)) {
+            pid = -pid;
+        }
+
+        QMutexLocker locker(&state->mutex);
+        state->processes.insert(process, pid);
+
+#ifdef Q_OS_UNIX
+        if (state->paused.loadAcquire()) {
+            state->sendSignal(pid, SIGSTOP);
+        }
+#endif
+    });
+
+    QObject::connect(process, &QProcess::stateChanged, process, [state, process](QProcess::ProcessState newState) {
+        if (newState == QProcess::NotRunning) {
+            QMutexLocker locker(&state->mutex);
+            state->processes.remove(process);
+        }
+    });
+
+    QObject::connect(process, &QObject::destroyed, [state, process]() {
+        QMutexLocker locker(&state->mutex);
+        state->processes.remove(process);
+    });
+}
+
+/************************************************
+ * The time in the pause is not counted.
+ ************************************************/
+bool CancellationToken::waitForReadyRead(QIODevice *device, int msecs) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (true) {
+        if (isPaused()) {
+            waitIfPaused();
+            timer.restart();
+        }
+        throwIfCanceled();
+
+        int left = msecs - int(timer.elapsed());
+        if (left <= 0) {
+            return false;
+        }
+
+        if (device->waitForReadyRead(qMin(left, POLL_INTERVAL))) {
+            return true;
+        }
+    }
+}
+
+/************************************************
+ * The time in the pause is not counted.
+ ************************************************/
+bool CancellationToken::waitForBytesWritten(QIODevice *device, int msecs) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (true) {
+        if (isPaused()) {
+            waitIfPaused();
+            timer.restart();
+        }
+        throwIfCanceled();
+
+        int left = msecs - int(timer.elapsed());
+        if (left <= 0) {
+            return false;
+        }
+
+        if (device->waitForBytesWritten(qMin(left, POLL_INTERVAL))) {
+            return true;
+        }
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+bool CancellationToken::waitForFinished(QProcess *process, int msecs) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (process->state() != QProcess::NotRunning) {
+        if (isCanceled()) {
+            qCDebug(LOG) << "Kill" << process->program();
+            ExtProgram::killGroup(process);
+            process->waitForFinished(POLL_INTERVAL);
+            throw CanceledError();
+        }
+
+        int wait = POLL_INTERVAL;
+        if (msecs >= 0) {
+            int left = msecs - int(timer.elapsed());
+            if (left <= 0) {
+                return false;
+            }
+            wait = qMin(left, POLL_INTERVAL);
+        }
+
+        process->waitForFinished(wait);
+    }
+
+    return true;
+}
@@ -0,0 +1,94 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QSharedPointer>
+#include "types.h"
+
+class QIODevice;
+class QProcess;
+
+namespace Conv {
+
+class CanceledError : public FlaconError
+{
+public:
+    CanceledError() :
+        FlaconError("Canceled") { }
+};
+
+/************************************************
+ * The copies share the state, so the pipeline
+ * cancels all its workers at once. The workers
+ * check the token in their read/write loops and
+ * never block longer than POLL_INTERVAL.
+ *
+ * The paused token parks the loops, and the
+ * attached processes get SIGSTOP/SIGCONT.
+ ************************************************/
+class CancellationToken
+{
+public:
+    static constexpr int POLL_INTERVAL = 20; // msec
+
+    CancellationToken();
+    CancellationToken(const CancellationToken &other) = default;
+    CancellationToken &operator=(const CancellationToken &other) = default;
+
+    void cancel();
+    bool isCanceled() const;
+    void throwIfCanceled() const noexcept(false);
+
+    void pause();
+    void resume();
+    bool isPaused() const;
+
+    // Blocks while the token is paused, throws CanceledError if canceled.
+    void waitIfPaused() const noexcept(false);
+
+    // The process is stopped and continued with the token.
+    // Should be called before QProcess::start().
+    void attach(QProcess *process) const;
+
+    // Like QIODevice::waitForReadyRead, returns false on the timeout.
+    bool waitForReadyRead(QIODevice *device, int msecs) const noexcept(false);
+
+    // Like QIODevice::waitForBytesWritten, returns false on the timeout.
+    bool waitForBytesWritten(QIODevice *device, int msecs) const noexcept(false);
+
+    // Returns false on the timeout, -1 means no timeout.
+    // If canceled, the process group is killed.
+    bool waitForFinished(QProcess *process, int msecs = -1) const noexcept(false);
+
+private:
+    class State;
+    QSharedPointer<State> mState;
+};
+
+} // namespace
+
+#endif // CANCELLATIONTOKEN_H
@@ -0,0 +1,321 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "conversioncache.h"
+#include "settings.h"
+#include "profiles.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "ConversionCache")
+}
+
+using namespace Conv;
+
+static constexpr auto GAIN_SUFFIX   = ".gain";
+static constexpr auto REPLAY_GAIN   = "ReplayGain";
+static constexpr int  HASH_BUF_SIZE = 1024 * 1024;
+
+/************************************************
+ *
+ ************************************************/
+ConversionCache *ConversionCache::instance()
+{
+    static ConversionCache *res = new ConversionCache();
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+bool ConversionCache::isEnabled() const
+{
+    return Settings::i()->value(Settings::ConvCache_Enabled).toBool();
+}
+
+/************************************************
+ *
+ ************************************************/
+QString ConversionCache::dir() const
+{
+    return Settings::i()->value(Settings::ConvCache_Dir).toString();
+}
+
+/************************************************
+ *
+ ************************************************/
+qint64 ConversionCache::maxSize() const
+{
+    return Settings::i()->value(Settings::ConvCache_MaxSize).toLongLong() * 1024 * 1024;
+}
+
+/************************************************
+ * The input files are shared between the outputs,
+ * so we hash each file only once.
+ ************************************************/
+QByteArray ConversionCache::inputHash(const QString &inputFile)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        auto         it = mInputHashes.constFind(inputFile);
+        if (it != mInputHashes.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QFile file(inputFile);
+    if (!file.open(QFile::ReadOnly)) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    while (!file.atEnd()) {
+        hash.addData(file.read(HASH_BUF_SIZE));
+    }
+
+    QByteArray res = hash.result();
+
+    QMutexLocker locker(&mMutex);
+    mInputHashes.insert(inputFile, res);
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+QByteArray ConversionCache::key(const QString &inputFile, const Profile &profile, const QString &programPath, const QByteArray &extra)
+{
+    QByteArray input = inputHash(inputFile);
+    if (input.isEmpty()) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(input);
+    hash.addData(profile.formatId().toUtf8());
+
+    // The gain is stored separately, it doesn't change the audio.
+    QStringList keys = profile.outFormat()->defaultParameters().keys();
+    keys.removeAll(REPLAY_GAIN);
+    keys.sort();
+    for (const QString &key : qAsConst(keys)) {
+        hash.addData(key.toUtf8());
+        hash.addData("=");
+        hash.addData(profile.value(key).toString().toUtf8());
+        hash.addData("\n");
+    }
+
+    // We don't run the program to get the version, the new
+    // version of the program is a new file.
+    QFileInfo program(programPath);
+    hash.addData(program.canonicalFilePath().toUtf8());
+    hash.addData(QByteArray::number(program.size()));
+    hash.addData(QByteArray::number(program.lastModified().toMSecsSinceEpoch()));
+
+    hash.addData(extra);
+    return hash.result().toHex();
+}
+
+/************************************************
+ *
+ ************************************************/
+QString ConversionCache::entryPath(const QByteArray &key) const
+{
+    return QString("%1/%2/%3").arg(dir(), QString::fromLatin1(key.left(2)), QString::fromLatin1(key));
+}
+
+/************************************************
+ *
+ ************************************************/
+bool ConversionCache::get(const QByteArray &key, const QString &outFile, bool needGain, ReplayGain::Result *gain)
+{
+    if (key.isEmpty()) {
+        mMisses.ref();
+        return false;
+    }
+
+    QString path = entryPath(key);
+
+    if (!QFileInfo::exists(path) || (needGain && !QFileInfo::exists(path + GAIN_SUFFIX))) {
+        qCDebug(LOG) << "Miss" << key;
+        mMisses.ref();
+        return false;
+    }
+
+    if (needGain) {
+        QFile file(path + GAIN_SUFFIX);
+        if (!file.open(QFile::ReadOnly)) {
+            mMisses.ref();
+            return false;
+        }
+
+        QDataStream stream(&file);
+        stream >> *gain;
+        if (stream.status() != QDataStream::Ok) {
+            qCWarning(LOG) << "Broken gain file" << file.fileName();
+            mMisses.ref();
+            return false;
+        }
+    }
+
+    QFile::remove(outFile);
+    if (!QFile::copy(path, outFile)) {
+        qCWarning(LOG) << "Can't copy" << path << "to" << outFile;
+        mMisses.ref();
+        return false;
+    }
+
+    // The modification time is the last access time for the LRU
+    QFile entry(path);
+    if (entry.open(QFile::ReadWrite)) {
+        entry.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    qCDebug(LOG) << "Hit" << key << outFile;
+    mHits.ref();
+    return true;
+}
+
+/************************************************
+ *
+ ************************************************/
+void ConversionCache::put(const QByteArray &key, const QString &encodedFile, const ReplayGain::Result *gain)
+{
+    if (key.isEmpty()) {
+        return;
+    }
+
+    QString path = entryPath(key);
+    if (!QDir().mkpath(QFileInfo(path).path())) {
+        qCWarning(LOG) << "Can't create cache directory" << QFileInfo(path).path();
+        return;
+    }
+
+    // Other threads can read the entry, so we write it under the temporary name.
+    QString tmp = QString("%1.%2.tmp").arg(path).arg(quintptr(QThread::currentThreadId()));
+    QFile::remove(tmp);
+    if (!QFile::copy(encodedFile, tmp)) {
+        qCWarning(LOG) << "Can't copy" << encodedFile << "to" << tmp;
+        return;
+    }
+
+    QFile::remove(path);
+    if (!QFile::rename(tmp, path)) {
+        QFile::remove(tmp);
+        return;
+    }
+
+    if (gain) {
+        QFile file(path + GAIN_SUFFIX);
+        if (file.open(QFile::WriteOnly | QFile::Truncate)) {
+            QDataStream stream(&file);
+            stream << *gain;
+        }
+    }
+
+    qCDebug(LOG) << "Put" << key << encodedFile;
+}
+
+/************************************************
+ *
+ ************************************************/
+void ConversionCache::evict()
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mInputHashes.clear();
+    }
+
+    if (!isEnabled() || !QFileInfo::exists(dir())) {
+        return;
+    }
+
+    QFileInfoList entries;
+    qint64        total = 0;
+
+    QDirIterator it(dir(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo &fi = it.fileInfo();
+        total += fi.size();
+        if (!fi.fileName().endsWith(GAIN_SUFFIX)) {
+            entries << fi;
+        }
+    }
+
+    if (total <= maxSize()) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const QFileInfo &a, const QFileInfo &b) {
+        return a.lastModified() < b.lastModified();
+    });
+
+    for (const QFileInfo &fi : qAsConst(entries)) {
+        if (total <= maxSize()) {
+            break;
+        }
+
+        QFileInfo gain(fi.filePath() + GAIN_SUFFIX);
+        total -= fi.size();
+        QFile::remove(fi.filePath());
+        if (gain.exists()) {
+            total -= gain.size();
+            QFile::remove(gain.filePath());
+        }
+
+        qCDebug(LOG) << "Evict" << fi.filePath();
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+ConversionCache::Statistic ConversionCache::statistic() const
+{
+    Statistic res;
+    res.hits   = mHits.load();
+    res.misses = mMisses.load();
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+void ConversionCache::resetStatistic()
+{
+    mHits.store(0);
+    mMisses.store(0);
+}
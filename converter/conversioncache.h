@@ -0,0 +1,88 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef CONVERSIONCACHE_H
+#define CONVERSIONCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QAtomicInt>
+#include "replaygain.h"
+
+class Profile;
+
+namespace Conv {
+
+/************************************************
+ * Persistent cache of the encoded audio.
+ * The key is the hash of the input WAV file, the
+ * encoder parameters and the encoder program.
+ * The entry is the encoded file without tags and
+ * optionally the track gain.
+ * All methods are thread safe.
+ ************************************************/
+class ConversionCache
+{
+public:
+    struct Statistic
+    {
+        int hits   = 0;
+        int misses = 0;
+    };
+
+    static ConversionCache *instance();
+
+    bool    isEnabled() const;
+    QString dir() const;
+    qint64  maxSize() const;
+
+    QByteArray key(const QString &inputFile, const Profile &profile, const QString &programPath, const QByteArray &extra = QByteArray());
+
+    bool get(const QByteArray &key, const QString &outFile, bool needGain, ReplayGain::Result *gain);
+    void put(const QByteArray &key, const QString &encodedFile, const ReplayGain::Result *gain);
+
+    // Removes the least recently used entries until the cache fits into maxSize.
+    void evict();
+
+    Statistic statistic() const;
+    void      resetStatistic();
+
+private:
+    ConversionCache() = default;
+
+    QAtomicInt mHits;
+    QAtomicInt mMisses;
+
+    QMutex                     mMutex;
+    QHash<QString, QByteArray> mInputHashes;
+
+    QByteArray inputHash(const QString &inputFile);
+    QString    entryPath(const QByteArray &key) const;
+};
+
+} // namespace
+
+#endif // CONVERSIONCACHE_H
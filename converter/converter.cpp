@@ -35,12 +35,18 @@
 #include "discpipline.h"
 #include "sox.h"
 #include "cuecreator.h"
+#include "conversioncache.h"
+#include "trackmanifest.h"
+#include "journal.h"
+#include "processusage.h"
+#include "covercache.h"
 
 #include <iostream>
 #include <math.h>
 #include <QFileInfo>
 #include <QDir>
 #include <QLoggingCategory>
+#include <QSet>
 
 namespace {
 Q_LOGGING_CATEGORY(LOG, "Converter")
@@ -48,26 +54,70 @@ Q_LOGGING_CATEGORY(LOG, "Converter")
 
 using namespace Conv;
 
+/************************************************
+ * The scaled covers are prepared on the worker threads,
+ * the disc pipelines take them from the cache.
+ ************************************************/
+static void prefetchCovers(const Disc *disc, const Profiles &profiles)
+{
+    for (const Profile &profile : profiles) {
+        for (const CoverOptions &options : { profile.copyCoverOptions(), profile.embedCoverOptions() }) {
+            if (options.mode == CoverMode::Scale) {
+                CoverCache::instance()->prefetch(disc->coverImageFile(), options.size);
+            }
+        }
+    }
+}
+
+/************************************************
+ * The whole image is extracted with all pregaps
+ ************************************************/
+static PreGapType splitterPreGapType(const Profile &profile)
+{
+    if (profile.isWholeImage() || !profile.isCreateCue()) {
+        return PreGapType::Skip;
+    }
+
+    return profile.preGapType();
+}
+
 class Converter::Data
 {
 public:
     int       threadCount = 0;
     Validator validator;
+    bool      incremental   = false;
+    bool      resume        = false;
+    int       upToDateCount = 0;
+    bool      paused        = false;
+
+    // The journal is written only if it is enabled, the batch without
+    // errors and interruptions doesn't need it after the end.
+    bool                                       journalEnabled = false;
+    bool                                       complete       = true;
+    Journal                                    journal;
+    Journal::State                             resumeState;
+    QMap<QPair<const Disc *, int>, TrackState> journalStates;
 
     QVector<DiscPipeline *>        discPiplines;
     QMap<TrackId, const ConvTrack> tracks;
+    QSet<const Disc *>             disksWithErrors;
+
+    // The track can be converted by several pipelines, one for each group
+    // of profiles. It is done when all of these pipelines are done.
+    QMap<QPair<const Disc *, int>, int> pendingPipelines;
 
-    QString workDir(const Track *track) const;
+    QString workDir(const Track *track, const Profile &profile) const;
 };
 
 /************************************************
  *
  ************************************************/
-QString Converter::Data::workDir(const Track *track) const
+QString Converter::Data::workDir(const Track *track, const Profile &profile) const
 {
     QString dir = Settings::i()->tmpDir();
     if (dir.isEmpty()) {
-        dir = QFileInfo(track->resultFilePath()).dir().absolutePath();
+        dir = QFileInfo(track->resultFilePath(profile)).dir().absolutePath();
     }
     return dir + "/tmp";
 }
@@ -94,6 +144,26 @@ Converter::~Converter()
 
  ************************************************/
 void Converter::start(const Profile &profile)
+{
+    Profiles profiles;
+    profiles << profile;
+    start(profiles);
+}
+
+/************************************************
+ *
+ ************************************************/
+void Converter::start(const Converter::Jobs &jobs, const Profile &profile)
+{
+    Profiles profiles;
+    profiles << profile;
+    start(jobs, profiles);
+}
+
+/************************************************
+
+ ************************************************/
+void Converter::start(const Profiles &profiles)
 {
     Jobs jobs;
     for (int d = 0; d < project->count(); ++d) {
@@ -106,24 +176,48 @@ void Converter::start(const Profile &profile)
         jobs << job;
     }
 
-    start(jobs, profile);
+    start(jobs, profiles);
 }
 
 /************************************************
  *
  ************************************************/
-void Converter::start(const Converter::Jobs &jobs, const Profile &profile)
+void Converter::start(const Converter::Jobs &allJobs, const Profiles &profiles)
 {
-    qCDebug(LOG) << "Start converter:" << jobs.length() << "\n"
-                 << profile;
+    qCDebug(LOG) << "Start converter:" << allJobs.length();
+    for (const Profile &profile : profiles) {
+        qCDebug(LOG) << profile;
+    }
     qCDebug(LOG) << "Temp dir =" << Settings::i()->tmpDir();
 
-    if (jobs.isEmpty()) {
+    QString journalFile;
+    if (mData->journalEnabled) {
+        QStringList discFiles;
+        for (const Job &job : allJobs) {
+            discFiles << Journal::discFile(job.disc);
+        }
+
+        QStringList profileIds;
+        for (const Profile &profile : profiles) {
+            profileIds << profile.id();
+        }
+
+        journalFile = Journal::batchFileName(discFiles, profileIds);
+    }
+    mData->journal.setFileName(journalFile);
+
+    if (mData->resume) {
+        mData->resumeState = mData->journal.read();
+    }
+
+    const Jobs jobs = (mData->incremental || mData->resume) ? removeUpToDateTracks(allJobs, profiles) : allJobs;
+
+    if (jobs.isEmpty() || profiles.isEmpty()) {
         emit finished();
         return;
     }
 
-    if (!validate(jobs, profile)) {
+    if (!validate(jobs, profiles)) {
         emit finished();
         return;
     }
@@ -136,6 +230,21 @@ void Converter::start(const Converter::Jobs &jobs, const Profile &profile)
 
     qCDebug(LOG) << "Threads count" << mData->threadCount;
 
+    ConversionCache::instance()->resetStatistic();
+    ProcessUsageStatistic::instance()->reset();
+    mData->paused = false;
+
+    // The journal of the same batch is continued
+    mData->complete = true;
+    mData->journal.open();
+    mData->journalStates.clear();
+    for (const Profile &profile : profiles) {
+        mData->journal.writeProfile(profile);
+    }
+    for (const Job &job : jobs) {
+        mData->journal.writeDisc(job.disc);
+    }
+
     try {
         for (const Job &converterJob : jobs) {
 
@@ -143,11 +252,22 @@ void Converter::start(const Converter::Jobs &jobs, const Profile &profile)
                 continue;
             }
 
-            if (mData->validator.diskHasErrors(converterJob.disc)) {
+            if (mData->disksWithErrors.contains(converterJob.disc)) {
                 continue;
             }
 
-            mData->discPiplines << createDiscPipeline(profile, converterJob);
+            // The splitter output depends on the pregap type and the whole image mode,
+            // so the profiles with the different values are converted by separate pipelines.
+            QMap<QPair<PreGapType, bool>, Profiles> groups;
+            for (const Profile &profile : profiles) {
+                groups[qMakePair(splitterPreGapType(profile), profile.isWholeImage())] << profile;
+            }
+
+            for (const Profiles &group : qAsConst(groups)) {
+                mData->discPiplines << createDiscPipeline(group, converterJob);
+            }
+
+            prefetchCovers(converterJob.disc, profiles);
         }
     }
     catch (const FlaconError &err) {
@@ -165,12 +285,13 @@ void Converter::start(const Converter::Jobs &jobs, const Profile &profile)
 /************************************************
  *
  ************************************************/
-DiscPipeline *Converter::createDiscPipeline(const Profile &profile, const Converter::Job &converterJob)
+DiscPipeline *Converter::createDiscPipeline(const Profiles &profiles, const Converter::Job &converterJob)
 {
     // Tracks ..............................
     ConvTracks resTracks;
 
-    PreGapType preGapType = profile.isCreateCue() ? profile.preGapType() : PreGapType::Skip;
+    const Profile &profile    = profiles.first();
+    PreGapType     preGapType = splitterPreGapType(profile);
 
     for (const TrackPtrList &tracks : converterJob.disc->tracksByFileTag()) {
 
@@ -207,13 +328,57 @@ DiscPipeline *Converter::createDiscPipeline(const Profile &profile, const Conver
         }
     }
 
-    QString wrkDir = mData->workDir(converterJob.tracks.first());
+    for (const ConvTrack &track : qAsConst(resTracks)) {
+        mData->pendingPipelines[qMakePair<const Disc *, int>(converterJob.disc, track.isPregap() ? -1 : track.index())]++;
+    }
 
-    DiscPipeline *pipeline = new DiscPipeline(profile, converterJob.disc, resTracks, wrkDir, this);
+    QString wrkDir = mData->workDir(converterJob.tracks.first(), profile);
+
+    DiscPipeline *pipeline = new DiscPipeline(profiles, converterJob.disc, resTracks, wrkDir, this);
 
     connect(pipeline, &DiscPipeline::readyStart, this, &Converter::startThread);
     connect(pipeline, &DiscPipeline::threadFinished, this, &Converter::startThread);
-    connect(pipeline, &DiscPipeline::trackProgressChanged, this, &Converter::trackProgress);
+    connect(pipeline, &DiscPipeline::trackFailed, this, [this](const ConvTrack &track, const Profile &profile, const QString &resultFile, const QString &message) {
+        mData->complete = false;
+        emit trackFailed(track, profile, resultFile, message);
+    });
+
+    connect(pipeline, &DiscPipeline::outputProgressChanged, this, [this](const ConvTrack &track, const Profile &profile, const QString &resultFile, TrackState state, Percent percent) {
+        emit outputProgress(track, profile, resultFile, state, percent);
+    });
+
+    connect(pipeline, &DiscPipeline::trackStalled, this, [this](const ConvTrack &track, const QString &program) {
+        emit trackStalled(track, program);
+    });
+
+    connect(pipeline, &DiscPipeline::trackProgressChanged, this, [this, converterJob, profiles](const ConvTrack &track, TrackState state, Percent percent) {
+        if (state == TrackState::OK && !track.isPregap()) {
+            QStringList files;
+            for (const Profile &p : profiles) {
+                if (!p.isWholeImage()) {
+                    files << track.resultFilePath(p);
+                    if (mData->incremental) {
+                        TrackManifest(track, p).save();
+                    }
+                }
+            }
+            mData->journal.writeTrackState(track, state, files);
+        }
+
+        auto key = qMakePair<const Disc *, int>(converterJob.disc, track.isPregap() ? -1 : track.index());
+        if (state != TrackState::OK && !track.isPregap() && mData->journalStates.value(key) != state) {
+            mData->journalStates[key] = state;
+            mData->journal.writeTrackState(track, state);
+        }
+
+        if (state == TrackState::OK) {
+            int &pending = mData->pendingPipelines[key];
+            if (--pending > 0) {
+                return;
+            }
+        }
+        emit trackProgress(track, state, percent);
+    });
 
     return pipeline;
 }
@@ -231,6 +396,140 @@ bool Converter::isRunning()
     return false;
 }
 
+/************************************************
+ *
+ ************************************************/
+bool Converter::isIncremental() const
+{
+    return mData->incremental;
+}
+
+/************************************************
+ *
+ ************************************************/
+void Converter::setIncremental(bool value)
+{
+    mData->incremental = value;
+}
+
+/************************************************
+ *
+ ************************************************/
+bool Converter::isResume() const
+{
+    return mData->resume;
+}
+
+/************************************************
+ *
+ ************************************************/
+void Converter::setResume(bool value)
+{
+    mData->resume = value;
+}
+
+/************************************************
+ *
+ ************************************************/
+bool Converter::isJournalEnabled() const
+{
+    return mData->journalEnabled;
+}
+
+/************************************************
+ *
+ ************************************************/
+void Converter::setJournalEnabled(bool value)
+{
+    mData->journalEnabled = value;
+}
+
+/************************************************
+ *
+ ************************************************/
+int Converter::upToDateCount() const
+{
+    return mData->upToDateCount;
+}
+
+/************************************************
+ * The whole image is always converted.
+ ************************************************/
+bool Converter::isTrackDone(const Track &track, const Profile &profile) const
+{
+    if (profile.isWholeImage()) {
+        return false;
+    }
+
+    if (mData->resume && mData->resumeState.isDone(track.resultFilePath(profile))) {
+        return true;
+    }
+
+    return mData->incremental && TrackManifest(track, profile).isUpToDate();
+}
+
+/************************************************
+ * The track is converted again if any of the
+ * profiles has no up to date output.
+ * The album gain is calculated from all tracks,
+ * so the disc with any changed track is converted
+ * completely.
+ ************************************************/
+Converter::Jobs Converter::removeUpToDateTracks(const Jobs &jobs, const Profiles &profiles)
+{
+    Jobs res;
+    int  skipped = 0;
+
+    bool albumGain = false;
+    for (const Profile &profile : profiles) {
+        albumGain = albumGain || profile.gainType() == GainType::Album;
+    }
+
+    for (const Job &job : jobs) {
+        Job                    resJob;
+        QVector<const Track *> upToDate;
+        resJob.disc = job.disc;
+
+        for (const Track *track : job.tracks) {
+            bool done = true;
+            for (const Profile &profile : profiles) {
+                if (!isTrackDone(*track, profile)) {
+                    done = false;
+                    break;
+                }
+            }
+
+            if (done) {
+                upToDate << track;
+            }
+            else {
+                resJob.tracks << track;
+            }
+        }
+
+        if (albumGain && !resJob.tracks.isEmpty()) {
+            res << job;
+            continue;
+        }
+
+        for (const Track *track : qAsConst(upToDate)) {
+            ++skipped;
+            for (const Profile &profile : profiles) {
+                emit outputProgress(*track, profile, track->resultFilePath(profile), TrackState::OK, 0);
+            }
+            emit trackProgress(*track, TrackState::OK, 0);
+        }
+
+        if (!resJob.tracks.isEmpty()) {
+            res << resJob;
+        }
+    }
+
+    qCDebug(LOG) << "Up to date tracks:" << skipped;
+    mData->upToDateCount = skipped;
+    return res;
+}
+
 /************************************************
 
  ************************************************/
@@ -239,11 +538,55 @@ void Converter::stop()
     if (!isRunning())
         return;
 
+    mData->paused   = false;
+    mData->complete = false;
     foreach (DiscPipeline *pipe, mData->discPiplines) {
         pipe->stop();
     }
 }
 
+/************************************************
+
+ ************************************************/
+bool Converter::isPaused() const
+{
+    return mData->paused;
+}
+
+/************************************************
+
+ ************************************************/
+void Converter::pause()
+{
+    if (!isRunning() || mData->paused) {
+        return;
+    }
+
+    qCDebug(LOG) << "Pause";
+    mData->paused = true;
+    foreach (DiscPipeline *pipe, mData->discPiplines) {
+        pipe->pause();
+    }
+}
+
+/************************************************
+
+ ************************************************/
+void Converter::resume()
+{
+    if (!mData->paused) {
+        return;
+    }
+
+    qCDebug(LOG) << "Resume";
+    mData->paused = false;
+    foreach (DiscPipeline *pipe, mData->discPiplines) {
+        pipe->resume();
+    }
+
+    startThread();
+}
+
 /************************************************
 
  ************************************************/
@@ -269,13 +612,22 @@ void Converter::startThread()
         }
     }
 
+    if (mData->complete) {
+        mData->journal.remove();
+    }
+    else {
+        mData->journal.writeFinished();
+        mData->journal.close();
+    }
+    ConversionCache::instance()->evict();
+    CoverCache::instance()->evict();
     emit finished();
 }
 
 /************************************************
 
  ************************************************/
-bool Converter::validate(const Jobs &jobs, const Profile &profile) const
+bool Converter::validate(const Jobs &jobs, const Profiles &profiles) const
 {
     DiskList disks;
     for (const auto &j : jobs) {
@@ -284,9 +636,28 @@ bool Converter::validate(const Jobs &jobs, const Profile &profile) const
     }
 
     mData->validator.setDisks(disks);
-    mData->validator.setProfile(profile);
+    mData->disksWithErrors.clear();
+
+    QStringList errors;
+    for (const Profile &profile : profiles) {
+        mData->validator.setProfile(profile);
+        if (profiles.count() > 1) {
+            mData->validator.revalidate();
+        }
+
+        for (const QString &e : mData->validator.converterErrors()) {
+            QString err = profiles.count() > 1 ? QString("%1: %2").arg(profile.name(), e) : e;
+            if (!errors.contains(err)) {
+                errors << err;
+            }
+        }
 
-    QStringList errors = mData->validator.converterErrors();
+        for (const Disc *disk : disks) {
+            if (mData->validator.diskHasErrors(disk)) {
+                mData->disksWithErrors << disk;
+            }
+        }
+    }
 
     if (errors.isEmpty()) {
         return true;
@@ -34,6 +34,7 @@
 class Disc;
 class Track;
 class Profile;
+class Profiles;
 
 namespace Conv {
 
@@ -55,17 +56,48 @@ public:
 
     bool isRunning();
 
+    // In incremental mode the tracks with up to date output files are not converted.
+    bool isIncremental() const;
+    void setIncremental(bool value);
+
+    // Skip the tracks that were converted by the previous run, see Journal.
+    bool isResume() const;
+    void setResume(bool value);
+
+    // Write the journal of the batch, so the interrupted conversion can be resumed.
+    bool isJournalEnabled() const;
+    void setJournalEnabled(bool value);
+
+    int upToDateCount() const;
+
+    bool isPaused() const;
+
 signals:
     void started();
     void finished();
     void trackProgress(const Track &track, TrackState state, Percent percent);
+
+    // With several profiles every track has several output files,
+    // these signals are emitted for each of them.
+    void outputProgress(const Track &track, const Profile &profile, const QString &resultFile, TrackState state, Percent percent);
+    void trackFailed(const Track &track, const Profile &profile, const QString &resultFile, const QString &message);
+
+    // The program was killed by the watchdog, the track is retried.
+    void trackStalled(const Track &track, const QString &program);
     void error(const QString err);
 
 public slots:
     void start(const Profile &profile);
     void start(const Jobs &jobs, const Profile &profile);
+    void start(const Profiles &profiles);
+    void start(const Jobs &jobs, const Profiles &profiles);
     void stop();
 
+    // Stops dispatching new tracks and suspends the running
+    // decoders and encoders, the progress is not lost.
+    void pause();
+    void resume();
+
 private slots:
     void startThread();
 
@@ -73,8 +105,10 @@ private:
     class Data;
     Data *mData = nullptr;
 
-    bool          validate(const Jobs &jobs, const Profile &profile) const;
-    DiscPipeline *createDiscPipeline(const Profile &profile, const Job &converterJob);
+    bool          validate(const Jobs &jobs, const Profiles &profiles) const;
+    Jobs          removeUpToDateTracks(const Jobs &jobs, const Profiles &profiles);
+    bool          isTrackDone(const Track &track, const Profile &profile) const;
+    DiscPipeline *createDiscPipeline(const Profiles &profiles, const Job &converterJob);
 };
 
 }
@@ -0,0 +1,324 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "covercache.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QLoggingCategory>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "CoverCache")
+}
+
+// The default quality of the image writer
+static constexpr int QUALITY = -1;
+
+/************************************************
+ *
+ ************************************************/
+class CoverCache::Task : public QRunnable
+{
+public:
+    Task(CoverCache *cache, const QString &filePath, uint size) :
+        mCache(cache),
+        mFilePath(filePath),
+        mSize(size)
+    {
+    }
+
+    void run() override;
+
+private:
+    CoverCache *mCache;
+    QString     mFilePath;
+    uint        mSize;
+};
+
+/************************************************
+ * The errors are not reported here, CoverImage
+ * reports them when the image is really needed.
+ ************************************************/
+void CoverCache::Task::run()
+{
+    QImageReader reader(mFilePath);
+    QByteArray   format = reader.format();
+    QSize        size   = reader.size();
+
+    if (size.isValid() && size.width() <= int(mSize) && size.height() <= int(mSize)) {
+        return;
+    }
+
+    QFile file(mFilePath);
+    if (!file.open(QFile::ReadOnly)) {
+        return;
+    }
+
+    try {
+        mCache->scaled(file.readAll(), format, mSize);
+    }
+    catch (const QString &err) {
+        qCDebug(LOG) << "Can't prefetch" << mFilePath << err;
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+CoverCache *CoverCache::instance()
+{
+    static CoverCache *res = new CoverCache(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/covers");
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+CoverCache::CoverCache(const QString &dir) :
+    mDir(dir)
+{
+}
+
+/************************************************
+ *
+ ************************************************/
+CoverCache::~CoverCache()
+{
+    mPool.waitForDone();
+}
+
+/************************************************
+ *
+ ************************************************/
+QByteArray CoverCache::key(const QByteArray &srcData, const QByteArray &format, uint size) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QCryptographicHash::hash(srcData, QCryptographicHash::Sha1));
+    hash.addData(format.toLower());
+    hash.addData(QByteArray::number(size));
+    hash.addData(QByteArray::number(QUALITY));
+    return hash.result().toHex();
+}
+
+/************************************************
+ *
+ ************************************************/
+QString CoverCache::entryPath(const QByteArray &key, const QByteArray &format) const
+{
+    return QString("%1/%2/%3.%4").arg(mDir, QString::fromLatin1(key.left(2)), QString::fromLatin1(key), QString::fromLatin1(format.toLower()));
+}
+
+/************************************************
+ * The modification time is the last access time
+ * for the LRU.
+ ************************************************/
+QByteArray CoverCache::get(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadWrite)) {
+        return QByteArray();
+    }
+
+    QByteArray res = file.readAll();
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+void CoverCache::put(const QString &path, const QByteArray &data) const
+{
+    if (!QDir().mkpath(QFileInfo(path).path())) {
+        qCWarning(LOG) << "Can't create cache directory" << QFileInfo(path).path();
+        return;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QFile::WriteOnly)) {
+        qCWarning(LOG) << "Can't write" << path << file.errorString();
+        return;
+    }
+
+    file.write(data);
+    if (!file.commit()) {
+        qCWarning(LOG) << "Can't write" << path << file.errorString();
+    }
+}
+
+/************************************************
+ * The smooth scaling returns the 32-bit image for
+ * most formats, it is converted back so the writer
+ * keeps the depth of the source (grayscale, RGB888,
+ * 16-bit). The indexed images stay 32-bit, the
+ * conversion back would lose the colors.
+ ************************************************/
+QByteArray CoverCache::scale(const QByteArray &srcData, const QByteArray &format, uint size)
+{
+    QBuffer in;
+    in.setData(srcData);
+    in.open(QIODevice::ReadOnly);
+
+    QImageReader reader(&in, format);
+    QImage       image = reader.read();
+    if (image.isNull()) {
+        qCWarning(LOG) << "Can't read cover image:" << reader.errorString();
+        throw reader.errorString();
+    }
+
+    const QImage::Format srcFormat = image.format();
+    const bool           indexed   = image.colorCount() > 0;
+
+    image = image.scaled(QSize(size, size), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    if (image.format() != srcFormat && !indexed) {
+        image = image.convertToFormat(srcFormat);
+    }
+
+    QByteArray res;
+    QBuffer    out(&res);
+    out.open(QIODevice::WriteOnly);
+    QImageWriter writer(&out, format);
+    writer.setQuality(QUALITY);
+    if (!writer.write(image)) {
+        qCWarning(LOG) << "Can't write cover image to memory:" << writer.errorString();
+        throw writer.errorString();
+    }
+
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+QByteArray CoverCache::scaled(const QByteArray &srcData, const QByteArray &format, uint size)
+{
+    const QByteArray k    = key(srcData, format, size);
+    const QString    path = entryPath(k, format);
+
+    {
+        QMutexLocker locker(&mMutex);
+        while (mInProgress.contains(k)) {
+            mTaskDone.wait(&mMutex);
+        }
+
+        QByteArray res = get(path);
+        if (!res.isEmpty()) {
+            qCDebug(LOG) << "Hit" << path;
+            return res;
+        }
+
+        mInProgress.insert(k);
+    }
+
+    qCDebug(LOG) << "Miss" << path;
+    QByteArray res;
+    try {
+        res = scale(srcData, format, size);
+        put(path, res);
+    }
+    catch (...) {
+        QMutexLocker locker(&mMutex);
+        mInProgress.remove(k);
+        mTaskDone.wakeAll();
+        throw;
+    }
+
+    QMutexLocker locker(&mMutex);
+    mInProgress.remove(k);
+    mTaskDone.wakeAll();
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+void CoverCache::prefetch(const QString &filePath, uint size)
+{
+    if (filePath.isEmpty() || size == 0) {
+        return;
+    }
+
+    mPool.start(new Task(this, filePath, size));
+}
+
+/************************************************
+ *
+ ************************************************/
+void CoverCache::waitForDone()
+{
+    mPool.waitForDone();
+}
+
+/************************************************
+ *
+ ************************************************/
+void CoverCache::evict()
+{
+    QMutexLocker locker(&mMutex);
+
+    if (!QFileInfo::exists(mDir)) {
+        return;
+    }
+
+    QFileInfoList entries;
+    qint64        total = 0;
+
+    QDirIterator it(mDir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        entries << it.fileInfo();
+        total += it.fileInfo().size();
+    }
+
+    if (total <= mMaxSize) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const QFileInfo &a, const QFileInfo &b) {
+        return a.lastModified() < b.lastModified();
+    });
+
+    for (const QFileInfo &fi : qAsConst(entries)) {
+        if (total <= mMaxSize) {
+            break;
+        }
+
+        total -= fi.size();
+        QFile::remove(fi.filePath());
+        qCDebug(LOG) << "Evict" << fi.filePath();
+    }
+}
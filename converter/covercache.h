@@ -0,0 +1,88 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef COVERCACHE_H
+#define COVERCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QSet>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+
+/************************************************
+ * Persistent cache of the scaled cover images.
+ * The key is the hash of the source image, the
+ * target size, the format and the quality.
+ * prefetch() scales the image on a worker thread,
+ * scaled() waits for the running task instead of
+ * doing the same work twice.
+ * All methods are thread safe.
+ ************************************************/
+class CoverCache
+{
+public:
+    static constexpr qint64 DEFAULT_MAX_SIZE = 64 * 1024 * 1024;
+
+    static CoverCache *instance();
+
+    explicit CoverCache(const QString &dir);
+    ~CoverCache();
+
+    QString dir() const { return mDir; }
+
+    qint64 maxSize() const { return mMaxSize; }
+    void   setMaxSize(qint64 value) { mMaxSize = value; }
+
+    // Returns the image scaled to fit into size x size and encoded
+    // in the format. Throws the error string if the image is broken.
+    QByteArray scaled(const QByteArray &srcData, const QByteArray &format, uint size) noexcept(false);
+
+    void prefetch(const QString &filePath, uint size);
+    void waitForDone();
+
+    // Removes the least recently used entries until the cache fits into maxSize.
+    void evict();
+
+private:
+    class Task;
+
+    const QString    mDir;
+    qint64           mMaxSize = DEFAULT_MAX_SIZE;
+    QThreadPool      mPool;
+    QMutex           mMutex;
+    QWaitCondition   mTaskDone;
+    QSet<QByteArray> mInProgress;
+
+    QByteArray key(const QByteArray &srcData, const QByteArray &format, uint size) const;
+    QString    entryPath(const QByteArray &key, const QByteArray &format) const;
+
+    QByteArray        get(const QString &path) const;
+    void              put(const QString &path, const QByteArray &data) const;
+    static QByteArray scale(const QByteArray &srcData, const QByteArray &format, uint size) noexcept(false);
+};
+
+#endif // COVERCACHE_H
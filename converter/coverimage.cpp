@@ -27,9 +27,15 @@
 #include <QObject>
 #include <QFileInfo>
 #include <QImageReader>
-#include <QImageWriter>
 #include <QBuffer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QWaitCondition>
+#include <QDateTime>
 #include "types.h"
+#include "covercache.h"
 #include <QDebug>
 
 #include <QLoggingCategory>
@@ -83,7 +89,7 @@ static CoverImage::Format formatStrToFormat(const QByteArray &format)
 QString CoverImage::fileExt() const
 {
     // clang-format off
-    switch (mFormat) {
+    switch (mData->format) {
         case Format::Unknown:   return "";
         case Format::BMP:       return "bmp";
         case Format::GIF:       return "gif";
@@ -101,50 +107,153 @@ QString CoverImage::fileExt() const
     return "";
 }
 
-CoverImage::CoverImage(const QString &inFilePath, uint size)
+/************************************************
+ * Some handlers don't provide the size or depth
+ * without decoding the image.
+ ************************************************/
+static void readImageInfo(QImageReader *reader, QSize *size, int *depth)
 {
+    *size  = reader->size();
+    *depth = 0;
+    if (reader->imageFormat() != QImage::Format_Invalid) {
+        *depth = QImage::toPixelFormat(reader->imageFormat()).bitsPerPixel();
+    }
+
+    if (size->isValid() && *depth > 0) {
+        return;
+    }
+
+    QImage image = reader->read();
+    if (image.isNull()) {
+        qCCritical(LOG) << "Can't read cover image:" << reader->errorString();
+        throw reader->errorString();
+    }
 
+    *size  = image.size();
+    *depth = image.depth();
+}
+
+CoverImage::CoverImage(const QString &inFilePath, uint size)
+{
     try {
         if (inFilePath.isEmpty()) {
             qCCritical(LOG) << "Input file name is empty";
             throw QObject::tr("file name is empty", "error message text");
         }
 
-        QImageReader reader(inFilePath);
-        QByteArray   format = reader.format();
+        mData = load(inFilePath, size);
+    }
+    catch (const QString &err) {
+        throw FlaconError(QObject::tr(
+                                  "I can't read cover image <b>%1</b>:<br>%2",
+                                  "%1 - is a file name, %2 - an error text")
+                                  .arg(inFilePath, err));
+    }
+}
 
-        mFormat   = formatStrToFormat(format);
-        mMimeType = formatToMimeType(format);
+/************************************************
+ * Returns the image for the file, the images already used
+ * by someone are taken from the cache. The lock is held
+ * only for the lookup and insert, the same image is read
+ * once, the other threads wait for it.
+ ************************************************/
+QSharedPointer<const CoverImage::Data> CoverImage::load(const QString &filePath, uint size)
+{
+    static QMutex                                   mutex;
+    static QWaitCondition                           loaded;
+    static QSet<QString>                            inProgress;
+    static QHash<QString, QWeakPointer<const Data>> cache;
+
+    QFileInfo fi(filePath);
+    QString   key = QString("%1:%2:%3:%4").arg(size).arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch()).arg(fi.absoluteFilePath());
 
-        QImage image = reader.read();
-        if (image.isNull()) {
-            qCCritical(LOG) << "Can't read cover file" << inFilePath << ":" << reader.errorString();
-            throw reader.errorString();
+    {
+        QMutexLocker locker(&mutex);
+        while (inProgress.contains(key)) {
+            loaded.wait(&mutex);
         }
 
-        if (size > 0) {
-            if (image.width() > int(size) || image.height() > int(size)) {
-                image.scaled(QSize(size, size), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-            }
+        QSharedPointer<const Data> cached = cache.value(key).toStrongRef();
+        if (cached) {
+            qCDebug(LOG) << "Use the shared image" << filePath << size;
+            return cached;
         }
 
-        mSize  = image.size();
-        mDepth = image.depth();
+        inProgress.insert(key);
+    }
+
+    QSharedPointer<const Data> res;
+    try {
+        res = read(filePath, size);
+    }
+    catch (...) {
+        QMutexLocker locker(&mutex);
+        inProgress.remove(key);
+        loaded.wakeAll();
+        throw;
+    }
+
+    QMutexLocker locker(&mutex);
 
-        QBuffer out(&mData);
-        out.open(QIODevice::WriteOnly);
-        QImageWriter writer(&out, format);
-        if (!writer.write(image)) {
-            qCCritical(LOG) << "Can't write cover file to memory" << inFilePath << ":" << writer.errorString();
-            throw writer.errorString();
+    // Forget the images nobody uses anymore
+    auto it = cache.begin();
+    while (it != cache.end()) {
+        if (it.value().isNull()) {
+            it = cache.erase(it);
+        }
+        else {
+            ++it;
         }
     }
-    catch (const QString &err) {
-        throw FlaconError(QObject::tr(
-                                  "I can't read cover image <b>%1</b>:<br>%2",
-                                  "%1 - is a file name, %2 - an error text")
-                                  .arg(inFilePath, err));
+    cache.insert(key, res);
+
+    inProgress.remove(key);
+    loaded.wakeAll();
+    return res;
+}
+
+/************************************************
+ * If the image is not resized, the original file
+ * bytes are used as is, the scaled variants come
+ * from the CoverCache.
+ ************************************************/
+QSharedPointer<const CoverImage::Data> CoverImage::read(const QString &filePath, uint size)
+{
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly)) {
+        qCCritical(LOG) << "Can't read cover file" << filePath << ":" << file.errorString();
+        throw file.errorString();
+    }
+    const QByteArray src = file.readAll();
+    file.close();
+
+    QImageReader reader(filePath);
+    QByteArray   format = reader.format();
+
+    QSharedPointer<Data> res(new Data());
+    res->format   = formatStrToFormat(format);
+    res->mimeType = formatToMimeType(format);
+    readImageInfo(&reader, &res->size, &res->depth);
+
+    if (size > 0 && (res->size.width() > int(size) || res->size.height() > int(size))) {
+        res->data = CoverCache::instance()->scaled(src, format, size);
+
+        QBuffer buf(&res->data);
+        buf.open(QIODevice::ReadOnly);
+        QImageReader scaled(&buf, format);
+        readImageInfo(&scaled, &res->size, &res->depth);
     }
+    else {
+        res->data = src;
+    }
+
+    return res;
+}
+
+QSharedPointer<const CoverImage::Data> CoverImage::emptyData()
+{
+    static QSharedPointer<const Data> res(new Data());
+    return res;
 }
 
 void CoverImage::saveTmpFile(const QString &filePath)
@@ -162,6 +271,6 @@ void CoverImage::saveAs(const QString &filePath) const
                                       "%1 - is file name, %2 - an error text")
                                   .arg(filePath, f.errorString()));
     }
-    f.write(mData);
+    f.write(mData->data);
     f.close();
 }
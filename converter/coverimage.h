@@ -28,6 +28,8 @@
 
 #include <QString>
 #include <QSize>
+#include <QByteArray>
+#include <QSharedPointer>
 
 class CoverImage
 {
@@ -38,19 +40,19 @@ public:
 
     explicit CoverImage(const QString &origFilePath, uint size = 0);
 
-    QString mimeType() const { return mMimeType; }
+    QString mimeType() const { return mData->mimeType; }
     QString fileExt() const;
-    QSize   size() const { return mSize; }
-    int     depth() const { return mDepth; }
+    QSize   size() const { return mData->size; }
+    int     depth() const { return mData->depth; }
 
-    const QByteArray &data() const { return mData; }
+    const QByteArray &data() const { return mData->data; }
 
     QString tmpFilePath() const { return mTmpFilePath; }
     void    saveTmpFile(const QString &filePath);
 
     void saveAs(const QString &filePath) const;
 
-    bool isEmpty() const { return mData.isEmpty(); }
+    bool isEmpty() const { return mData->data.isEmpty(); }
 
     enum class Format {
         Unknown = 0,
@@ -66,15 +68,26 @@ public:
         SVG,
     };
 
-    Format format() const { return mFormat; }
+    Format format() const { return mData->format; }
 
 private:
-    Format     mFormat = Format::Unknown;
-    QString    mMimeType;
-    QByteArray mData;
-    QSize      mSize;
-    int        mDepth = 0;
-    QString    mTmpFilePath;
+    struct Data
+    {
+        Format     format = Format::Unknown;
+        QString    mimeType;
+        QByteArray data;
+        QSize      size;
+        int        depth = 0;
+    };
+
+    // The images are shared between all encoders and discs
+    // that use the same file with the same size.
+    static QSharedPointer<const Data> load(const QString &filePath, uint size);
+    static QSharedPointer<const Data> read(const QString &filePath, uint size);
+    static QSharedPointer<const Data> emptyData();
+
+    QSharedPointer<const Data> mData = emptyData();
+    QString                    mTmpFilePath;
 };
 
 #endif // COVERIMAGE_H
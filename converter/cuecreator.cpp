@@ -36,9 +36,10 @@ using namespace Conv;
 /************************************************
 
  ************************************************/
-CueCreator::CueCreator(const Disc *disc, PreGapType preGapType) :
+CueCreator::CueCreator(const Disc *disc, const Profile &profile) :
     mDisc(disc),
-    mPreGapType(preGapType)
+    mProfile(profile),
+    mPreGapType(profile.preGapType())
 {
 
     setTextCodecName("UTF-8");
@@ -165,10 +166,20 @@ void CueCreator::write(QIODevice *out)
     writeGlobalTag(out, "SONGWRITER \"%1\"", TagId::SongWriter);
     writeGlobalTag(out, "TITLE \"%1\"", TagId::Album);
 
+    if (mHasReplayGain) {
+        writeLine(out, QString("REM REPLAYGAIN_ALBUM_GAIN %1 dB").arg(mAlbumGain.gain(), 0, 'f', 2));
+        writeLine(out, QString("REM REPLAYGAIN_ALBUM_PEAK %1").arg(mAlbumGain.peak(), 0, 'f', 8));
+    }
+
+    if (!mImageFileName.isEmpty()) {
+        writeImageTracks(out);
+        return;
+    }
+
     if (createPreGapFile)
-        writeLine(out, QString("FILE \"%1\" WAVE").arg(QFileInfo(mDisc->preGapTrack()->resultFilePath()).fileName()));
+        writeLine(out, QString("FILE \"%1\" WAVE").arg(QFileInfo(mDisc->preGapTrack()->resultFilePath(mProfile)).fileName()));
     else
-        writeLine(out, QString("FILE \"%1\" WAVE").arg(QFileInfo(mDisc->track(0)->resultFilePath()).fileName()));
+        writeLine(out, QString("FILE \"%1\" WAVE").arg(QFileInfo(mDisc->track(0)->resultFilePath(mProfile)).fileName()));
 
     // Tracks ...........................
     CueTime prevIndex("00:00:00");
@@ -191,7 +202,7 @@ void CueCreator::write(QIODevice *out)
         if (i == 0) {
             if (createPreGapFile) {
                 writeLine(out, QString("    INDEX 00 %1").arg("00:00:00"));
-                writeLine(out, QString("FILE \"%1\" WAVE").arg(QFileInfo(track->resultFileName()).fileName()));
+                writeLine(out, QString("FILE \"%1\" WAVE").arg(QFileInfo(track->resultFileName(mProfile)).fileName()));
                 writeLine(out, QString("    INDEX 01 %1").arg("00:00:00"));
             }
             else {
@@ -204,7 +215,7 @@ void CueCreator::write(QIODevice *out)
                 writeLine(out, QString("    INDEX 00 %1").arg((index0 - prevIndex).toString()));
 
             prevIndex = index1;
-            writeLine(out, QString("FILE \"%1\" WAVE").arg(QFileInfo(track->resultFileName()).fileName()));
+            writeLine(out, QString("FILE \"%1\" WAVE").arg(QFileInfo(track->resultFileName(mProfile)).fileName()));
             writeLine(out, QString("    INDEX 01 %1").arg("00:00:00"));
         }
 
@@ -215,17 +226,107 @@ void CueCreator::write(QIODevice *out)
     }
 }
 
-QString CueCreator::writeToFile(const QString &fileTemplate)
+/************************************************
+ * All tracks are in the one file, so we keep
+ * the original indexes from the source CUE.
+ ************************************************/
+void CueCreator::writeImageTracks(QIODevice *out)
 {
-    Track          *track = mDisc->track(0);
-    QString         dir   = QFileInfo(track->resultFilePath()).dir().absolutePath();
-    PatternExpander expander(*track);
+    writeLine(out, QString("FILE \"%1\" WAVE").arg(mImageFileName));
+
+    for (int i = 0; i < mDisc->count(); ++i) {
+        Track   *track  = mDisc->track(i);
+        CueIndex index0 = track->cueIndex(0);
+        CueIndex index1 = track->cueIndex(1);
+
+        writeLine(out, QString("  TRACK %1 AUDIO").arg(i + 1, 2, 10, QChar('0')));
+
+        CueFlags flags(track->tag(TagId::Flags));
+        flags.preEmphasis = false; // We already deephasis audio, so we reset this flag
+        if (!flags.isEmpty()) {
+            writeLine(out, QString("    FLAGS %1").arg(flags.toString()));
+        }
+
+        writeTrackTag(out, track, "    ISRC %1", TagId::ISRC);
+        writeTrackTag(out, track, "    TITLE \"%1\"", TagId::Title);
+        writeTrackGain(out, i);
+
+        if (i == 0 && index1.milliseconds() > 0) {
+            writeLine(out, QString("    INDEX 00 %1").arg("00:00:00"));
+        }
+        else if (i > 0 && !index0.isNull() && index0 != index1) {
+            writeLine(out, QString("    INDEX 00 %1").arg(index0.toString()));
+        }
+        writeLine(out, QString("    INDEX 01 %1").arg(index1.toString()));
+
+        writeTrackTag(out, track, "    REM GENRE \"%1\"", TagId::Genre);
+        writeTrackTag(out, track, "    REM DATE %1", TagId::Date);
+        writeTrackTag(out, track, "    PERFORMER \"%1\"", TagId::Artist);
+        writeTrackTag(out, track, "    SONGWRITER \"%1\"", TagId::SongWriter);
+    }
+}
+
+/************************************************
+
+ ************************************************/
+void CueCreator::writeTrackGain(QIODevice *out, int trackIndex)
+{
+    if (!mHasReplayGain || trackIndex >= mTrackGains.count()) {
+        return;
+    }
+
+    const ReplayGain::Result &gain = mTrackGains.at(trackIndex);
+    writeLine(out, QString("    REM REPLAYGAIN_TRACK_GAIN %1 dB").arg(gain.gain(), 0, 'f', 2));
+    writeLine(out, QString("    REM REPLAYGAIN_TRACK_PEAK %1").arg(gain.peak(), 0, 'f', 8));
+}
+
+/************************************************
+
+ ************************************************/
+void CueCreator::setReplayGain(const QVector<ReplayGain::Result> &trackGains, const ReplayGain::Result &albumGain)
+{
+    mTrackGains    = trackGains;
+    mAlbumGain     = albumGain;
+    mHasReplayGain = true;
+}
+
+/************************************************
+
+ ************************************************/
+QString CueCreator::expandFileName(const QString &fileTemplate) const
+{
+    PatternExpander expander(*mDisc->track(0));
     expander.setTrackNum(0);
     expander.setTrackCount(mDisc->count());
     expander.setDiscNum(mDisc->discNum());
     expander.setDiscCount(mDisc->discCount());
 
-    QString fileName = expander.expand(fileTemplate);
+    return expander.expand(fileTemplate);
+}
+
+/************************************************
+ * The image file has the same name as the CUE file.
+ ************************************************/
+QString CueCreator::imageFilePath() const
+{
+    QString dir      = QFileInfo(mDisc->track(0)->resultFilePath(mProfile)).dir().absolutePath();
+    QString fileName = expandFileName(mProfile.cueFileName());
+
+    if (fileName.endsWith(".cue")) {
+        fileName.chop(4);
+    }
+
+    return dir + QDir::separator() + fileName + "." + mProfile.ext();
+}
+
+/************************************************
+
+ ************************************************/
+QString CueCreator::writeToFile(const QString &fileTemplate)
+{
+    Track  *track    = mDisc->track(0);
+    QString dir      = QFileInfo(track->resultFilePath(mProfile)).dir().absolutePath();
+    QString fileName = expandFileName(fileTemplate);
 
     if (!fileName.endsWith(".cue"))
         fileName += ".cue";
@@ -30,6 +30,8 @@
 #include <QFile>
 #include <QString>
 #include "track.h"
+#include "profiles.h"
+#include "replaygain.h"
 
 class Disc;
 class Track;
@@ -39,22 +41,39 @@ namespace Conv {
 class CueCreator
 {
 public:
-    explicit CueCreator(const Disc *disc, PreGapType preGapType);
+    explicit CueCreator(const Disc *disc, const Profile &profile);
 
     void    write(QIODevice *out);
     QString writeToFile(const QString &fileTemplate);
 
+    // Whole image mode, all tracks refer to the one file
+    QString imageFilePath() const;
+    QString imageFileName() const { return mImageFileName; }
+    void    setImageFileName(const QString &value) { mImageFileName = value; }
+
+    void setReplayGain(const QVector<ReplayGain::Result> &trackGains, const ReplayGain::Result &albumGain);
+
     QTextCodec *textCodec() const { return mTextCodec; }
     void        setTextCodecName(const QString &codecName);
     void        setTextCodecMib(int mib);
 
 private:
     const Disc      *mDisc;
+    const Profile    mProfile;
     const PreGapType mPreGapType;
 
     QTextCodec *mTextCodec;
     TrackTags   mGlobalTags;
 
+    QString                     mImageFileName;
+    QVector<ReplayGain::Result> mTrackGains;
+    ReplayGain::Result          mAlbumGain;
+    bool                        mHasReplayGain = false;
+
+    QString expandFileName(const QString &fileTemplate) const;
+    void    writeImageTracks(QIODevice *out);
+    void    writeTrackGain(QIODevice *out, int trackIndex);
+
     void initGlobalTags();
     void writeLine(QIODevice *out, const QString &text);
     void writeGlobalTag(QIODevice *out, const QString &format, TagId tagId);
@@ -26,6 +26,9 @@
 #include "decoder.h"
 #include "../cue.h"
 #include "../settings.h"
+#include "extprogram.h"
+#include "stallwatchdog.h"
+#include "trace.h"
 
 #include <QIODevice>
 #include <QFile>
@@ -46,7 +49,7 @@ static const int READ_DELAY   = 1000;
 /************************************************
  *
  ************************************************/
-static qint64 timeToBytes(const CueTime &time, const WavHeader &wav)
+qint64 Decoder::timeToBytes(const CueTime &time, const WavHeader &wav)
 {
     if (wav.isCdQuality()) {
         return (qint64)((((double)time.frames() * (double)wav.byteRate()) / 75.0) + 0.5);
@@ -120,12 +123,43 @@ void Decoder::openFile()
     }
 }
 
+/************************************************
+ *
+ ************************************************/
+Decoder::Programs Decoder::programsFromSettings()
+{
+    Programs res;
+    for (const InputFormat *format : InputFormat::allFormats()) {
+        const QString name = format->decoderProgramName();
+        if (!name.isEmpty()) {
+            res[name] = Settings::i()->programName(name);
+        }
+    }
+    return res;
+}
+
+/************************************************
+ * Without setThreadPrograms the programs are read
+ * from the settings.
+ ************************************************/
+static thread_local bool              threadProgramsSet = false;
+static thread_local Decoder::Programs threadPrograms;
+
+/************************************************
+ *
+ ************************************************/
+void Decoder::setThreadPrograms(const Programs &programs)
+{
+    threadPrograms    = programs;
+    threadProgramsSet = true;
+}
+
 /************************************************
  *
  ************************************************/
 void Decoder::openProcess()
 {
-    QString program = Settings::i()->programName(mFormat->decoderProgramName());
+    QString program = threadProgramsSet ? threadPrograms.value(mFormat->decoderProgramName()) : Settings::i()->programName(mFormat->decoderProgramName());
     if (program.isEmpty()) {
         throw FlaconError(tr("The %1 program is not installed.<br>Verify that all required programs are installed and in your preferences.",
                              "Error message. %1 - is an program name")
@@ -138,8 +172,9 @@ void Decoder::openProcess()
                              "Error message. %1 - is an program name")
                                   .arg(mFormat->decoderProgramName()));
     }
-    mProcess = new QProcess(this);
+    mProcess = new ExtProgram(this);
     mProcess->setReadChannel(QProcess::StandardOutput);
+    mCancel.attach(mProcess);
 
     mProcess->start(QDir::toNativeSeparators(program), mFormat->decoderArgs(mInputFile));
     bool res = mProcess->waitForStarted();
@@ -167,7 +202,9 @@ void Decoder::close()
         mFile->close();
 
     if (mProcess) {
-        mProcess->terminate();
+        // The rest of the output is not needed, the killed
+        // ExtProgram doesn't report the crash.
+        ExtProgram::killGroup(mProcess);
         mProcess->waitForFinished();
         mProcess->close();
     }
@@ -176,11 +213,20 @@ void Decoder::close()
 /************************************************
  *
  ************************************************/
-void mustWrite(const char *buf, qint64 maxSize, QIODevice *outDevice)
+static void mustWrite(const char *buf, qint64 maxSize, QIODevice *outDevice, const CancellationToken &cancel)
 {
     qint64 done = 0;
     while (done < maxSize) {
-        outDevice->waitForBytesWritten(10000);
+        // QFile and QProcess with the empty buffer never report
+        // the written bytes, the wait would last the whole timeout.
+        if (outDevice->bytesToWrite() > 0) {
+            cancel.waitForBytesWritten(outDevice, 10000);
+        }
+        else {
+            cancel.waitIfPaused();
+            cancel.throwIfCanceled();
+        }
+
         qint64 n = outDevice->write(buf + done, maxSize - done);
         if (n < 0)
             throw FlaconError(QString("Can't write %1 bytes. %2")
@@ -194,7 +240,7 @@ void mustWrite(const char *buf, qint64 maxSize, QIODevice *outDevice)
 /************************************************
  *
  ************************************************/
-bool mustSkip(QIODevice *device, qint64 size, int msecs = READ_DELAY)
+static bool mustSkip(QIODevice *device, qint64 size, const CancellationToken &cancel, StallWatchdog &watchdog, int msecs = READ_DELAY)
 {
     static const int BUF_SIZE = 4096;
 
@@ -204,11 +250,13 @@ bool mustSkip(QIODevice *device, qint64 size, int msecs = READ_DELAY)
     char   buf[BUF_SIZE];
     qint64 left = size;
     while (left > 0) {
-        device->bytesAvailable() || device->waitForReadyRead(msecs);
+        device->bytesAvailable() || cancel.waitForReadyRead(device, msecs);
         qint64 n = device->read(buf, qMin(qint64(BUF_SIZE), left));
         if (n < 0)
             return false;
 
+        watchdog.addBytes(n);
+        watchdog.check();
         left -= n;
     }
 
@@ -220,6 +268,8 @@ bool mustSkip(QIODevice *device, qint64 size, int msecs = READ_DELAY)
  ************************************************/
 void Decoder::extract(const CueTime &start, const CueTime &end, QIODevice *outDevice, bool writeHeader)
 {
+    TraceScope trace("Decoder::extract");
+
     try {
         emit progress(0);
 
@@ -229,6 +279,9 @@ void Decoder::extract(const CueTime &start, const CueTime &end, QIODevice *outDe
         else
             input = mFile;
 
+        // Only the decoder program can hang, the file is always readable
+        StallWatchdog watchdog(mProcess ? mProcess->program() : mInputFile, mProcess ? mStallTimeout : 0, mCancel);
+
         quint64 bs = timeToBytes(start, mWavHeader) + mWavHeader.dataStartPos();
         quint64 be = 0;
 
@@ -250,7 +303,7 @@ void Decoder::extract(const CueTime &start, const CueTime &end, QIODevice *outDe
         if (len < 0)
             throw FlaconError("Incorrect start time.");
 
-        if (!mustSkip(input, len))
+        if (!mustSkip(input, len, mCancel, watchdog))
             throw FlaconError("Can't skip to start of track.");
 
         pos += len;
@@ -267,17 +320,20 @@ void Decoder::extract(const CueTime &start, const CueTime &end, QIODevice *outDe
 
         char buf[MAX_BUF_SIZE];
         while (remains > 0) {
-            input->bytesAvailable() || input->waitForReadyRead(10000);
+            mCancel.waitIfPaused();
+            input->bytesAvailable() || mCancel.waitForReadyRead(input, READ_DELAY);
 
             qint64 n = qMin(qint64(MAX_BUF_SIZE), remains);
             n        = input->read(buf, n);
             if (n < 0)
                 throw FlaconError(QString("Can't read %1 bytes").arg(remains));
 
+            watchdog.addBytes(n);
+            watchdog.check();
             remains -= n;
 
             // Write to OutDevice .........................
-            mustWrite(buf, n, outDevice);
+            mustWrite(buf, n, outDevice, mCancel);
 
             // Calc progrress .............................
             if (remains == 0) {
@@ -295,9 +351,9 @@ void Decoder::extract(const CueTime &start, const CueTime &end, QIODevice *outDe
         // Read bytes from start to end of track ..........
         mPos = pos;
     }
-    catch (FlaconError &err) {
+    catch (FlaconError &) {
         close();
-        throw err;
+        throw;
     }
 }
 
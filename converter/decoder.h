@@ -30,8 +30,10 @@
 #include <QObject>
 #include <QString>
 #include <QByteArray>
+#include <QHash>
 #include "../cue.h"
 #include "../formats_in/informat.h"
+#include "cancellationtoken.h"
 
 class QIODevice;
 class QProcess;
@@ -49,6 +51,13 @@ public:
     void open(const QString &fileName);
     void close();
 
+    // The extract() throws CanceledError when the token is canceled.
+    void setCancellationToken(const CancellationToken &token) { mCancel = token; }
+
+    // The decoder program without output for this time is killed
+    // and extract() throws StalledError, msec. 0 disables the check.
+    void setStallTimeout(int value) { mStallTimeout = value; }
+
     void extract(const CueTime &start, const CueTime &end, QIODevice *outDevice, bool writeHeader = true);
     void extract(const CueTime &start, const CueTime &end, const QString &outFileName);
 
@@ -63,6 +72,15 @@ public:
 
     uint64_t bytesCount(const CueTime &start, const CueTime &end) const;
 
+    // Offset of the time in the audio data, without the header.
+    static qint64 timeToBytes(const CueTime &time, const WavHeader &wav);
+
+    // The settings are not thread safe, the decoders in the pool
+    // threads use the program paths read in the main thread.
+    using Programs = QHash<QString, QString>;
+    static Programs programsFromSettings();
+    static void     setThreadPrograms(const Programs &programs);
+
 signals:
     void progress(int percent);
 
@@ -73,6 +91,8 @@ private:
     QFile             *mFile;
     WavHeader          mWavHeader;
     quint64            mPos;
+    CancellationToken  mCancel;
+    int                mStallTimeout = 0;
 
     void openFile();
     void openProcess();
@@ -33,6 +33,9 @@
 #include "project.h"
 #include "inputaudiofile.h"
 #include "profiles.h"
+#include "flacsplitter.h"
+#include "settings.h"
+#include "trace.h"
 #include "formats_out/metadatawriter.h"
 
 #include <QThread>
@@ -43,6 +46,8 @@
 #include <errno.h>
 #include <QLoggingCategory>
 #include <QBuffer>
+#include <QTimer>
+#include <QSharedPointer>
 
 namespace {
 Q_LOGGING_CATEGORY(LOG, "DiscPipeline")
@@ -101,12 +106,16 @@ void WorkerThread::run()
 /************************************************
  *
  ************************************************/
-DiscPipeline::DiscPipeline(const Profile &profile, Disc *disc, ConvTracks tracks, const QString &workDir, QObject *parent) noexcept(false) :
+DiscPipeline::DiscPipeline(const Profiles &profiles, Disc *disc, ConvTracks tracks, const QString &workDir, QObject *parent) noexcept(false) :
     QObject(parent),
-    mProfile(profile),
     mDisc(disc),
     mWorkDir(workDir)
 {
+    for (const Profile &profile : profiles) {
+        Output out;
+        out.profile = profile;
+        mOutputs << out;
+    }
 
     QString dir = QFileInfo(mWorkDir).dir().absolutePath();
     qCDebug(LOG) << "Create tmp dir" << dir;
@@ -118,16 +127,47 @@ DiscPipeline::DiscPipeline(const Profile &profile, Disc *disc, ConvTracks tracks
 
     for (const ConvTrack &track : qAsConst(tracks)) {
         if (track.audioFile().channelsCount() > 2) {
-            mProfile.setGainType(GainType::Disable);
+            for (Output &out : mOutputs) {
+                out.profile.setGainType(GainType::Disable);
+            }
         }
 
         mTracks << track;
         mTrackStates[track.index()] = TrackState::NotRunning;
 
-        qCDebug(LOG) << "Create directory for output files" << dir;
-        createDir(QFileInfo(track.resultFilePath()).absoluteDir().path());
+        for (const Output &out : qAsConst(mOutputs)) {
+            qCDebug(LOG) << "Create directory for output files" << dir;
+            createDir(QFileInfo(track.resultFilePath(out.profile)).absoluteDir().path());
+        }
+    }
+
+    // All profiles in the pipeline have the same whole image option
+    mWholeImage = mOutputs.first().profile.isWholeImage();
+    if (mWholeImage) {
+        mImageTrack = mTracks.first();
+        mImageTrack.setTitle(mImageTrack.album());
+        mImageTrack.setTag(TagId::TrackNum, QByteArray());
+        mImageTrack.setPregap(false);
+    }
+
+    mSmartSplit = mOutputs.count() == 1 && !mWholeImage && FlacSplitter::canSplit(mDisc, mOutputs.first().profile);
+    qCDebug(LOG) << "Smart split:" << mSmartSplit;
+
+    // The track gain doesn't depend on the output format,
+    // so we calculate it only once and share it between all outputs.
+    for (int i = 0; i < mOutputs.count(); ++i) {
+        if (mOutputs[i].profile.gainType() != GainType::Disable) {
+            mGainOutput = i;
+            break;
+        }
     }
 
+    mRetryCount = Settings::i()->value(Settings::Encoder_RetryCount).toInt();
+    mRetryDelay = Settings::i()->value(Settings::Encoder_RetryDelay).toInt();
+
+    // The setting is in seconds
+    mStallTimeout = Settings::i()->value(Settings::Encoder_StallTimeout).toInt() * 1000;
+
     addSpliterRequest();
 }
 
@@ -148,7 +188,7 @@ DiscPipeline::~DiscPipeline()
  ************************************************/
 void DiscPipeline::startWorker(int *splitterCount, int *count)
 {
-    if (mInterrupted) {
+    if (mInterrupted || mCancel.isPaused()) {
         return;
     }
 
@@ -166,7 +206,7 @@ void DiscPipeline::startWorker(int *splitterCount, int *count)
 
     while (*count > 0 && !mEncoderRequests.isEmpty()) {
         const Request req = mEncoderRequests.takeFirst();
-        startEncoder(req.track, req.inputFile);
+        startEncoder(req);
         --(*count);
     }
 }
@@ -179,7 +219,14 @@ void DiscPipeline::addSpliterRequest()
 {
     QString outDir = mTmpDir->path();
 
-    PreGapType pregapType = (hasPregap() && mProfile.isCreateCue()) ? mProfile.preGapType() : PreGapType::Skip;
+    if (mWholeImage) {
+        mSplitterRequests << SplitterRequest { ConvTracks() << mImageTrack, outDir, PreGapType::Skip };
+        return;
+    }
+
+    // The converter groups the profiles, so all outputs have the same pregap type.
+    const Profile &profile    = mOutputs.first().profile;
+    PreGapType     pregapType = (hasPregap() && profile.isCreateCue()) ? profile.preGapType() : PreGapType::Skip;
 
     mSplitterRequests << SplitterRequest { mTracks, outDir, pregapType };
 }
@@ -189,33 +236,78 @@ void DiscPipeline::addSpliterRequest()
  ************************************************/
 void DiscPipeline::startSplitter(const SplitterRequest &request)
 {
-    Splitter *splitter = new Splitter(mDisc, request.tracks, request.outDir);
-    splitter->setPregapType(request.pregapType);
-    WorkerThread *thread = new WorkerThread(splitter, this);
+    Worker *worker = nullptr;
+
+    // The splitter processes the tracks in order, the retry
+    // continues from the first track that was not split.
+    QSharedPointer<int>  splitCount(new int(0));
+    QSharedPointer<bool> stalled(new bool(false));
+    auto                 countTrack = [splitCount]() { ++(*splitCount); };
+
+    if (mSmartSplit) {
+        FlacSplitter *splitter = new FlacSplitter(mDisc, request.tracks, request.outDir);
+        splitter->setPregapType(request.pregapType);
+        splitter->setCompression(mOutputs.first().profile.value("Compression").toInt());
+        connect(splitter, &FlacSplitter::trackReady, this, countTrack);
+        connect(splitter, &FlacSplitter::trackReady, this, &DiscPipeline::smartSplitDone);
+        worker = splitter;
+    }
+    else {
+        Splitter *splitter = new Splitter(mDisc, request.tracks, request.outDir);
+        splitter->setPregapType(request.pregapType);
+        splitter->setWholeImage(mWholeImage);
+        connect(splitter, &Splitter::trackReady, this, countTrack);
+        connect(splitter, &Splitter::trackReady, this, &DiscPipeline::addEncoderRequest);
+        worker = splitter;
+    }
+
+    worker->setCancellationToken(mCancel);
+    worker->setStallTimeout(mStallTimeout);
+    WorkerThread *thread = new WorkerThread(worker, this);
 
     connect(this, &DiscPipeline::stopAllThreads, thread, &Conv::WorkerThread::deleteLater);
-    connect(splitter, &Splitter::trackProgress, this, &DiscPipeline::trackProgress);
-    connect(splitter, &Worker::error, this, &DiscPipeline::trackError);
-    connect(splitter, &Splitter::trackReady, this, &DiscPipeline::addEncoderRequest);
+    connect(worker, &Worker::trackProgress, this, &DiscPipeline::trackProgress);
+    connect(worker, &Worker::stalled, this, &DiscPipeline::trackStalled);
+    connect(worker, &Worker::stalled, this, [stalled]() { *stalled = true; });
+    connect(worker, &Worker::error, this, [this, request, splitCount, stalled](const ConvTrack &track, const QString &message) {
+        splitterError(request, *splitCount, *stalled, track, message);
+    });
     connect(thread, &Conv::WorkerThread::finished, this, &DiscPipeline::threadFinished);
 
     mThreads << thread;
     thread->start();
 
-    for (const ConvTrack &t : request.tracks) {
+    for (const ConvTrack &t : mWholeImage ? mTracks : request.tracks) {
         mTrackStates[t.index()] = TrackState::Splitting;
     }
 
-    // *********************************************************
-    // Short tasks, we do not allocate separate threads for them.
+    // The retried splitter requests use the prepared outputs
+    if (!mOutputsPrepared) {
+        mOutputsPrepared = true;
+        prepareOutputs(request.tracks.first());
+    }
+}
+
+/************************************************
+ * Short tasks, we do not allocate separate
+ * threads for them.
+ ************************************************/
+void DiscPipeline::prepareOutputs(const ConvTrack &track)
+{
     try {
-        copyCoverImage();
-        createEmbedImage();
-        writeOutCueFile();
-        loadEmbeddedCue();
+        for (int i = 0; i < mOutputs.count(); ++i) {
+            copyCoverImage(mOutputs[i]);
+            createEmbedImage(i);
+
+            // In whole image mode the CUE is written together with the gain
+            if (!mWholeImage) {
+                writeOutCueFile(mOutputs[i]);
+                loadEmbeddedCue(mOutputs[i]);
+            }
+        }
     }
     catch (const FlaconError &err) {
-        trackError(request.tracks.first(), err.what());
+        trackError(track, err.what());
     }
 }
 
@@ -224,41 +316,100 @@ void DiscPipeline::startSplitter(const SplitterRequest &request)
  ************************************************/
 void DiscPipeline::addEncoderRequest(const ConvTrack &track, const QString &inputFile)
 {
-    mEncoderRequests << Request { track, inputFile };
+    for (int i = 0; i < mOutputs.count(); ++i) {
+        mEncoderRequests << Request { track, inputFile, i };
+    }
+    mInputFileUsers[inputFile] = mOutputs.count();
+
     trackProgress(track, TrackState::Queued, 0);
     emit readyStart();
 }
 
+/************************************************
+ * The FlacSplitter creates the final audio, we
+ * only need to write the tags.
+ ************************************************/
+void DiscPipeline::smartSplitDone(const ConvTrack &track, const QString &fileName)
+{
+    const Output &out = mOutputs.first();
+
+    try {
+        MetadataWriter *writer = out.profile.outFormat()->createMetadataWriter(fileName);
+        writer->setTags(track);
+        if (out.profile.isEmbedCue()) {
+            writer->setEmbeddedCue(out.embeddedCue);
+        }
+
+        if (!out.coverImage.isEmpty()) {
+            writer->setCoverImage(out.coverImage);
+        }
+
+        TraceScope trace("MetadataWriter::save", track.trackNum());
+        writer->save();
+        delete writer;
+    }
+    catch (const FlaconError &err) {
+        trackError(track, err.what(), 0);
+        return;
+    }
+
+    trackDone(0, track, fileName);
+}
+
 /************************************************
  *
  ************************************************/
-void DiscPipeline::startEncoder(const ConvTrack &track, const QString &inputFile)
+void DiscPipeline::startEncoder(const Request &request)
 {
-    QFileInfo trackFile(track.resultFilePath());
-    QString   outFile = QDir(mTmpDir->path()).filePath(QFileInfo(inputFile).baseName() + ".encoded." + trackFile.suffix());
+    const Output &out = mOutputs.at(request.output);
+
+    QFileInfo trackFile(resultFilePath(out, request.track));
+    QString   outFile = QDir(mTmpDir->path()).filePath(QString("%1.encoded.%2.%3").arg(QFileInfo(request.inputFile).baseName()).arg(request.output).arg(trackFile.suffix()));
 
-    Encoder *encoder = mProfile.outFormat()->createEncoder();
-    encoder->setInputFile(inputFile);
+    Encoder *encoder = out.profile.outFormat()->createEncoder();
+    encoder->setInputFile(request.inputFile);
     encoder->setOutFile(outFile);
-    encoder->setTrack(track);
-    encoder->setProfile(mProfile);
-    encoder->setEmbeddedCue(mEmbeddedCue);
-    encoder->setCoverImage(mCoverImage);
+    encoder->setTrack(request.track);
+    encoder->setProfile(out.profile);
+    encoder->setReplayGainEnabled(request.output == mGainOutput);
+    encoder->setKeepInputFile(mOutputs.count() > 1);
+    encoder->setEmbeddedCue(out.embeddedCue);
+    encoder->setCoverImage(out.coverImage);
+
+    if (mWholeImage) {
+        encoder->setWriteMetadata(false);
+
+        if (request.output == mGainOutput) {
+            QVector<CueTime> segments;
+            for (int i = 0; i < mDisc->count(); ++i) {
+                segments << mDisc->track(i)->cueIndex(1);
+            }
+            encoder->setGainSegments(segments);
+        }
+    }
 
+    encoder->setCancellationToken(mCancel);
+    encoder->setStallTimeout(mStallTimeout);
     WorkerThread *thread = new WorkerThread(encoder, this);
+    connect(encoder, &Encoder::stalled, this, &DiscPipeline::trackStalled);
 
     connect(this, &DiscPipeline::stopAllThreads, thread, &Conv::WorkerThread::deleteLater);
-    connect(encoder, &Encoder::trackProgress, this, &DiscPipeline::trackProgress);
-    connect(encoder, &Encoder::error, this, &DiscPipeline::trackError);
+    connect(encoder, &Encoder::error, this, [this, request](const ConvTrack &, const QString &message) {
+        encoderError(request, message);
+    });
 
-    // Replaygain ...............................
-    if (mProfile.gainType() != GainType::Disable) {
-        connect(encoder, &Encoder::trackReady, this, &DiscPipeline::writeGain);
-    }
-    else {
-        connect(encoder, &Encoder::trackReady, this, &DiscPipeline::trackDone);
-    }
-    // ..........................................
+    const int output = request.output;
+    connect(encoder, &Encoder::trackProgress, this, [this, output](const ConvTrack &track, TrackState state, int percent) {
+        encoderProgress(output, track, state, percent);
+    });
+
+    connect(encoder, &Encoder::segmentGainsReady, this, [this](const ConvTrack &, const QVector<ReplayGain::Result> &gains) {
+        mSegmentGains = gains;
+    });
+
+    connect(encoder, &Encoder::trackReady, this, [this, request](const ConvTrack &, const QString &outFileName, const ReplayGain::Result &trackGain) {
+        encoderDone(request, outFileName, trackGain);
+    });
 
     connect(thread, &Conv::WorkerThread::finished, this, &DiscPipeline::threadFinished);
 
@@ -266,64 +417,337 @@ void DiscPipeline::startEncoder(const ConvTrack &track, const QString &inputFile
     thread->start();
 }
 
+/************************************************
+ * With several outputs the track progress is
+ * the average of all its encoders.
+ ************************************************/
+void DiscPipeline::encoderProgress(int output, const ConvTrack &track, TrackState state, int percent)
+{
+    outputProgress(output, track, state, percent);
+
+    if (mOutputs.count() < 2 || state != TrackState::Encoding) {
+        setTrackState(track, state, percent);
+        return;
+    }
+
+    QVector<int> &percents = mEncoderPercents[track.index()];
+    percents.resize(mOutputs.count());
+    percents[output] = percent;
+
+    int sum = 0;
+    for (int p : qAsConst(percents)) {
+        sum += p;
+    }
+    setTrackState(track, state, sum / percents.count());
+}
+
 /************************************************
  *
  ************************************************/
-void DiscPipeline::writeGain(const ConvTrack &track, const QString &fileName, const ReplayGain::Result &trackGain)
+void DiscPipeline::encoderDone(const Request &request, const QString &outFileName, const ReplayGain::Result &trackGain)
 {
-    qCDebug(LOG) << "Write track gain: " << fileName << "gain:" << trackGain.gain() << "peak:" << track;
+    releaseInputFile(request.inputFile);
+
+    const ConvTrack &track  = request.track;
+    const Output    &out    = mOutputs.at(request.output);
+    const int        output = request.output;
+
+    if (out.profile.gainType() == GainType::Disable) {
+        trackEncoded(output, track, outFileName, ReplayGain::Result());
+        return;
+    }
+
+    if (output == mGainOutput) {
+        mTrackGains[track.index()] = trackGain;
+        trackEncoded(output, track, outFileName, trackGain);
+
+        // Other outputs waited for this gain
+        QList<Request> waiting;
+        for (auto it = mGainRequests.begin(); it != mGainRequests.end();) {
+            if (it->track.index() == track.index()) {
+                waiting << *it;
+                it = mGainRequests.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
 
-    MetadataWriter *writer = mProfile.outFormat()->createMetadataWriter(fileName);
-    writer->setTrackReplayGain(trackGain.gain(), trackGain.peak());
-    writer->save();
-    delete writer;
+        for (const Request &r : qAsConst(waiting)) {
+            trackEncoded(r.output, r.track, r.inputFile, trackGain);
+        }
+        return;
+    }
 
-    if (mProfile.gainType() != GainType::Album) {
-        trackDone(track, fileName);
+    if (mTrackGains.contains(track.index())) {
+        trackEncoded(output, track, outFileName, mTrackGains.value(track.index()));
         return;
     }
 
-    mAlbumGain.add(trackGain);
-    trackProgress(track, TrackState::WaitGain, 0);
-    mAlbumGainRequests << Request { track, fileName };
+    setTrackState(track, TrackState::WaitGain, 0);
+    outputProgress(output, track, TrackState::WaitGain, 0);
+    mGainRequests << Request { track, outFileName, output };
+}
+
+/************************************************
+ * The encoder failure can be transient (a killed
+ * process, a full disk), so the request is queued
+ * again after a delay. The other tracks continue.
+ ************************************************/
+void DiscPipeline::encoderError(const Request &request, const QString &message)
+{
+    if (mInterrupted) {
+        return;
+    }
 
-    if (mAlbumGainRequests.count() < mTracks.count()) {
+    if (request.attempt >= mRetryCount) {
+        trackError(request.track, message, request.output);
         return;
     }
 
-    for (const Request &r : mAlbumGainRequests) {
-        qCDebug(LOG) << "Write album gain: " << r.inputFile << "gain:" << mAlbumGain.result().gain() << "peak:" << mAlbumGain.result().peak();
+    outputFailed(request.output, request.track, message);
+
+    Request retry = request;
+    retry.attempt++;
+
+    int delay = mRetryDelay << request.attempt;
+    qCWarning(LOG) << "Track" << request.track.trackNum() << "failed, retry" << retry.attempt << "of" << mRetryCount << "in" << delay << "ms";
+
+    setTrackState(request.track, TrackState::Queued, 0);
+    outputProgress(request.output, request.track, TrackState::Queued, 0);
+    QTimer::singleShot(delay, this, [this, retry]() {
+        if (mInterrupted) {
+            return;
+        }
+        mEncoderRequests.prepend(retry);
+        emit readyStart();
+    });
+
+    emit threadFinished();
+}
 
-        MetadataWriter *writer = mProfile.outFormat()->createMetadataWriter(r.inputFile);
-        writer->setAlbumReplayGain(mAlbumGain.result().gain(), mAlbumGain.result().peak());
+/************************************************
+ * The stalled decoder was killed by the watchdog,
+ * the splitter is started again for the tracks
+ * that were not split yet. Other errors (a corrupted
+ * or missing file) are not transient, the retry
+ * would fail the same way.
+ ************************************************/
+void DiscPipeline::splitterError(const SplitterRequest &request, int splitCount, bool stalled, const ConvTrack &track, const QString &message)
+{
+    if (mInterrupted) {
+        return;
+    }
+
+    if (!stalled || request.attempt >= mRetryCount || splitCount >= request.tracks.count()) {
+        trackError(track, message);
+        return;
+    }
+
+    for (int i = 0; i < mOutputs.count(); ++i) {
+        outputFailed(i, track, message);
+    }
+
+    SplitterRequest retry = request;
+    retry.tracks          = request.tracks.mid(splitCount);
+    retry.attempt++;
+
+    int delay = mRetryDelay << request.attempt;
+    qCWarning(LOG) << "Splitter failed on track" << track.trackNum() << ", retry" << retry.attempt << "of" << mRetryCount << "in" << delay << "ms";
+
+    for (const ConvTrack &t : qAsConst(retry.tracks)) {
+        trackProgress(t, TrackState::Queued, 0);
+    }
+
+    QTimer::singleShot(delay, this, [this, retry]() {
+        if (mInterrupted) {
+            return;
+        }
+        mSplitterRequests.prepend(retry);
+        emit readyStart();
+    });
+}
+
+/************************************************
+ * The split WAV file is shared by all outputs,
+ * it is removed when the last encoder is done.
+ ************************************************/
+void DiscPipeline::releaseInputFile(const QString &inputFile)
+{
+    if (mOutputs.count() < 2) {
+        return;
+    }
+
+    if (--mInputFileUsers[inputFile] > 0) {
+        return;
+    }
+
+    mInputFileUsers.remove(inputFile);
+    if (!QFile::remove(inputFile)) {
+        qCWarning(LOG) << "I can't delete file" << inputFile;
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void DiscPipeline::trackEncoded(int output, const ConvTrack &track, const QString &fileName, const ReplayGain::Result &trackGain)
+{
+    if (mWholeImage) {
+        writeImageMetadata(output, track, fileName, trackGain);
+        return;
+    }
+
+    if (mOutputs.at(output).profile.gainType() == GainType::Disable) {
+        trackDone(output, track, fileName);
+        return;
+    }
+
+    writeGain(output, track, fileName, trackGain);
+}
+
+/************************************************
+ *
+ ************************************************/
+void DiscPipeline::writeGain(int output, const ConvTrack &track, const QString &fileName, const ReplayGain::Result &trackGain)
+{
+    qCDebug(LOG) << "Write track gain: " << fileName << "gain:" << trackGain.gain() << "peak:" << track;
+
+    Output &out = mOutputs[output];
+
+    {
+        TraceScope      trace("MetadataWriter::save", track.trackNum());
+        MetadataWriter *writer = out.profile.outFormat()->createMetadataWriter(fileName);
+        writer->setTrackReplayGain(trackGain.gain(), trackGain.peak());
         writer->save();
         delete writer;
+    }
+
+    if (out.profile.gainType() != GainType::Album) {
+        trackDone(output, track, fileName);
+        return;
+    }
+
+    out.albumGain.add(trackGain);
+    setTrackState(track, TrackState::WaitGain, 0);
+    outputProgress(output, track, TrackState::WaitGain, 0);
+    out.albumGainRequests << Request { track, fileName, output };
+
+    if (out.albumGainRequests.count() < mTracks.count()) {
+        return;
+    }
+
+    const QList<Request> requests = out.albumGainRequests;
+    out.albumGainRequests.clear();
+
+    for (const Request &r : requests) {
+        qCDebug(LOG) << "Write album gain: " << r.inputFile << "gain:" << out.albumGain.result().gain() << "peak:" << out.albumGain.result().peak();
+
+        {
+            TraceScope      trace("MetadataWriter::save", r.track.trackNum());
+            MetadataWriter *writer = out.profile.outFormat()->createMetadataWriter(r.inputFile);
+            writer->setAlbumReplayGain(out.albumGain.result().gain(), out.albumGain.result().peak());
+            writer->save();
+            delete writer;
+        }
 
-        trackDone(r.track, r.inputFile);
+        trackDone(output, r.track, r.inputFile);
     }
 }
 
+/************************************************
+ * The whole image file gets the tags, cover, CUE
+ * and gain in one write. The CUE contains the
+ * gain for each track.
+ ************************************************/
+void DiscPipeline::writeImageMetadata(int output, const ConvTrack &track, const QString &fileName, const ReplayGain::Result &gain)
+{
+    const Output &out      = mOutputs.at(output);
+    const bool    withGain = out.profile.gainType() != GainType::Disable;
+
+    try {
+        CueCreator cue(mDisc, out.profile);
+        cue.setImageFileName(QFileInfo(cue.imageFilePath()).fileName());
+        if (withGain) {
+            cue.setReplayGain(mSegmentGains, gain);
+        }
+
+        if (out.profile.isCreateCue()) {
+            cue.writeToFile(out.profile.cueFileName());
+        }
+
+        QBuffer buf;
+        cue.write(&buf);
+
+        qCDebug(LOG) << "Write image metadata: " << fileName << "gain:" << gain.gain() << "peak:" << gain.peak();
+
+        MetadataWriter *writer = out.profile.outFormat()->createMetadataWriter(fileName);
+        writer->setTags(track);
+        writer->setEmbeddedCue(QString::fromUtf8(buf.data()));
+
+        if (!out.coverImage.isEmpty()) {
+            writer->setCoverImage(out.coverImage);
+        }
+
+        if (withGain) {
+            writer->setTrackReplayGain(gain.gain(), gain.peak());
+        }
+
+        if (out.profile.gainType() == GainType::Album) {
+            writer->setAlbumReplayGain(gain.gain(), gain.peak());
+        }
+
+        TraceScope trace("MetadataWriter::save", track.trackNum());
+        writer->save();
+        delete writer;
+    }
+    catch (const FlaconError &err) {
+        trackError(track, err.what(), output);
+        return;
+    }
+
+    trackDone(output, track, fileName);
+}
+
 /************************************************
  *
  ************************************************/
-void DiscPipeline::trackDone(const ConvTrack &track, const QString &outFileName)
+void DiscPipeline::trackDone(int output, const ConvTrack &track, const QString &outFileName)
 {
+    TraceScope trace("DiscPipeline::trackDone", track.trackNum());
+    const QString resultFilePath = this->resultFilePath(mOutputs.at(output), track);
+
     qCDebug(LOG) << "Track done: "
                  << "index=" << track.index()
                  << track
-                 << "outFileName:" << outFileName;
+                 << "outFileName:" << outFileName
+                 << "resultFilePath:" << resultFilePath;
 
     // Track is ready, rename the file to the final name.
     // Remove old already existing file.
-    QFile::remove(track.resultFilePath());
+    QFile::remove(resultFilePath);
 
     QFile file(outFileName);
-    if (!file.rename(track.resultFilePath())) {
-        trackError(track, tr("I can't rename file:\n%1 to %2\n%3").arg(outFileName, track.resultFilePath(), file.errorString()));
+    if (!file.rename(resultFilePath)) {
+        trackError(track, tr("I can't rename file:\n%1 to %2\n%3").arg(outFileName, resultFilePath, file.errorString()), output);
+        return;
+    }
+
+    outputProgress(output, track, TrackState::OK, 0);
+    for (const ConvTrack &t : stateTracks(track)) {
+        mDoneOutputFiles << qMakePair(output, t.index());
     }
 
-    mTrackStates[track.index()] = TrackState::OK;
-    emit trackProgressChanged(track, TrackState::OK, 0);
+    // The track is done only when all outputs are written.
+    if (++mDoneOutputs[track.index()] < mOutputs.count()) {
+        emit threadFinished();
+        return;
+    }
+
+    for (const ConvTrack &t : stateTracks(track)) {
+        mTrackStates[t.index()] = TrackState::OK;
+        emit trackProgressChanged(t, TrackState::OK, 0);
+    }
     emit threadFinished();
 
     if (!isRunning()) {
@@ -353,11 +777,15 @@ void DiscPipeline::createDir(const QString &dirName) const
 }
 
 /************************************************
-
+ * The workers see the canceled token within
+ * POLL_INTERVAL and kill their programs, so
+ * the threads are finished before the timeout
+ * in the WorkerThread destructor.
  ************************************************/
 void DiscPipeline::interrupt(TrackState state)
 {
     mInterrupted = true;
+    mCancel.cancel();
     mEncoderRequests.clear();
 
     for (ConvTrack &track : mTracks) {
@@ -371,6 +799,12 @@ void DiscPipeline::interrupt(TrackState state)
             case TrackState::NotRunning:
                 mTrackStates[track.index()] = state;
                 emit trackProgressChanged(track, state, 0);
+
+                for (int i = 0; i < mOutputs.count(); ++i) {
+                    if (!mDoneOutputFiles.contains(qMakePair(i, track.index()))) {
+                        emit outputProgressChanged(track, mOutputs.at(i).profile, resultFilePath(mOutputs.at(i), track), state, 0);
+                    }
+                }
                 break;
 
             case TrackState::Canceled:
@@ -397,8 +831,39 @@ void DiscPipeline::stop()
 /************************************************
 
  ************************************************/
-void DiscPipeline::trackError(const ConvTrack &track, const QString &message)
+void DiscPipeline::pause()
 {
+    mCancel.pause();
+}
+
+/************************************************
+
+ ************************************************/
+void DiscPipeline::resume()
+{
+    mCancel.resume();
+}
+
+/************************************************
+
+ ************************************************/
+void DiscPipeline::trackError(const ConvTrack &track, const QString &message, int output)
+{
+    // The other workers can report errors while they are stopping
+    if (mInterrupted) {
+        return;
+    }
+
+    for (int i = 0; i < mOutputs.count(); ++i) {
+        if (output < 0 || output == i) {
+            outputFailed(i, track, message);
+            outputProgress(i, track, TrackState::Error, 0);
+            for (const ConvTrack &t : stateTracks(track)) {
+                mDoneOutputFiles << qMakePair(i, t.index());
+            }
+        }
+    }
+
     mTrackStates[track.index()] = TrackState::Error;
     emit trackProgressChanged(track, TrackState::Error, 0);
     interrupt(TrackState::Aborted);
@@ -453,29 +918,96 @@ int DiscPipeline::runningThreadCount() const
 
  ************************************************/
 void DiscPipeline::trackProgress(const ConvTrack &track, TrackState state, int percent)
+{
+    setTrackState(track, state, percent);
+
+    for (int i = 0; i < mOutputs.count(); ++i) {
+        outputProgress(i, track, state, percent);
+    }
+}
+
+/************************************************
+ * The aggregated state of the track, all outputs
+ * together.
+ ************************************************/
+void DiscPipeline::setTrackState(const ConvTrack &track, TrackState state, int percent)
+{
+    if (mInterrupted)
+        return;
+
+    for (const ConvTrack &t : stateTracks(track)) {
+        mTrackStates[t.index()] = state;
+        emit trackProgressChanged(t, state, percent);
+    }
+}
+
+/************************************************
+ * The state of the output file, in whole image
+ * mode it is reported for every track of the disc.
+ ************************************************/
+void DiscPipeline::outputProgress(int output, const ConvTrack &track, TrackState state, int percent)
 {
     if (mInterrupted)
         return;
 
-    mTrackStates[track.index()] = state;
-    emit trackProgressChanged(track, state, percent);
+    const Output &out = mOutputs.at(output);
+    for (const ConvTrack &t : stateTracks(track)) {
+        emit outputProgressChanged(t, out.profile, resultFilePath(out, t), state, percent);
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void DiscPipeline::outputFailed(int output, const ConvTrack &track, const QString &message)
+{
+    const Output &out = mOutputs.at(output);
+    emit trackFailed(track, out.profile, resultFilePath(out, track), message);
 }
 
 /************************************************
  *
  ************************************************/
-void DiscPipeline::copyCoverImage() const
+QString DiscPipeline::resultFilePath(const Output &output, const ConvTrack &track) const
 {
-    QString file = mProfile.copyCoverOptions().mode != CoverMode::Disable ? mDisc->coverImageFile() : "";
-    int     size = mProfile.copyCoverOptions().mode == CoverMode::Scale ? mProfile.copyCoverOptions().size : 0;
+    if (mWholeImage) {
+        return CueCreator(mDisc, output.profile).imageFilePath();
+    }
+
+    return track.resultFilePath(output.profile);
+}
+
+/************************************************
+ * In whole image mode the image track represents
+ * all tracks of the disc.
+ ************************************************/
+QList<ConvTrack> DiscPipeline::stateTracks(const ConvTrack &track) const
+{
+    if (mWholeImage) {
+        return mTracks;
+    }
+
+    return { track };
+}
+
+/************************************************
+ *
+ ************************************************/
+void DiscPipeline::copyCoverImage(const Output &output) const
+{
+    const Profile &profile = output.profile;
+
+    QString file = profile.copyCoverOptions().mode != CoverMode::Disable ? mDisc->coverImageFile() : "";
+    int     size = profile.copyCoverOptions().mode == CoverMode::Scale ? profile.copyCoverOptions().size : 0;
 
     if (file.isEmpty()) {
         return;
     }
 
-    QString dir  = QFileInfo(mTracks.first().resultFilePath()).dir().absolutePath();
+    QString dir  = QFileInfo(mTracks.first().resultFilePath(profile)).dir().absolutePath();
     QString dest = QDir(dir).absoluteFilePath(QString("cover.%1").arg(QFileInfo(file).suffix()));
 
+    TraceScope trace("DiscPipeline::copyCoverImage");
     CoverImage image = CoverImage(file, size);
     image.saveAs(dest);
 }
@@ -483,47 +1015,61 @@ void DiscPipeline::copyCoverImage() const
 /************************************************
  *
  ************************************************/
-void DiscPipeline::createEmbedImage()
+void DiscPipeline::createEmbedImage(int output)
 {
-    QString file = mProfile.embedCoverOptions().mode != CoverMode::Disable ? mDisc->coverImageFile() : "";
-    int     size = mProfile.embedCoverOptions().mode == CoverMode::Scale ? mProfile.embedCoverOptions().size : 0;
+    const Profile &profile = mOutputs.at(output).profile;
+
+    QString file = profile.embedCoverOptions().mode != CoverMode::Disable ? mDisc->coverImageFile() : "";
+    int     size = profile.embedCoverOptions().mode == CoverMode::Scale ? profile.embedCoverOptions().size : 0;
 
     if (file.isEmpty()) {
         return;
     }
 
-    mCoverImage = CoverImage(file, size);
+    // Outputs with the same image size share the same image
+    for (int i = 0; i < output; ++i) {
+        const Profile &prev = mOutputs.at(i).profile;
+        if (prev.embedCoverOptions().mode == profile.embedCoverOptions().mode && (profile.embedCoverOptions().mode != CoverMode::Scale || prev.embedCoverOptions().size == size)) {
+            mOutputs[output].coverImage = mOutputs.at(i).coverImage;
+            return;
+        }
+    }
+
+    TraceScope trace("DiscPipeline::createEmbedImage");
+    CoverImage image(file, size);
+
+    QString tmpCoverFile = QDir(mTmpDir->path()).absoluteFilePath(QString("cover-%1.%2").arg(output).arg(QFileInfo(file).suffix()));
+    image.saveTmpFile(tmpCoverFile);
 
-    QString tmpCoverFile = QDir(mTmpDir->path()).absoluteFilePath(QString("cover.%1").arg(QFileInfo(file).suffix()));
-    mCoverImage.saveTmpFile(tmpCoverFile);
+    mOutputs[output].coverImage = image;
 }
 
 /************************************************
  *
  ************************************************/
-void DiscPipeline::writeOutCueFile()
+void DiscPipeline::writeOutCueFile(const Output &output) const
 {
-    if (!mProfile.isCreateCue()) {
+    if (!output.profile.isCreateCue()) {
         return;
     }
 
-    CueCreator cue(mDisc, mProfile.preGapType());
-    cue.writeToFile(mProfile.cueFileName());
+    CueCreator cue(mDisc, output.profile);
+    cue.writeToFile(output.profile.cueFileName());
 }
 
 /************************************************
  *
  ************************************************/
-void DiscPipeline::loadEmbeddedCue()
+void DiscPipeline::loadEmbeddedCue(Output &output) const
 {
-    if (!mProfile.isEmbedCue()) {
+    if (!output.profile.isEmbedCue()) {
         return;
     }
 
-    CueCreator cue(mDisc, mProfile.preGapType());
+    CueCreator cue(mDisc, output.profile);
     QBuffer    buf;
     cue.write(&buf);
-    mEmbeddedCue = QString::fromUtf8(buf.data());
+    output.embeddedCue = QString::fromUtf8(buf.data());
 }
 
 /************************************************
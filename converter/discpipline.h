@@ -28,12 +28,15 @@
 
 #include <QObject>
 #include <QTemporaryDir>
+#include <QHash>
+#include <QSet>
 #include "track.h"
 #include "converter.h"
 #include "convertertypes.h"
 #include "profiles.h"
 #include "coverimage.h"
 #include "replaygain.h"
+#include "cancellationtoken.h"
 
 class Project;
 
@@ -45,11 +48,16 @@ class DiscPipeline : public QObject
 {
     Q_OBJECT
 public:
-    explicit DiscPipeline(const Profile &profile, Disc *disc, ConvTracks tracks, const QString &workDir, QObject *parent = nullptr) noexcept(false);
+    explicit DiscPipeline(const Profiles &profiles, Disc *disc, ConvTracks tracks, const QString &workDir, QObject *parent = nullptr) noexcept(false);
     virtual ~DiscPipeline();
 
     void startWorker(int *splitterCount, int *count);
     void stop();
+
+    // The paused pipeline doesn't start new workers,
+    // the running workers and their programs are suspended.
+    void pause();
+    void resume();
     bool isRunning() const;
     int  runningThreadCount() const;
 
@@ -60,59 +68,113 @@ signals:
     void stopAllThreads();
     void trackProgressChanged(const Conv::ConvTrack &track, TrackState status, Percent percent);
 
+    // The state of the one output file of the track.
+    void outputProgressChanged(const Conv::ConvTrack &track, const Profile &profile, const QString &resultFile, TrackState status, Percent percent);
+    void trackFailed(const Conv::ConvTrack &track, const Profile &profile, const QString &resultFile, const QString &message);
+    void trackStalled(const Conv::ConvTrack &track, const QString &program);
+
 private slots:
     void trackProgress(const Conv::ConvTrack &track, TrackState state, int percent);
-    void trackError(const Conv::ConvTrack &track, const QString &message);
-
-    void trackDone(const Conv::ConvTrack &track, const QString &outFileName);
+    void trackError(const Conv::ConvTrack &track, const QString &message, int output = -1);
 
 private:
-    Profile               mProfile;
     Disc                 *mDisc = nullptr;
     QString               mWorkDir;
     QList<ConvTrack>      mTracks;
     QMap<int, TrackState> mTrackStates;
     QTemporaryDir        *mTmpDir = nullptr;
-    CoverImage            mCoverImage;
-    QString               mEmbeddedCue;
-    ReplayGain::AlbumGain mAlbumGain;
 
     struct SplitterRequest
     {
         ConvTracks tracks;
         QString    outDir;
         PreGapType pregapType;
+        int        attempt = 0;
     };
 
     struct Request
     {
         ConvTrack track;
         QString   inputFile;
+        int       output  = 0;
+        int       attempt = 0;
     };
 
+    // Every profile the disc is converted to is one output.
+    // All outputs share the splitter and the temporary WAV files.
+    struct Output
+    {
+        Profile               profile;
+        CoverImage            coverImage;
+        QString               embeddedCue;
+        ReplayGain::AlbumGain albumGain;
+        QList<Request>        albumGainRequests;
+    };
+
+    QVector<Output>         mOutputs;
+    int                     mGainOutput = -1;
+
+    // Whole image mode, the disc is encoded as one ConvTrack
+    bool                        mWholeImage = false;
+    ConvTrack                   mImageTrack;
+    QVector<ReplayGain::Result> mSegmentGains;
+
+    // FLAC to FLAC without changes, the splitter copies the frames
+    bool mSmartSplit = false;
+
+    // The cover images and CUE files are created once, on the first splitter start
+    bool mOutputsPrepared = false;
+
     QVector<WorkerThread *> mThreads;
-    bool                    mInterrupted = false;
+    bool                    mInterrupted  = false;
+    CancellationToken       mCancel;
+    int                     mRetryCount   = 0;
+    int                     mRetryDelay   = 0;
+    int                     mStallTimeout = 0;
     QList<SplitterRequest>  mSplitterRequests;
     QList<Request>          mEncoderRequests;
-    QList<Request>          mAlbumGainRequests;
+    QList<Request>          mGainRequests;
+
+    QMap<int, ReplayGain::Result> mTrackGains;
+    QMap<int, QVector<int>>       mEncoderPercents;
+    QMap<int, int>                mDoneOutputs;
+    QSet<QPair<int, int>>         mDoneOutputFiles;
+    QHash<QString, int>           mInputFileUsers;
 
     void addSpliterRequest();
     void startSplitter(const SplitterRequest &request);
+    void prepareOutputs(const Conv::ConvTrack &track);
+    void splitterError(const SplitterRequest &request, int splitCount, bool stalled, const Conv::ConvTrack &track, const QString &message);
 
     void addEncoderRequest(const Conv::ConvTrack &track, const QString &inputFile);
-    void startEncoder(const ConvTrack &track, const QString &inputFile);
+    void startEncoder(const Request &request);
+    void smartSplitDone(const Conv::ConvTrack &track, const QString &fileName);
+    void encoderProgress(int output, const Conv::ConvTrack &track, TrackState state, int percent);
+    void encoderDone(const Request &request, const QString &outFileName, const ReplayGain::Result &trackGain);
+    void encoderError(const Request &request, const QString &message);
+    void releaseInputFile(const QString &inputFile);
+
+    void trackEncoded(int output, const Conv::ConvTrack &track, const QString &fileName, const ReplayGain::Result &trackGain);
+    void writeGain(int output, const Conv::ConvTrack &track, const QString &fileName, const ReplayGain::Result &trackGain);
+    void writeImageMetadata(int output, const Conv::ConvTrack &track, const QString &fileName, const ReplayGain::Result &gain);
+    void trackDone(int output, const Conv::ConvTrack &track, const QString &outFileName);
+
+    void setTrackState(const Conv::ConvTrack &track, TrackState state, int percent);
+    void outputProgress(int output, const Conv::ConvTrack &track, TrackState state, int percent);
+    void outputFailed(int output, const Conv::ConvTrack &track, const QString &message);
 
-    void writeGain(const Conv::ConvTrack &track, const QString &fileName, const ReplayGain::Result &trackGain);
+    QString          resultFilePath(const Output &output, const ConvTrack &track) const;
+    QList<ConvTrack> stateTracks(const ConvTrack &track) const;
 
     void interrupt(TrackState state);
 
     void createDir(const QString &dirName) const;
 
-    void copyCoverImage() const;
-    void createEmbedImage();
+    void copyCoverImage(const Output &output) const;
+    void createEmbedImage(int output);
 
-    void writeOutCueFile();
-    void loadEmbeddedCue();
+    void writeOutCueFile(const Output &output) const;
+    void loadEmbeddedCue(Output &output) const;
 
     bool hasPregap() const;
 };
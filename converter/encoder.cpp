@@ -33,6 +33,11 @@
 #include <QDebug>
 #include <QLoggingCategory>
 #include "extprogram.h"
+#include "decoder.h"
+#include "wavheader.h"
+#include "conversioncache.h"
+#include "stallwatchdog.h"
+#include "trace.h"
 #include "formats_out/metadatawriter.h"
 
 namespace {
@@ -66,7 +71,8 @@ QProcess *Encoder::createEncoderProcess()
 
     qCDebug(LOG) << "Start encoder:" << debugProgramArgs(prog, args);
 
-    QProcess *res = new ExtProgram();
+    ExtProgram *res = new ExtProgram();
+    res->setUsageTag(mProfile.name());
     res->setObjectName("encoder");
     res->setProgram(prog);
     res->setArguments(args);
@@ -101,7 +107,8 @@ QProcess *Encoder::createRasmpler(const QString &outFile)
 
     qCDebug(LOG) << "Start resampler:" << debugProgramArgs(prog, args);
 
-    QProcess *res = new ExtProgram();
+    ExtProgram *res = new ExtProgram();
+    res->setUsageTag(mProfile.name());
     res->setObjectName("resampler");
     res->setProgram(prog);
     res->setArguments(args);
@@ -130,7 +137,8 @@ QProcess *Encoder::createDemph(const QString &outFile)
 
     qCDebug(LOG) << "Start deEmphasis:" << debugProgramArgs(prog, args);
 
-    QProcess *res = new ExtProgram();
+    ExtProgram *res = new ExtProgram();
+    res->setUsageTag(mProfile.name());
     res->setObjectName("deemphasis");
     res->setProgram(prog);
     res->setArguments(args);
@@ -142,7 +150,7 @@ QProcess *Encoder::createDemph(const QString &outFile)
  ************************************************/
 void Encoder::run()
 {
-    mReplayGainEnabled = mProfile.gainType() != GainType::Disable;
+    TraceScope trace("Encoder::run", track().trackNum());
 
     emit trackProgress(track(), TrackState::Encoding, 0);
 
@@ -175,9 +183,16 @@ void Encoder::run()
         return;
     }
 
+    QByteArray cacheKey = this->cacheKey();
+
     QObject keeper;
     //------------------------------------------------
     try {
+        if (loadFromCache(cacheKey)) {
+            qDeleteAll(procs);
+            return;
+        }
+
         // We start all processes connected by a pipe
         for (int i = 0; i < procs.count() - 1; ++i) {
             QProcess *proc = procs[i];
@@ -187,36 +202,134 @@ void Encoder::run()
 
         connect(procs.first(), &QProcess::bytesWritten, this, &Encoder::processBytesWritten);
 
-        for (QProcess *proc : procs) {
-            proc->start();
-            proc->waitForStarted();
+        {
+            TraceScope spawn("Encoder::spawn", track().trackNum());
+            for (QProcess *proc : procs) {
+                cancellationToken().attach(proc);
+                proc->start();
+                proc->waitForStarted();
+            }
         }
 
-        readInputFile(procs.first());
+        {
+            TraceScope feed("Encoder::feed", track().trackNum());
+            readInputFile(procs.first());
+        }
 
-        for (QProcess *p : procs) {
-            p->closeWriteChannel();
-            p->waitForFinished(-1);
+        {
+            TraceScope wait("Encoder::wait", track().trackNum());
+            for (QProcess *p : procs) {
+                p->closeWriteChannel();
+                waitForFinished(p);
+            }
         }
 
         for (QProcess *p : procs) {
             if (p->exitCode() != 0) {
-                throw(QString::fromLocal8Bit(p->readAllStandardError()));
+                throw FlaconError(QString::fromLocal8Bit(p->readAllStandardError()));
             }
         }
 
-        deleteFile(mInputFile);
-        writeMetadata();
+        if (!cacheKey.isEmpty()) {
+            ReplayGain::Result gain = mTrackGain.result();
+            ConversionCache::instance()->put(cacheKey, outFile(), mReplayGainEnabled ? &gain : nullptr);
+        }
 
+        deleteInputFile();
+        if (mWriteMetadata) {
+            writeMetadata();
+        }
+
+        if (!mSegmentResults.isEmpty()) {
+            emit segmentGainsReady(track(), mSegmentResults);
+        }
         emit trackReady(track(), outFile(), mTrackGain.result());
     }
+    catch (const CanceledError &) {
+        qCDebug(LOG) << "Encoder canceled" << track().trackNum();
+        for (QProcess *p : procs) {
+            ExtProgram::killGroup(p);
+            p->waitForFinished(CancellationToken::POLL_INTERVAL);
+        }
+    }
+    catch (const StalledError &err) {
+        for (QProcess *p : procs) {
+            ExtProgram::killGroup(p);
+            p->waitForFinished(CancellationToken::POLL_INTERVAL);
+        }
+
+        emit    stalled(track(), err.program());
+        QString msg = tr("Track %1. Encoder error:", "Track error message, %1 is a track number").arg(track().trackNum()) + "<pre>" + err.what() + "</pre>";
+        emit    error(track(), msg);
+    }
     catch (const FlaconError &err) {
-        deleteFile(mInputFile);
+        // The input file is kept for the retry, the pipeline removes the temporary directory.
         QString msg = tr("Track %1. Encoder error:", "Track error message, %1 is a track number").arg(track().trackNum()) + "<pre>" + err.what() + "</pre>";
         emit    error(track(), msg);
     }
 }
 
+/************************************************
+ * The progress is the input consumed by the first
+ * program plus the size of the output file.
+ ************************************************/
+void Encoder::waitForFinished(QProcess *process)
+{
+    static constexpr int CHECK_INTERVAL = 1000;
+
+    StallWatchdog watchdog(process->program(), stallTimeout(), cancellationToken());
+    while (!cancellationToken().waitForFinished(process, CHECK_INTERVAL)) {
+        watchdog.setBytes(mReady + QFileInfo(outFile()).size());
+        watchdog.check();
+    }
+}
+
+/************************************************
+ * The key depends on everything that changes the
+ * encoded audio. The segment gains are not cached.
+ ************************************************/
+QByteArray Encoder::cacheKey()
+{
+    ConversionCache *cache = ConversionCache::instance();
+    if (!cache->isEnabled() || !mGainSegments.isEmpty()) {
+        return QByteArray();
+    }
+
+    const InputAudioFile &audio = mTrack.audioFile();
+
+    int bps  = calcQuality(audio.bitsPerSample(), mProfile.bitsPerSample(), mProfile.outFormat()->maxBitPerSample());
+    int rate = calcQuality(audio.sampleRate(), mProfile.sampleRate(), mProfile.outFormat()->maxSampleRate());
+
+    QByteArray extra = QString("%1:%2:%3").arg(bps).arg(rate).arg(mTrack.preEmphased()).toLatin1();
+    return cache->key(inputFile(), mProfile, programPath(), extra);
+}
+
+/************************************************
+ *
+ ************************************************/
+bool Encoder::loadFromCache(const QByteArray &cacheKey)
+{
+    if (cacheKey.isEmpty()) {
+        return false;
+    }
+
+    ReplayGain::Result gain;
+    if (!ConversionCache::instance()->get(cacheKey, outFile(), mReplayGainEnabled, &gain)) {
+        return false;
+    }
+
+    qCDebug(LOG) << "Track" << track().trackNum() << "is loaded from the cache";
+
+    deleteInputFile();
+    if (mWriteMetadata) {
+        writeMetadata();
+    }
+
+    emit trackProgress(track(), TrackState::Encoding, 100);
+    emit trackReady(track(), outFile(), gain);
+    return true;
+}
+
 /************************************************
  *
  ************************************************/
@@ -227,6 +340,8 @@ void Encoder::writeMetadata() const
         return;
     }
 
+    TraceScope trace("MetadataWriter::save", mTrack.trackNum());
+
     writer->setTags(mTrack);
     if (profile().isEmbedCue()) {
         writer->setEmbeddedCue(embeddedCue());
@@ -266,7 +381,8 @@ void Encoder::processBytesWritten(qint64 bytes)
  ************************************************/
 void Encoder::setProfile(const Profile &profile)
 {
-    mProfile = profile;
+    mProfile           = profile;
+    mReplayGainEnabled = mProfile.gainType() != GainType::Disable;
 }
 
 /************************************************
@@ -291,28 +407,132 @@ void Encoder::readInputFile(QProcess *process)
     mProgress = -1;
     mTotal    = file.size();
 
+    if (mReplayGainEnabled) {
+        initSegmentGains(&file);
+    }
+
     quint64    bufSize = qBound(MIN_BUF_SIZE, mTotal / 200, MAX_BUF_SIZE);
     QByteArray buf;
+    quint64    pos = 0;
 
     while (!file.atEnd()) {
+        cancellationToken().waitIfPaused();
         buf = file.read(bufSize);
         process->write(buf);
         if (mReplayGainEnabled) {
             mTrackGain.add(buf.constData(), buf.size());
+            addSegmentGains(buf, pos);
+        }
+        pos += buf.size();
+    }
+
+    finishSegmentGains();
+}
+
+/************************************************
+ * Each segment gets its own TrackGain, we feed it
+ * with the WAV header resized to the segment.
+ ************************************************/
+void Encoder::initSegmentGains(QFile *file)
+{
+    if (mGainSegments.isEmpty()) {
+        return;
+    }
+
+    WavHeader header;
+    try {
+        header = WavHeader(file);
+        file->seek(0);
+    }
+    catch (const FlaconError &err) {
+        qCWarning(LOG) << "Can't read WAV header, the segments gain is disabled:" << err.what();
+        file->seek(0);
+        return;
+    }
+
+    const quint64 dataStart = header.dataStartPos();
+    const quint64 dataEnd   = header.dataStartPos() + header.dataSize();
+    const quint64 align     = qMax<quint64>(1, header.blockAlign());
+
+    mSegmentBounds.clear();
+    for (const CueTime &time : qAsConst(mGainSegments)) {
+        quint64 offset = Decoder::timeToBytes(time, header);
+        offset -= offset % align;
+        mSegmentBounds << qMin(dataStart + offset, dataEnd);
+    }
+    mSegmentBounds << dataEnd;
+
+    mSegmentGains.clear();
+    for (int i = 0; i < mGainSegments.count(); ++i) {
+        WavHeader segHeader = header;
+        segHeader.resizeData(mSegmentBounds.at(i + 1) - mSegmentBounds.at(i));
+        QByteArray hdr = segHeader.toLegacyWav();
+
+        QSharedPointer<ReplayGain::TrackGain> gain(new ReplayGain::TrackGain());
+        gain->add(hdr.constData(), hdr.size());
+        mSegmentGains << gain;
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void Encoder::addSegmentGains(const QByteArray &buf, quint64 pos)
+{
+    const quint64 end = pos + buf.size();
+
+    for (int i = 0; i < mSegmentGains.count(); ++i) {
+        quint64 s = qMax(mSegmentBounds.at(i), pos);
+        quint64 e = qMin(mSegmentBounds.at(i + 1), end);
+
+        if (s < e) {
+            mSegmentGains[i]->add(buf.constData() + (s - pos), e - s);
         }
     }
 }
 
+/************************************************
+ *
+ ************************************************/
+void Encoder::finishSegmentGains()
+{
+    mSegmentResults.clear();
+    for (const QSharedPointer<ReplayGain::TrackGain> &gain : qAsConst(mSegmentGains)) {
+        mSegmentResults << gain->result();
+    }
+
+    mSegmentGains.clear();
+}
+
 /************************************************
 
  ************************************************/
 void Encoder::copyFile()
 {
     QFile srcFile(inputFile());
-    bool  res = srcFile.rename(outFile());
+
+    if (mKeepInputFile) {
+        if (!srcFile.copy(outFile())) {
+            emit error(track(),
+                       tr("I can't copy file:\n%1 to %2\n%3").arg(inputFile(), outFile(), srcFile.errorString()));
+        }
+        return;
+    }
+
+    bool res = srcFile.rename(outFile());
 
     if (!res) {
         emit error(track(),
                    tr("I can't rename file:\n%1 to %2\n%3").arg(inputFile(), outFile(), srcFile.errorString()));
     }
 }
+
+/************************************************
+
+ ************************************************/
+void Encoder::deleteInputFile() const
+{
+    if (!mKeepInputFile) {
+        deleteFile(mInputFile);
+    }
+}
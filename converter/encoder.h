@@ -27,12 +27,15 @@
 #define ENCODER_H
 
 #include <QProcess>
+#include <QSharedPointer>
 
 #include "worker.h"
 #include "../profiles.h"
 #include "coverimage.h"
 #include "replaygain.h"
 
+class QFile;
+
 namespace Conv {
 
 class Encoder : public Worker
@@ -58,6 +61,23 @@ public:
     const CoverImage &coverImage() const { return mCoverImage; }
     void              setCoverImage(const CoverImage &value);
 
+    // The value is initialized from the profile, call it after setProfile().
+    bool isReplayGainEnabled() const { return mReplayGainEnabled; }
+    void setReplayGainEnabled(bool value) { mReplayGainEnabled = value; }
+
+    // If true, the input file is not deleted and not renamed, so several encoders can share it.
+    bool isKeepInputFile() const { return mKeepInputFile; }
+    void setKeepInputFile(bool value) { mKeepInputFile = value; }
+
+    // If false, the tags, CUE and cover image are not written, the caller writes them itself.
+    bool isWriteMetadata() const { return mWriteMetadata; }
+    void setWriteMetadata(bool value) { mWriteMetadata = value; }
+
+    // The gain is also calculated for each part of the input, the values are the start times of the parts.
+    // The result is reported with the segmentGainsReady signal.
+    QVector<CueTime> gainSegments() const { return mGainSegments; }
+    void             setGainSegments(const QVector<CueTime> &value) { mGainSegments = value; }
+
     virtual QString     programName() const { return ""; }
     virtual QStringList programArgs() const = 0;
 
@@ -66,6 +86,7 @@ public slots:
 
 signals:
     void trackReady(const Conv::ConvTrack &track, const QString &outFileName, const ReplayGain::Result &trackGain);
+    void segmentGainsReady(const Conv::ConvTrack &track, const QVector<ReplayGain::Result> &gains);
 
 protected:
     QString programPath() const;
@@ -83,14 +104,29 @@ private:
     CoverImage mCoverImage;
 
     bool                  mReplayGainEnabled = false;
+    bool                  mKeepInputFile     = false;
+    bool                  mWriteMetadata     = true;
     ReplayGain::TrackGain mTrackGain;
 
+    QVector<CueTime>                               mGainSegments;
+    QVector<quint64>                               mSegmentBounds;
+    QVector<QSharedPointer<ReplayGain::TrackGain>> mSegmentGains;
+    QVector<ReplayGain::Result>                    mSegmentResults;
+
     quint64 mTotal    = 0;
     quint64 mReady    = 0;
     int     mProgress = 0;
 
     void readInputFile(QProcess *process);
+    void waitForFinished(QProcess *process);
+    void initSegmentGains(QFile *file);
+    void addSegmentGains(const QByteArray &buf, quint64 pos);
+    void finishSegmentGains();
     void copyFile();
+    void deleteInputFile() const;
+
+    QByteArray cacheKey();
+    bool       loadFromCache(const QByteArray &cacheKey);
 
     QProcess *createEncoderProcess();
     QProcess *createRasmpler(const QString &outFile);
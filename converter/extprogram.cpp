@@ -27,19 +27,263 @@
 #include <QDebug>
 #include "../types.h"
 #include <QLoggingCategory>
+#include <QFileInfo>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#endif
 
 namespace {
 Q_LOGGING_CATEGORY(LOG, "ExtProgram")
 }
 
+#ifdef Q_OS_UNIX
+namespace {
+
+struct UsageReport
+{
+    struct rusage usage;
+    qint64        wallTime;
+};
+
+// The QProcess reaps its children itself, so we can't call wait4()
+// for them. Instead the forked child forks once more; the grandchild
+// execs the program, and the child waits for it, writes the rusage
+// to the pipe and exits with the same status. The program inherits
+// the stdio and the process group, so the pipelines, kill and
+// SIGSTOP work as before.
+//
+// Only async-signal-safe functions are allowed here.
+pid_t usageShimChild = 0;
+
+void forwardSignal(int sig)
+{
+    ::kill(usageShimChild, sig);
+}
+
+void runUsageShim(int reportFd)
+{
+    struct timespec start;
+    ::clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pid_t pid = ::fork();
+    if (pid <= 0) {
+        // The grandchild, or fork failed: run the program without accounting
+        ::close(reportFd);
+        return;
+    }
+
+    usageShimChild = pid;
+    struct sigaction sa;
+    ::memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = forwardSignal;
+    ::sigaction(SIGTERM, &sa, nullptr);
+    ::sigaction(SIGINT, &sa, nullptr);
+    ::sigaction(SIGHUP, &sa, nullptr);
+
+    // Release the pipes of the QProcess, the parent should
+    // see EOF and the exit when the program finishes.
+    ::dup2(reportFd, 3);
+    ::close(0);
+    ::close(1);
+    ::close(2);
+#ifdef SYS_close_range
+    if (::syscall(SYS_close_range, 4, ~0U, 0) != 0)
+#endif
+    {
+        long max = qMin(::sysconf(_SC_OPEN_MAX), 4096L);
+        for (int fd = 4; fd < max; ++fd) {
+            ::close(fd);
+        }
+    }
+
+    int           status = 0;
+    UsageReport   report;
+    ::memset(&report, 0, sizeof(report));
+    while (::wait4(pid, &status, 0, &report.usage) < 0) {
+        if (errno != EINTR) {
+            ::_exit(255);
+        }
+    }
+
+    struct timespec end;
+    ::clock_gettime(CLOCK_MONOTONIC, &end);
+    report.wallTime = (end.tv_sec - start.tv_sec) * 1000000LL + (end.tv_nsec - start.tv_nsec) / 1000;
+    ssize_t n       = ::write(3, &report, sizeof(report));
+    Q_UNUSED(n)
+
+    if (WIFSIGNALED(status)) {
+        ::signal(WTERMSIG(status), SIG_DFL);
+        ::kill(::getpid(), WTERMSIG(status));
+    }
+    ::_exit(WIFEXITED(status) ? WEXITSTATUS(status) : 255);
+}
+
+} // namespace
+#endif
+
+/************************************************
+ *
+ ************************************************/
 ExtProgram::ExtProgram(QObject *parent) :
     QProcess(parent)
 {
     connect(this, &QProcess::errorOccurred, this, &ExtProgram::handleError);
+
+#ifdef Q_OS_UNIX
+    // The Starting state is set before the fork
+    connect(this, &QProcess::stateChanged, this, [this](QProcess::ProcessState state) {
+        if (state == QProcess::Starting) {
+            openUsagePipe();
+        }
+    });
+    connect(this, &QProcess::started, this, [this]() { closeUsagePipe(1); });
+    connect(this, qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this, &ExtProgram::readUsage);
+#endif
+}
+
+/************************************************
+ *
+ ************************************************/
+ExtProgram::~ExtProgram()
+{
+    // The QProcess destructor kills only the group leader
+    if (state() != QProcess::NotRunning) {
+        killGroup(this);
+        waitForFinished();
+    }
+    closeUsagePipe(0);
+    closeUsagePipe(1);
+}
+
+#ifdef Q_OS_UNIX
+/************************************************
+ *
+ ************************************************/
+void ExtProgram::setupChildProcess()
+{
+    ::setpgid(0, 0);
+    if (mUsagePipe[1] > -1) {
+        runUsageShim(mUsagePipe[1]);
+    }
+}
+#endif
+
+/************************************************
+ *
+ ************************************************/
+void ExtProgram::openUsagePipe()
+{
+#ifdef Q_OS_UNIX
+    closeUsagePipe(0);
+    closeUsagePipe(1);
+    mUsage = Conv::ProcessUsage();
+
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        qCWarning(LOG) << "Can't create the usage pipe:" << strerror(errno);
+        return;
+    }
+
+    // The read end shouldn't leak into the other programs,
+    // the write end is closed by the shim.
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    mUsagePipe[0] = fds[0];
+    mUsagePipe[1] = fds[1];
+#endif
+}
+
+/************************************************
+ *
+ ************************************************/
+void ExtProgram::closeUsagePipe(int end)
+{
+#ifdef Q_OS_UNIX
+    if (mUsagePipe[end] > -1) {
+        ::close(mUsagePipe[end]);
+        mUsagePipe[end] = -1;
+    }
+#else
+    Q_UNUSED(end)
+#endif
+}
+
+/************************************************
+ *
+ ************************************************/
+void ExtProgram::readUsage()
+{
+#ifdef Q_OS_UNIX
+    closeUsagePipe(1);
+    if (mUsagePipe[0] < 0) {
+        return;
+    }
+
+    UsageReport report;
+    ssize_t     n = ::read(mUsagePipe[0], &report, sizeof(report));
+    closeUsagePipe(0);
+
+    if (n != ssize_t(sizeof(report))) {
+        qCDebug(LOG) << "No resource usage for" << program();
+        return;
+    }
+
+    mUsage.count               = 1;
+    mUsage.userTime            = report.usage.ru_utime.tv_sec * 1000000LL + report.usage.ru_utime.tv_usec;
+    mUsage.systemTime          = report.usage.ru_stime.tv_sec * 1000000LL + report.usage.ru_stime.tv_usec;
+    mUsage.wallTime            = report.wallTime;
+#ifdef Q_OS_MACOS
+    mUsage.maxRss = report.usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    mUsage.maxRss = report.usage.ru_maxrss;
+#endif
+    mUsage.inBlocks            = report.usage.ru_inblock;
+    mUsage.outBlocks           = report.usage.ru_oublock;
+    mUsage.voluntarySwitches   = report.usage.ru_nvcsw;
+    mUsage.involuntarySwitches = report.usage.ru_nivcsw;
+
+    Conv::ProcessUsageStatistic::instance()->add(QFileInfo(program()).fileName(), mUsageTag, mUsage);
+#endif
+}
+
+void ExtProgram::killGroup(QProcess *process)
+{
+    if (process->state() == QProcess::NotRunning) {
+        return;
+    }
+
+    ExtProgram *ext = dynamic_cast<ExtProgram *>(process);
+    if (ext) {
+        ext->mKilled = true;
+    }
+
+#ifdef Q_OS_UNIX
+    if (ext && process->processId() > 0) {
+        ::kill(-pid_t(process->processId()), SIGKILL);
+        return;
+    }
+#endif
+
+    process->kill();
 }
 
 void ExtProgram::handleError(QProcess::ProcessError error)
 {
+    if (mKilled) {
+        qCDebug(LOG) << "The" << program() << "program was killed";
+        return;
+    }
+
     qCWarning(LOG) << "ERROR";
     qCWarning(LOG) << QString("%1: The '%2' program crashes").arg(objectName()).arg(program());
     qCWarning(LOG) << "Program with args:" << debugProgramArgs(program(), arguments());
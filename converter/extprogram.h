@@ -26,14 +26,41 @@
  * END_COMMON_COPYRIGHT_HEADER */
 
 #include <QProcess>
+#include "processusage.h"
 
 class ExtProgram : public QProcess
 {
 public:
     ExtProgram(QObject *parent = nullptr);
+    ~ExtProgram() override;
+
+    // On Unix every program runs in its own process group,
+    // so the shell pipelines are killed with all children.
+    static void killGroup(QProcess *process);
+
+    // The resources of the finished program are added
+    // to the ProcessUsageStatistic under this tag.
+    QString usageTag() const { return mUsageTag; }
+    void    setUsageTag(const QString &value) { mUsageTag = value; }
+
+    // Valid after the program finished.
+    const Conv::ProcessUsage &usage() const { return mUsage; }
+
+protected:
+#ifdef Q_OS_UNIX
+    void setupChildProcess() override;
+#endif
 
 private:
+    bool               mKilled      = false;
+    int                mUsagePipe[2] = { -1, -1 };
+    QString            mUsageTag;
+    Conv::ProcessUsage mUsage;
+
     void handleError(QProcess::ProcessError error);
+    void openUsagePipe();
+    void readUsage();
+    void closeUsagePipe(int end);
 };
 
 #endif // EXTPROGRAM_H
@@ -0,0 +1,828 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "flacsplitter.h"
+#include "disc.h"
+#include "settings.h"
+#include "inputaudiofile.h"
+#include "formats_in/informat.h"
+#include "stallwatchdog.h"
+#include "trace.h"
+#include "extprogram.h"
+
+#include <QFile>
+#include <QProcess>
+#include <QLoggingCategory>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "FlacSplitter")
+}
+
+using namespace Conv;
+
+// The FLAC format doesn't allow blocks shorter than 16 samples, except the last one.
+static constexpr quint64 MIN_BLOCK_SIZE = 16;
+static constexpr quint64 MAX_BLOCK_SIZE = 65535;
+
+// Blocks longer than 4608 samples are out of the FLAC subset.
+static constexpr quint64 MAX_SUBSET_BLOCK_SIZE = 4608;
+
+/************************************************
+ *
+ ************************************************/
+static std::array<quint8, 256> makeCrc8Table()
+{
+    std::array<quint8, 256> res;
+    for (int i = 0; i < 256; ++i) {
+        quint8 crc = quint8(i);
+        for (int b = 0; b < 8; ++b) {
+            crc = (crc & 0x80) ? quint8((crc << 1) ^ 0x07) : quint8(crc << 1);
+        }
+        res[i] = crc;
+    }
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+static std::array<quint16, 256> makeCrc16Table()
+{
+    std::array<quint16, 256> res;
+    for (int i = 0; i < 256; ++i) {
+        quint16 crc = quint16(i << 8);
+        for (int b = 0; b < 8; ++b) {
+            crc = (crc & 0x8000) ? quint16((crc << 1) ^ 0x8005) : quint16(crc << 1);
+        }
+        res[i] = crc;
+    }
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+static quint8 crc8(const uchar *data, qint64 size)
+{
+    static const std::array<quint8, 256> table = makeCrc8Table();
+
+    quint8 crc = 0;
+    for (qint64 i = 0; i < size; ++i) {
+        crc = table[crc ^ data[i]];
+    }
+    return crc;
+}
+
+/************************************************
+ *
+ ************************************************/
+static quint16 crc16(quint16 crc, const uchar *data, qint64 size)
+{
+    static const std::array<quint16, 256> table = makeCrc16Table();
+
+    for (qint64 i = 0; i < size; ++i) {
+        crc = quint16((crc << 8) ^ table[(crc >> 8) ^ data[i]]);
+    }
+    return crc;
+}
+
+/************************************************
+ * The CRC-16 of the frame [pos, end) without
+ * the footer matches the footer.
+ ************************************************/
+static bool checkFrameCrc(const uchar *data, qint64 pos, qint64 end, int headerSize)
+{
+    if (end - pos < headerSize + 2) {
+        return false;
+    }
+
+    const quint16 footer = quint16((data[end - 2] << 8) | data[end - 1]);
+    return crc16(0, data + pos, end - pos - 2) == footer;
+}
+
+/************************************************
+ * The frame/sample number is coded like UTF-8,
+ * up to 36 bits in 7 bytes.
+ ************************************************/
+static QByteArray encodeNumber(quint64 value)
+{
+    QByteArray res;
+
+    if (value < 0x80) {
+        res.append(char(value));
+        return res;
+    }
+
+    int n = 2;
+    while (n < 7 && value >= (quint64(1) << (5 * n + 1))) {
+        ++n;
+    }
+
+    uchar first = (n == 7) ? 0xFE : uchar((0xFF00 >> n) & 0xFF);
+    res.append(char(first | uchar(value >> (6 * (n - 1)))));
+
+    for (int i = n - 2; i >= 0; --i) {
+        res.append(char(0x80 | ((value >> (6 * i)) & 0x3F)));
+    }
+
+    return res;
+}
+
+/************************************************
+ * Returns false if there is no valid frame
+ * header at the pos.
+ ************************************************/
+static bool readFrameHeader(const uchar *data, qint64 size, qint64 pos, FlacSplitter::Frame *frame, quint64 *number, bool *variable)
+{
+    const uchar *d     = data + pos;
+    const qint64 avail = size - pos;
+
+    if (avail < 6) {
+        return false;
+    }
+
+    if (d[0] != 0xFF || (d[1] & 0xFE) != 0xF8) {
+        return false;
+    }
+
+    const int bsCode = d[2] >> 4;
+    const int srCode = d[2] & 0x0F;
+    const int chCode = d[3] >> 4;
+    const int ssCode = (d[3] >> 1) & 0x07;
+
+    if (bsCode == 0 || srCode == 0x0F || chCode > 10 || ssCode == 3 || (d[3] & 0x01)) {
+        return false;
+    }
+
+    // Coded number ............................
+    qint64  p = 4;
+    uchar   x = d[p];
+    int     n = 0;
+    quint64 v = 0;
+
+    // clang-format off
+    if      ((x & 0x80) == 0x00) { n = 1; v = x;        }
+    else if ((x & 0xE0) == 0xC0) { n = 2; v = x & 0x1F; }
+    else if ((x & 0xF0) == 0xE0) { n = 3; v = x & 0x0F; }
+    else if ((x & 0xF8) == 0xF0) { n = 4; v = x & 0x07; }
+    else if ((x & 0xFC) == 0xF8) { n = 5; v = x & 0x03; }
+    else if ((x & 0xFE) == 0xFC) { n = 6; v = x & 0x01; }
+    else if (x == 0xFE)          { n = 7; v = 0;        }
+    else return false;
+    // clang-format on
+
+    if (p + n > avail) {
+        return false;
+    }
+
+    for (int i = 1; i < n; ++i) {
+        uchar c = d[p + i];
+        if ((c & 0xC0) != 0x80) {
+            return false;
+        }
+        v = (v << 6) | (c & 0x3F);
+    }
+
+    frame->numberPos = int(p);
+    p += n;
+    frame->numberEnd = int(p);
+
+    // Block size ..............................
+    if (p + 2 > avail) {
+        return false;
+    }
+
+    switch (bsCode) {
+        case 1:
+            frame->blockSize = 192;
+            break;
+
+        case 2:
+        case 3:
+        case 4:
+        case 5:
+            frame->blockSize = 576 << (bsCode - 2);
+            break;
+
+        case 6:
+            frame->blockSize = d[p] + 1;
+            p += 1;
+            break;
+
+        case 7:
+            frame->blockSize = ((d[p] << 8) | d[p + 1]) + 1;
+            p += 2;
+            break;
+
+        default:
+            frame->blockSize = 256 << (bsCode - 8);
+    }
+
+    // Sample rate .............................
+    if (srCode == 12) {
+        p += 1;
+    }
+    else if (srCode == 13 || srCode == 14) {
+        p += 2;
+    }
+
+    if (p + 1 > avail) {
+        return false;
+    }
+
+    if (crc8(d, p) != d[p]) {
+        return false;
+    }
+
+    frame->headerSize = int(p + 1);
+    frame->offset     = pos;
+    *number           = v;
+    *variable         = d[1] & 0x01;
+    return true;
+}
+
+/************************************************
+ *
+ ************************************************/
+QByteArray FlacSplitter::StreamInfo::toByteArray() const
+{
+    QByteArray res(34, '\0'); // The MD5 is zero, this means "unknown"
+    uchar     *d = reinterpret_cast<uchar *>(res.data());
+
+    d[0]  = uchar(minBlockSize >> 8);
+    d[1]  = uchar(minBlockSize);
+    d[2]  = uchar(maxBlockSize >> 8);
+    d[3]  = uchar(maxBlockSize);
+    d[4]  = uchar(minFrameSize >> 16);
+    d[5]  = uchar(minFrameSize >> 8);
+    d[6]  = uchar(minFrameSize);
+    d[7]  = uchar(maxFrameSize >> 16);
+    d[8]  = uchar(maxFrameSize >> 8);
+    d[9]  = uchar(maxFrameSize);
+    d[10] = uchar(sampleRate >> 12);
+    d[11] = uchar(sampleRate >> 4);
+    d[12] = uchar(((sampleRate & 0x0F) << 4) | ((channels - 1) << 1) | ((bitsPerSample - 1) >> 4));
+    d[13] = uchar((((bitsPerSample - 1) & 0x0F) << 4) | ((totalSamples >> 32) & 0x0F));
+    d[14] = uchar(totalSamples >> 24);
+    d[15] = uchar(totalSamples >> 16);
+    d[16] = uchar(totalSamples >> 8);
+    d[17] = uchar(totalSamples);
+
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+FlacSplitter::StreamInfo FlacSplitter::readStreamInfo(const uchar *data, qint64 size, qint64 *firstFramePos) noexcept(false)
+{
+    if (size < 42 || memcmp(data, "fLaC", 4) != 0) {
+        throw FlaconError("Incorrect FLAC file, the file signature is not found");
+    }
+
+    StreamInfo res;
+    bool       found = false;
+    bool       last  = false;
+    qint64     pos   = 4;
+
+    while (!last) {
+        if (pos + 4 > size) {
+            throw FlaconError("Incorrect FLAC file, the metadata is truncated");
+        }
+
+        last           = data[pos] & 0x80;
+        const int type = data[pos] & 0x7F;
+        const int len  = (data[pos + 1] << 16) | (data[pos + 2] << 8) | data[pos + 3];
+        pos += 4;
+
+        if (pos + len > size) {
+            throw FlaconError("Incorrect FLAC file, the metadata is truncated");
+        }
+
+        if (type == 0 && len >= 34) {
+            const uchar *d    = data + pos;
+            res.minBlockSize  = quint16((d[0] << 8) | d[1]);
+            res.maxBlockSize  = quint16((d[2] << 8) | d[3]);
+            res.minFrameSize  = quint32((d[4] << 16) | (d[5] << 8) | d[6]);
+            res.maxFrameSize  = quint32((d[7] << 16) | (d[8] << 8) | d[9]);
+            res.sampleRate    = quint32((d[10] << 12) | (d[11] << 4) | (d[12] >> 4));
+            res.channels      = quint8(((d[12] >> 1) & 0x07) + 1);
+            res.bitsPerSample = quint8((((d[12] & 0x01) << 4) | (d[13] >> 4)) + 1);
+            res.totalSamples  = (quint64(d[13] & 0x0F) << 32) | (quint64(d[14]) << 24) | (d[15] << 16) | (d[16] << 8) | d[17];
+            found             = true;
+        }
+
+        pos += len;
+    }
+
+    if (!found) {
+        throw FlaconError("Incorrect FLAC file, the STREAMINFO block is not found");
+    }
+
+    *firstFramePos = pos;
+    return res;
+}
+
+/************************************************
+ * We don't decode the frames, the frame ends where
+ * the next valid header with the expected number
+ * starts and the CRC-16 of the frame matches, so
+ * the false sync inside the frame data is skipped.
+ * The trailing data (ID3v1 or APE tags, padding)
+ * breaks the CRC of the last frame, such frame is
+ * marked as not verified and is encoded again.
+ ************************************************/
+FlacSplitter::Frames FlacSplitter::readFrames(const uchar *data, qint64 size, qint64 firstFramePos, const StreamInfo &streamInfo) noexcept(false)
+{
+    Frames  res;
+    qint64  pos      = firstFramePos;
+    quint64 expected = 0;
+
+    auto isFrameStart = [&](qint64 p, quint64 sample, int frameNum) {
+        Frame   f;
+        quint64 number;
+        bool    variable;
+        if (!readFrameHeader(data, size, p, &f, &number, &variable)) {
+            return false;
+        }
+        return variable ? (number == sample) : (number == quint64(frameNum));
+    };
+
+    while (pos < size) {
+        Frame   frame;
+        quint64 number;
+        bool    variable;
+
+        if (!readFrameHeader(data, size, pos, &frame, &number, &variable)) {
+            throw FlaconError(QString("Incorrect FLAC frame at %1").arg(pos));
+        }
+
+        if (variable ? (number != expected) : (number != quint64(res.count()))) {
+            throw FlaconError(QString("Unexpected FLAC frame number at %1").arg(pos));
+        }
+
+        frame.firstSample  = expected;
+        const quint64 next = expected + frame.blockSize;
+
+        // Search the next frame ...............
+        qint64 end = size;
+        if (streamInfo.totalSamples == 0 || next < streamInfo.totalSamples) {
+            qint64 p = pos + frame.headerSize;
+            while (p < size) {
+                const void *found = memchr(data + p, 0xFF, size - p);
+                if (!found) {
+                    break;
+                }
+
+                p = static_cast<const uchar *>(found) - data;
+                if (isFrameStart(p, next, res.count() + 1) && checkFrameCrc(data, pos, p, frame.headerSize)) {
+                    end = p;
+                    break;
+                }
+                ++p;
+            }
+        }
+
+        if (end == size && !checkFrameCrc(data, pos, end, frame.headerSize)) {
+            if (streamInfo.totalSamples == 0 || next < streamInfo.totalSamples) {
+                throw FlaconError(QString("Incorrect FLAC frame at %1, the CRC doesn't match").arg(pos));
+            }
+
+            qCDebug(LOG) << "The last frame at" << pos << "is followed by the unknown data";
+            frame.verified = false;
+        }
+
+        frame.size = end - pos;
+        res << frame;
+
+        expected = next;
+        pos      = end;
+
+        if (streamInfo.totalSamples && expected >= streamInfo.totalSamples) {
+            break;
+        }
+    }
+
+    if (res.isEmpty()) {
+        throw FlaconError("Incorrect FLAC file, no audio frames");
+    }
+
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+FlacSplitter::FlacSplitter(Disc *disk, const ConvTracks &tracks, const QString &outDir, QObject *parent) :
+    Worker(parent),
+    mDisc(disk),
+    mTracks(tracks),
+    mOutDir(outDir)
+{
+}
+
+/************************************************
+ * The copied frames are bit-exact, so we can use
+ * this only if the audio is not changed.
+ ************************************************/
+bool FlacSplitter::canSplit(const Disc *disc, const Profile &profile)
+{
+    if (profile.formatId() != "FLAC" || !profile.value("SmartSplit", false).toBool()) {
+        return false;
+    }
+
+    // We need the decoded audio for the gain
+    if (profile.gainType() != GainType::Disable) {
+        return false;
+    }
+
+    if (disc->audioFiles().count() != 1) {
+        return false;
+    }
+
+    const InputAudioFile &audio = disc->audioFiles().first();
+    if (!audio.format() || audio.format()->name() != "FLAC") {
+        return false;
+    }
+
+    if (calcQuality(audio.bitsPerSample(), profile.bitsPerSample(), profile.outFormat()->maxBitPerSample()) != audio.bitsPerSample()) {
+        return false;
+    }
+
+    if (calcQuality(audio.sampleRate(), profile.sampleRate(), profile.outFormat()->maxSampleRate()) != audio.sampleRate()) {
+        return false;
+    }
+
+    for (int i = 0; i < disc->count(); ++i) {
+        if (disc->track(i)->preEmphased()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/************************************************
+ *
+ ************************************************/
+quint64 FlacSplitter::timeToSample(const CueTime &time) const
+{
+    if (mDisc->audioFiles().first().isCdQuality()) {
+        return quint64(time.frames()) * 44100 / 75;
+    }
+
+    return quint64(time.milliseconds()) * mStreamInfo.sampleRate / 1000;
+}
+
+/************************************************
+ *
+ ************************************************/
+void FlacSplitter::run()
+{
+    static QAtomicInteger<quint32> globalUid(1);
+    QString                        uid = QString("%1").arg(globalUid.fetchAndAddRelaxed(1), 4, 10, QLatin1Char('0'));
+
+    mInputFile = mDisc->audioFiles().first().filePath();
+
+    QFile file(mInputFile);
+    if (!file.open(QFile::ReadOnly)) {
+        emit error(mTracks.first(), tr("I can't read <b>%1</b>:<br>%2", "Splitter error. %1 is a file name, %2 is a system error text.").arg(mInputFile, file.errorString()));
+        return;
+    }
+
+    mData = file.map(0, file.size());
+    if (!mData) {
+        emit error(mTracks.first(), tr("I can't read <b>%1</b>:<br>%2", "Splitter error. %1 is a file name, %2 is a system error text.").arg(mInputFile, file.errorString()));
+        return;
+    }
+
+    try {
+        qint64 firstFramePos = 0;
+        mStreamInfo          = readStreamInfo(mData, file.size(), &firstFramePos);
+        mFrames              = readFrames(mData, file.size(), firstFramePos, mStreamInfo);
+
+        if (mStreamInfo.totalSamples == 0) {
+            mStreamInfo.totalSamples = mFrames.last().firstSample + mFrames.last().blockSize;
+        }
+
+        qCDebug(LOG) << "Input file" << mInputFile << "frames:" << mFrames.count() << "samples:" << mStreamInfo.totalSamples;
+    }
+    catch (const FlaconError &err) {
+        qCWarning(LOG) << "Can't read FLAC frames:" << err.what();
+        emit error(mTracks.first(), tr("I can't read <b>%1</b>:<br>%2", "Splitter error. %1 is a file name, %2 is a system error text.").arg(mInputFile, err.what()));
+        return;
+    }
+
+    // ******************************************
+    // Create ranges, the same as the Splitter does
+    QList<Range> ranges;
+    for (const ConvTrack &track : mTracks) {
+        Range range;
+        range.track = track;
+
+        if (track.isPregap()) {
+            range.start       = 0;
+            range.end         = timeToSample(mDisc->track(0)->cueIndex(1));
+            range.outFileName = QString("%1/pregap-%2.flac").arg(mOutDir, uid);
+            ranges << range;
+            continue;
+        }
+
+        const Track *cur  = mDisc->track(track.index());
+        const Track *next = (track.index() + 1 < mDisc->count()) ? mDisc->track(track.index() + 1) : nullptr;
+
+        bool addPregap    = (track.index() == 0 && mPregapType == PreGapType::AddToFirstTrack);
+        range.start       = addPregap ? 0 : timeToSample(cur->cueIndex(1));
+        range.end         = next ? timeToSample(next->cueIndex(1)) : mStreamInfo.totalSamples;
+        range.outFileName = QString("%1/track-%2_%3.flac").arg(mOutDir, uid).arg(track.trackNum(), 2, 10, QLatin1Char('0'));
+        ranges << range;
+    }
+
+    // ******************************************
+    for (const Range &range : ranges) {
+        try {
+            processTrack(range);
+            qCDebug(LOG) << "FlacSplitter trackReady:" << range.track << range.outFileName;
+            emit trackReady(range.track, range.outFileName);
+        }
+        catch (const CanceledError &) {
+            qCDebug(LOG) << "FlacSplitter canceled";
+            deleteFile(range.outFileName);
+            file.unmap(const_cast<uchar *>(mData));
+            return;
+        }
+        catch (const StalledError &err) {
+            qCWarning(LOG) << "FlacSplitter error for track " << range.track.trackNum() << ": " << err.what();
+            emit stalled(range.track, err.program());
+            emit error(range.track, err.what());
+            deleteFile(range.outFileName);
+            file.unmap(const_cast<uchar *>(mData));
+            return;
+        }
+        catch (const FlaconError &err) {
+            qCWarning(LOG) << "FlacSplitter error for track " << range.track.trackNum() << ": " << err.what();
+            emit error(range.track, err.what());
+            deleteFile(range.outFileName);
+            file.unmap(const_cast<uchar *>(mData));
+            return;
+        }
+    }
+
+    file.unmap(const_cast<uchar *>(mData));
+    mData = nullptr;
+}
+
+/************************************************
+ *
+ ************************************************/
+void FlacSplitter::processTrack(const Range &range)
+{
+    TraceScope trace("FlacSplitter::processTrack", range.track.trackNum());
+    emit trackProgress(range.track, TrackState::Splitting, 0);
+
+    if (range.end <= range.start || range.end > mStreamInfo.totalSamples) {
+        throw FlaconError(QString("Incorrect track range %1-%2").arg(range.start).arg(range.end));
+    }
+
+    QFile out(range.outFileName);
+    if (!out.open(QFile::WriteOnly)) {
+        throw FlaconError(out.errorString());
+    }
+
+    StreamInfo info   = mStreamInfo;
+    info.minBlockSize = 0xFFFF;
+    info.maxBlockSize = 0;
+    info.minFrameSize = 0xFFFFFF;
+    info.maxFrameSize = 0;
+    info.totalSamples = 0;
+
+    // A full disk must not produce a truncated file that looks fine
+    auto write = [&out](const char *data, qint64 size) {
+        if (out.write(data, size) != size) {
+            throw FlaconError(out.errorString());
+        }
+    };
+
+    const char metadataHeader[] = { char(0x80), 0, 0, 34 }; // Last block, STREAMINFO, 34 bytes
+    write("fLaC", 4);
+    write(metadataHeader, sizeof(metadataHeader));
+    write(info.toByteArray().constData(), 34);
+
+    // All frames get the variable block size header with the sample number,
+    // the boundary frames have another size than the copied ones.
+    auto writeFrame = [&](const uchar *src, const Frame &f) {
+        QByteArray hdr;
+        hdr.append(char(0xFF));
+        hdr.append(char(0xF9));
+        hdr.append(char(src[2]));
+        hdr.append(char(src[3]));
+        hdr.append(encodeNumber(info.totalSamples));
+        hdr.append(reinterpret_cast<const char *>(src + f.numberEnd), f.headerSize - 1 - f.numberEnd);
+        hdr.append(char(crc8(reinterpret_cast<const uchar *>(hdr.constData()), hdr.size())));
+
+        const uchar *body     = src + f.headerSize;
+        const qint64 bodySize = f.size - f.headerSize - 2;
+
+        quint16 crc = crc16(0, reinterpret_cast<const uchar *>(hdr.constData()), hdr.size());
+        crc         = crc16(crc, body, bodySize);
+
+        const char footer[] = { char(crc >> 8), char(crc & 0xFF) };
+
+        write(hdr.constData(), hdr.size());
+        write(reinterpret_cast<const char *>(body), bodySize);
+        write(footer, sizeof(footer));
+
+        const quint32 frameSize = quint32(hdr.size() + bodySize + 2);
+        info.minFrameSize       = qMin(info.minFrameSize, frameSize);
+        info.maxFrameSize       = qMax(info.maxFrameSize, frameSize);
+        info.minBlockSize       = quint16(qMin<quint32>(info.minBlockSize, f.blockSize));
+        info.maxBlockSize       = quint16(qMax<quint32>(info.maxBlockSize, f.blockSize));
+        info.totalSamples += f.blockSize;
+    };
+
+    auto frameEnd = [this](int i) { return mFrames.at(i).firstSample + mFrames.at(i).blockSize; };
+
+    // The frame contains range.start
+    auto it = std::upper_bound(mFrames.constBegin(), mFrames.constEnd(), range.start,
+                               [](quint64 sample, const Frame &f) { return sample < f.firstSample; });
+    int  i  = int(it - mFrames.constBegin()) - 1;
+
+    quint64 pos      = range.start;
+    int     progress = 0;
+    int     copied   = 0;
+    int     encoded  = 0;
+
+    while (pos < range.end) {
+        cancellationToken().waitIfPaused();
+
+        if (i < 0 || i >= mFrames.count()) {
+            throw FlaconError(QString("Sample %1 is out of the audio stream").arg(pos));
+        }
+
+        const Frame &f = mFrames.at(i);
+
+        if (f.verified && f.firstSample == pos && frameEnd(i) <= range.end) {
+            writeFrame(mData + f.offset, f);
+            pos = frameEnd(i);
+            ++i;
+            ++copied;
+        }
+        else {
+            // The boundary frame, decode and encode it again
+            int     j   = i;
+            quint64 end = qMin(frameEnd(j), range.end);
+            while (end - pos < MIN_BLOCK_SIZE && end < range.end && j + 1 < mFrames.count()) {
+                ++j;
+                end = qMin(frameEnd(j), range.end);
+            }
+
+            QByteArray buf;
+            Frames     frames = encodeSamples(pos, end, &buf);
+            for (const Frame &ef : qAsConst(frames)) {
+                writeFrame(reinterpret_cast<const uchar *>(buf.constData()) + ef.offset, ef);
+            }
+
+            pos = end;
+            i   = j + 1;
+            ++encoded;
+        }
+
+        int p = int((pos - range.start) * 100 / (range.end - range.start));
+        if (p != progress) {
+            progress = p;
+            emit trackProgress(range.track, TrackState::Splitting, progress);
+        }
+    }
+
+    // Update STREAMINFO .......................
+    if (!out.seek(4 + sizeof(metadataHeader))) {
+        throw FlaconError(out.errorString());
+    }
+    write(info.toByteArray().constData(), 34);
+    if (!out.flush()) {
+        throw FlaconError(out.errorString());
+    }
+    out.close();
+
+    qCDebug(LOG) << "Track" << range.track.trackNum() << "copied frames:" << copied << "encoded ranges:" << encoded;
+}
+
+/************************************************
+ * Decode the samples [start, end) and encode them
+ * as one FLAC frame.
+ ************************************************/
+FlacSplitter::Frames FlacSplitter::encodeSamples(quint64 start, quint64 end, QByteArray *buf) const
+{
+    QString program = Settings::i()->programName("flac");
+    if (program.isEmpty()) {
+        throw FlaconError(tr("The %1 program is not installed.<br>Verify that all required programs are installed and in your preferences.",
+                             "Error message. %1 - is an program name")
+                                  .arg("flac"));
+    }
+
+    const quint64 len = end - start;
+
+    QStringList decArgs;
+    decArgs << "-d";
+    decArgs << "-c";
+    decArgs << "-s";
+    decArgs << QString("--skip=%1").arg(start);
+    decArgs << QString("--until=%1").arg(end);
+    decArgs << mInputFile;
+
+    QStringList encArgs;
+    encArgs << "-s";
+    encArgs << "-c";
+    encArgs << QString("--compression-level-%1").arg(mCompression);
+    if (len >= MIN_BLOCK_SIZE && len <= MAX_BLOCK_SIZE) {
+        encArgs << QString("--blocksize=%1").arg(len);
+        if (len > MAX_SUBSET_BLOCK_SIZE) {
+            encArgs << "--lax";
+        }
+    }
+    encArgs << "-";
+
+    qCDebug(LOG) << "Encode boundary samples" << start << "-" << end;
+    TraceScope trace("FlacSplitter::encodeSamples");
+
+    ExtProgram decoder;
+    ExtProgram encoder;
+    decoder.setProgram(program);
+    decoder.setArguments(decArgs);
+    encoder.setProgram(program);
+    encoder.setArguments(encArgs);
+    decoder.setStandardOutputProcess(&encoder);
+    cancellationToken().attach(&decoder);
+    cancellationToken().attach(&encoder);
+
+    decoder.start();
+    encoder.start();
+    // On cancel or stall the ExtProgram destructor kills the processes.
+    // The boundary ranges are short, so any wait longer than the stall
+    // timeout means the program is hung.
+    // The encoder output is drained while waiting, otherwise the encoder
+    // blocks on the full pipe and the decoder blocks behind it.
+    buf->clear();
+    for (QProcess *p : { &encoder, &decoder }) {
+        StallWatchdog watchdog(program, stallTimeout(), cancellationToken());
+        while (!cancellationToken().waitForFinished(p, CancellationToken::POLL_INTERVAL * 10)) {
+            buf->append(encoder.readAllStandardOutput());
+            watchdog.check();
+        }
+    }
+
+    if (decoder.exitCode() != 0) {
+        throw FlaconError(QString::fromLocal8Bit(decoder.readAllStandardError()));
+    }
+
+    if (encoder.exitCode() != 0) {
+        throw FlaconError(QString::fromLocal8Bit(encoder.readAllStandardError()));
+    }
+
+    buf->append(encoder.readAllStandardOutput());
+
+    const uchar *data          = reinterpret_cast<const uchar *>(buf->constData());
+    qint64       firstFramePos = 0;
+    StreamInfo   info          = readStreamInfo(data, buf->size(), &firstFramePos);
+
+    // Output to the pipe, the encoder can't write the total samples
+    info.totalSamples = len;
+
+    Frames res = readFrames(data, buf->size(), firstFramePos, info);
+
+    quint64 samples = 0;
+    for (const Frame &f : qAsConst(res)) {
+        samples += f.blockSize;
+    }
+
+    if (samples != len) {
+        throw FlaconError(QString("The encoder returned %1 samples instead of %2").arg(samples).arg(len));
+    }
+
+    return res;
+}
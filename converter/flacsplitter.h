@@ -0,0 +1,120 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef FLACSPLITTER_H
+#define FLACSPLITTER_H
+
+#include "worker.h"
+#include "profiles.h"
+#include <QVector>
+
+namespace Conv {
+
+/************************************************
+ * Splits the FLAC file without decoding.
+ * The frames inside the track are copied as is,
+ * only the frames on the track boundaries are
+ * decoded and encoded again.
+ ************************************************/
+class FlacSplitter : public Worker
+{
+    Q_OBJECT
+public:
+    FlacSplitter(Disc *disk, const ConvTracks &tracks, const QString &outDir, QObject *parent = nullptr);
+
+    PreGapType pregapType() const { return mPregapType; }
+    void       setPregapType(const PreGapType &pregapType) { mPregapType = pregapType; }
+
+    int  compression() const { return mCompression; }
+    void setCompression(int value) { mCompression = value; }
+
+    static bool canSplit(const Disc *disc, const Profile &profile);
+
+public slots:
+    void run() override;
+
+signals:
+    void trackReady(const Conv::ConvTrack &track, const QString &outFileName);
+
+public:
+    struct StreamInfo
+    {
+        quint16 minBlockSize  = 0;
+        quint16 maxBlockSize  = 0;
+        quint32 minFrameSize  = 0;
+        quint32 maxFrameSize  = 0;
+        quint32 sampleRate    = 0;
+        quint8  channels      = 0;
+        quint8  bitsPerSample = 0;
+        quint64 totalSamples  = 0;
+
+        QByteArray toByteArray() const;
+    };
+
+    struct Frame
+    {
+        qint64  offset      = 0;
+        qint64  size        = 0;
+        quint64 firstSample = 0;
+        quint32 blockSize   = 0;
+        int     numberPos   = 0;    // Position of the coded frame/sample number in the header
+        int     numberEnd   = 0;    // End of the coded number
+        int     headerSize  = 0;    // Including CRC-8
+        bool    verified    = true; // The CRC-16 footer matches, the frame can be copied as is
+    };
+
+    using Frames = QVector<Frame>;
+
+    static StreamInfo readStreamInfo(const uchar *data, qint64 size, qint64 *firstFramePos) noexcept(false);
+    static Frames     readFrames(const uchar *data, qint64 size, qint64 firstFramePos, const StreamInfo &streamInfo) noexcept(false);
+
+private:
+    struct Range
+    {
+        ConvTrack track;
+        quint64   start = 0;
+        quint64   end   = 0;
+        QString   outFileName;
+    };
+
+    const Disc      *mDisc = nullptr;
+    const ConvTracks mTracks;
+    const QString    mOutDir;
+    PreGapType       mPregapType  = PreGapType::AddToFirstTrack;
+    int              mCompression = 5;
+
+    QString     mInputFile;
+    StreamInfo  mStreamInfo;
+    Frames      mFrames;
+    const uchar *mData = nullptr;
+
+    quint64 timeToSample(const CueTime &time) const;
+    void    processTrack(const Range &range);
+    Frames  encodeSamples(quint64 start, quint64 end, QByteArray *buf) const;
+};
+
+} // namespace
+
+#endif // FLACSPLITTER_H
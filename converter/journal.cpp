@@ -0,0 +1,313 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "journal.h"
+#include "disc.h"
+#include "track.h"
+#include "profiles.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QStandardPaths>
+#include <QLoggingCategory>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "Journal")
+}
+
+using namespace Conv;
+
+static constexpr auto EVENT_KEY     = "event";
+static constexpr auto DISC_EVENT    = "disc";
+static constexpr auto PROFILE_EVENT = "profile";
+static constexpr auto TRACK_EVENT   = "track";
+static constexpr auto FINISH_EVENT  = "finished";
+
+/************************************************
+ *
+ ************************************************/
+bool Journal::State::isDone(const QString &resultFilePath) const
+{
+    auto it = doneFiles.constFind(resultFilePath);
+    if (it == doneFiles.constEnd()) {
+        return false;
+    }
+
+    QFileInfo fi(resultFilePath);
+    return fi.exists() && fi.size() == it.value().size && fi.lastModified().toMSecsSinceEpoch() == it.value().mtime;
+}
+
+/************************************************
+ *
+ ************************************************/
+Journal::Journal(const QString &fileName) :
+    mFile(fileName)
+{
+}
+
+/************************************************
+ *
+ ************************************************/
+QString Journal::dir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/journals";
+}
+
+/************************************************
+ *
+ ************************************************/
+QString Journal::discFile(const Disc *disc)
+{
+    QString file = disc->cueFilePath();
+    if (!QFileInfo::exists(file) && !disc->audioFiles().isEmpty()) {
+        // The CUE is embedded into the audio file
+        file = disc->audioFiles().first().filePath();
+    }
+
+    return QFileInfo(file).absoluteFilePath();
+}
+
+/************************************************
+ * The order of the discs and profiles doesn't
+ * change the batch.
+ ************************************************/
+QString Journal::batchFileName(const QStringList &discFiles, const QStringList &profileIds)
+{
+    QStringList discs = discFiles;
+    discs.sort();
+    discs.removeDuplicates();
+
+    QStringList profiles = profileIds;
+    profiles.sort();
+    profiles.removeDuplicates();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(discs.join("\n").toUtf8());
+    hash.addData("\n\n");
+    hash.addData(profiles.join("\n").toUtf8());
+
+    return QString("%1/%2.log").arg(dir(), QString::fromLatin1(hash.result().toHex()));
+}
+
+/************************************************
+ *
+ ************************************************/
+QString Journal::lastFileName()
+{
+    QFileInfoList files = QDir(dir()).entryInfoList({ "*.log" }, QDir::Files, QDir::Time);
+    return files.isEmpty() ? QString() : files.first().absoluteFilePath();
+}
+
+/************************************************
+ *
+ ************************************************/
+void Journal::setFileName(const QString &fileName)
+{
+    close();
+    mFile.setFileName(fileName);
+}
+
+/************************************************
+ *
+ ************************************************/
+bool Journal::open()
+{
+    close();
+
+    if (mFile.fileName().isEmpty()) {
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(mFile.fileName()).path());
+
+    if (!mFile.open(QFile::WriteOnly | QFile::Append)) {
+        qCWarning(LOG) << "Can't open journal" << mFile.fileName() << mFile.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+/************************************************
+ *
+ ************************************************/
+void Journal::remove()
+{
+    close();
+    if (!mFile.fileName().isEmpty()) {
+        mFile.remove();
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void Journal::close()
+{
+    if (mFile.isOpen()) {
+        mFile.close();
+    }
+}
+
+/************************************************
+ * We don't call fsync, the records written by the
+ * killed process are kept by the system anyway.
+ ************************************************/
+void Journal::write(const QJsonObject &record)
+{
+    if (!mFile.isOpen()) {
+        return;
+    }
+
+    mFile.write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    mFile.write("\n");
+    mFile.flush();
+}
+
+/************************************************
+ *
+ ************************************************/
+void Journal::writeDisc(const Disc *disc)
+{
+    QJsonObject record;
+    record[EVENT_KEY] = DISC_EVENT;
+    record["file"]    = discFile(disc);
+    write(record);
+}
+
+/************************************************
+ *
+ ************************************************/
+void Journal::writeProfile(const Profile &profile)
+{
+    QJsonObject record;
+    record[EVENT_KEY] = PROFILE_EVENT;
+    record["id"]      = profile.id();
+    write(record);
+}
+
+/************************************************
+ *
+ ************************************************/
+void Journal::writeTrackState(const Track &track, TrackState state, const QStringList &resultFiles)
+{
+    QJsonObject record;
+    record[EVENT_KEY] = TRACK_EVENT;
+    record["audio"]   = track.audioFile().filePath();
+    record["index"]   = track.index();
+    record["state"]   = trackStateToString(state);
+
+    if (!resultFiles.isEmpty()) {
+        QJsonArray files;
+        for (const QString &f : resultFiles) {
+            QJsonObject file;
+            QFileInfo   fi(f);
+            file["path"]  = f;
+            file["size"]  = QString::number(fi.size());
+            file["mtime"] = QString::number(fi.lastModified().toMSecsSinceEpoch());
+            files << file;
+        }
+        record["files"] = files;
+    }
+
+    write(record);
+}
+
+/************************************************
+ *
+ ************************************************/
+void Journal::writeFinished()
+{
+    QJsonObject record;
+    record[EVENT_KEY] = FINISH_EVENT;
+    write(record);
+}
+
+/************************************************
+ * The last line can be truncated if the process
+ * was killed, such lines are skipped.
+ ************************************************/
+Journal::State Journal::read() const
+{
+    State res;
+
+    QFile file(mFile.fileName());
+    if (!file.open(QFile::ReadOnly)) {
+        return res;
+    }
+
+    while (!file.atEnd()) {
+        QJsonParseError err;
+        QJsonObject     record = QJsonDocument::fromJson(file.readLine(), &err).object();
+        if (err.error != QJsonParseError::NoError) {
+            continue;
+        }
+
+        const QString event = record[EVENT_KEY].toString();
+
+        if (event == DISC_EVENT) {
+            QString f = record["file"].toString();
+            if (!res.discFiles.contains(f)) {
+                res.discFiles << f;
+            }
+            continue;
+        }
+
+        if (event == PROFILE_EVENT) {
+            QString id = record["id"].toString();
+            if (!res.profileIds.contains(id)) {
+                res.profileIds << id;
+            }
+            continue;
+        }
+
+        if (event == TRACK_EVENT) {
+            for (const QJsonValue &v : record["files"].toArray()) {
+                QJsonObject f = v.toObject();
+                if (record["state"].toString() == trackStateToString(TrackState::OK)) {
+                    DoneFile done;
+                    done.size  = f["size"].toString().toLongLong();
+                    done.mtime = f["mtime"].toString().toLongLong();
+                    res.doneFiles.insert(f["path"].toString(), done);
+                }
+                else {
+                    res.doneFiles.remove(f["path"].toString());
+                }
+            }
+            continue;
+        }
+
+        if (event == FINISH_EVENT) {
+            res.finished = true;
+        }
+    }
+
+    return res;
+}
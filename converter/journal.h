@@ -0,0 +1,106 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include "types.h"
+
+class QJsonObject;
+class Disc;
+class Track;
+class Profile;
+
+namespace Conv {
+
+/************************************************
+ * Append-only log of the conversion, one JSON
+ * object per line. Every line is flushed, so the
+ * log survives a killed process and the next run
+ * can continue with the remaining tracks.
+ * Each batch (the set of discs and profiles) has
+ * its own journal, the records are never removed
+ * implicitly.
+ ************************************************/
+class Journal
+{
+public:
+    struct DoneFile
+    {
+        qint64 size  = 0;
+        qint64 mtime = 0;
+    };
+
+    struct State
+    {
+        QStringList              discFiles;
+        QStringList              profileIds;
+        QHash<QString, DoneFile> doneFiles; // Result file path -> file stamp
+        bool                     finished = false;
+
+        // The file was written and is not changed after that.
+        bool isDone(const QString &resultFilePath) const;
+    };
+
+    explicit Journal(const QString &fileName = QString());
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    static QString dir();
+    static QString discFile(const Disc *disc);
+    static QString batchFileName(const QStringList &discFiles, const QStringList &profileIds);
+
+    // The journal of the last conversion, used when --resume has no files.
+    static QString lastFileName();
+
+    QString fileName() const { return mFile.fileName(); }
+    void    setFileName(const QString &fileName);
+
+    // The new records are always appended.
+    bool open();
+    void close();
+
+    // Removes the journal of the successfully finished batch.
+    void remove();
+
+    void writeDisc(const Disc *disc);
+    void writeProfile(const Profile &profile);
+    void writeTrackState(const Track &track, TrackState state, const QStringList &resultFiles = QStringList());
+    void writeFinished();
+
+    State read() const;
+
+private:
+    QFile mFile;
+
+    void write(const QJsonObject &record);
+};
+
+} // namespace
+
+#endif // JOURNAL_H
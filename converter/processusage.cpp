@@ -0,0 +1,92 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "processusage.h"
+
+using namespace Conv;
+
+/************************************************
+ *
+ ************************************************/
+ProcessUsage &ProcessUsage::operator+=(const ProcessUsage &other)
+{
+    count += other.count;
+    userTime += other.userTime;
+    systemTime += other.systemTime;
+    wallTime += other.wallTime;
+    maxRss = qMax(maxRss, other.maxRss);
+    inBlocks += other.inBlocks;
+    outBlocks += other.outBlocks;
+    voluntarySwitches += other.voluntarySwitches;
+    involuntarySwitches += other.involuntarySwitches;
+    return *this;
+}
+
+/************************************************
+ *
+ ************************************************/
+ProcessUsageStatistic *ProcessUsageStatistic::instance()
+{
+    static ProcessUsageStatistic res;
+    return &res;
+}
+
+/************************************************
+ *
+ ************************************************/
+void ProcessUsageStatistic::add(const QString &program, const QString &tag, const ProcessUsage &usage)
+{
+    QMutexLocker locker(&mMutex);
+    mPrograms[program] += usage;
+    mTags[tag] += usage;
+}
+
+/************************************************
+ *
+ ************************************************/
+void ProcessUsageStatistic::reset()
+{
+    QMutexLocker locker(&mMutex);
+    mPrograms.clear();
+    mTags.clear();
+}
+
+/************************************************
+ *
+ ************************************************/
+QMap<QString, ProcessUsage> ProcessUsageStatistic::byProgram() const
+{
+    QMutexLocker locker(&mMutex);
+    return mPrograms;
+}
+
+/************************************************
+ *
+ ************************************************/
+QMap<QString, ProcessUsage> ProcessUsageStatistic::byTag() const
+{
+    QMutexLocker locker(&mMutex);
+    return mTags;
+}
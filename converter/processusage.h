@@ -0,0 +1,77 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef PROCESSUSAGE_H
+#define PROCESSUSAGE_H
+
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+namespace Conv {
+
+/************************************************
+ * The resources used by the external programs,
+ * collected by ExtProgram from wait4().
+ ************************************************/
+struct ProcessUsage
+{
+    int    count               = 0;
+    qint64 userTime            = 0; // usec
+    qint64 systemTime          = 0; // usec
+    qint64 wallTime            = 0; // usec, from the start to the exit
+    qint64 maxRss              = 0; // KiB, the maximum of all runs
+    qint64 inBlocks            = 0;
+    qint64 outBlocks           = 0;
+    qint64 voluntarySwitches   = 0;
+    qint64 involuntarySwitches = 0;
+
+    ProcessUsage &operator+=(const ProcessUsage &other);
+};
+
+class ProcessUsageStatistic
+{
+public:
+    static ProcessUsageStatistic *instance();
+
+    // The tag is the profile ID, it's empty for the decoders
+    // that are shared by all profiles.
+    void add(const QString &program, const QString &tag, const ProcessUsage &usage);
+    void reset();
+
+    QMap<QString, ProcessUsage> byProgram() const;
+    QMap<QString, ProcessUsage> byTag() const;
+
+private:
+    ProcessUsageStatistic() = default;
+
+    mutable QMutex              mMutex;
+    QMap<QString, ProcessUsage> mPrograms;
+    QMap<QString, ProcessUsage> mTags;
+};
+
+} // namespace
+
+#endif // PROCESSUSAGE_H
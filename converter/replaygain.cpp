@@ -40,7 +40,9 @@
 #include <QDebug>
 #include <cmath>
 #include <QBuffer>
+#include <QDataStream>
 #include "converter/wavheader.h"
+#include "trace.h"
 
 static void registerQtMetaTypes()
 {
@@ -48,6 +50,7 @@ static void registerQtMetaTypes()
 
     if (!done) {
         qRegisterMetaType<ReplayGain::Result>();
+        qRegisterMetaType<QVector<ReplayGain::Result>>();
         done = true;
     }
 }
@@ -854,6 +857,7 @@ TrackGain::~TrackGain()
  ************************************************/
 void TrackGain::add(const char *data, size_t size)
 {
+    Conv::TraceScope trace("TrackGain::add");
     if (!mEngine->mHeaderReady) {
         size_t pos = mEngine->loadHeader(data, size);
 
@@ -912,6 +916,32 @@ Result::Result(const Result &other) :
     registerQtMetaTypes();
 }
 
+/************************************************
+ *
+ ************************************************/
+QDataStream &ReplayGain::operator<<(QDataStream &stream, const Result &result)
+{
+    for (uint32_t v : result.mHistogram) {
+        stream << quint32(v);
+    }
+    stream << result.mPeak;
+    return stream;
+}
+
+/************************************************
+ *
+ ************************************************/
+QDataStream &ReplayGain::operator>>(QDataStream &stream, Result &result)
+{
+    for (uint32_t &v : result.mHistogram) {
+        quint32 n;
+        stream >> n;
+        v = n;
+    }
+    stream >> result.mPeak;
+    return stream;
+}
+
 /************************************************
  * Calculate the ReplayGain value from the specified loudness histogram; clip to -24 / +64 dB
  ************************************************/
@@ -42,12 +42,16 @@
 #include <cmath>
 #include <QMetaType>
 
+class QDataStream;
+
 namespace ReplayGain {
 
 class Result
 {
     friend class TrackGain;
     friend class AlbumGain;
+    friend QDataStream &operator<<(QDataStream &stream, const Result &result);
+    friend QDataStream &operator>>(QDataStream &stream, Result &result);
 
 public:
     Result();
@@ -101,6 +105,9 @@ private:
     Result mResult;
 };
 
+QDataStream &operator<<(QDataStream &stream, const Result &result);
+QDataStream &operator>>(QDataStream &stream, Result &result);
+
 } // namespace
 
 Q_DECLARE_METATYPE(ReplayGain::Result);
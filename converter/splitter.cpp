@@ -26,6 +26,8 @@
 #include "splitter.h"
 #include "disc.h"
 #include "decoder.h"
+#include "stallwatchdog.h"
+#include "trace.h"
 #include <QDebug>
 #include <QLoggingCategory>
 #include <QFile>
@@ -186,20 +188,33 @@ void Splitter::run()
     // ******************************************
     // Create jobs
     QList<Job> jobs;
-    for (const ConvTrack &track : mTracks) {
-        if (track.isPregap()) {
-            Job job(mDisc, mTracks.first(), true, false, false);
-            job.outFileName = QString("%1/pregap-%2.wav").arg(mOutDir, uid);
-            job.isPregap    = true;
-            jobs << job;
-            continue;
-        }
+    if (mWholeImage) {
+        Job job(mDisc, mTracks.first(), false, false, false);
 
-        bool addPregap = (track.index() == 0 && mPregapType == PreGapType::AddToFirstTrack);
-        Job  job(mDisc, track, addPregap, true, true);
-        job.outFileName = QString("%1/track-%2_%3.wav").arg(mOutDir, uid).arg(track.trackNum(), 2, 10, QLatin1Char('0'));
+        Job::Chunk chunk;
+        chunk.file  = mDisc->audioFiles().first();
+        chunk.start = CueTime("00:00:00");
+        job.chunks << chunk;
+
+        job.outFileName = QString("%1/image-%2.wav").arg(mOutDir, uid);
         jobs << job;
     }
+    else {
+        for (const ConvTrack &track : mTracks) {
+            if (track.isPregap()) {
+                Job job(mDisc, mTracks.first(), true, false, false);
+                job.outFileName = QString("%1/pregap-%2.wav").arg(mOutDir, uid);
+                job.isPregap    = true;
+                jobs << job;
+                continue;
+            }
+
+            bool addPregap = (track.index() == 0 && mPregapType == PreGapType::AddToFirstTrack);
+            Job  job(mDisc, track, addPregap, true, true);
+            job.outFileName = QString("%1/track-%2_%3.wav").arg(mOutDir, uid).arg(track.trackNum(), 2, 10, QLatin1Char('0'));
+            jobs << job;
+        }
+    }
 
     for (const Job &job : jobs) {
         qCDebug(LOG) << "Spliter job _________________________";
@@ -244,6 +259,8 @@ void Splitter::run()
     for (const QString &file : decoders.keys()) {
         try {
             Decoder *decoder = new Decoder(&keeper);
+            decoder->setCancellationToken(cancellationToken());
+            decoder->setStallTimeout(stallTimeout());
             decoder->open(file);
             decoders[file] = decoder;
         }
@@ -263,10 +280,23 @@ void Splitter::run()
     // Decode data
     for (const Job &job : jobs) {
         try {
+            cancellationToken().waitIfPaused();
             processTrack(job);
             qCDebug(LOG) << "Splitter trackReady:" << job.track << job.outFileName;
             emit trackReady(job.track, job.outFileName);
         }
+        catch (const CanceledError &) {
+            qCDebug(LOG) << "Splitter canceled";
+            deleteFile(job.outFileName);
+            return;
+        }
+        catch (const StalledError &err) {
+            qCWarning(LOG) << "Splitter error for track " << job.track.trackNum() << ": " << err.what();
+            emit stalled(job.track, err.program());
+            emit error(job.track, err.what());
+            deleteFile(job.outFileName);
+            return;
+        }
         catch (FlaconError &err) {
             if (job.isPregap) {
                 qCWarning(LOG) << "Splitter error for pregap track : " << err.what();
@@ -295,6 +325,7 @@ struct ProgressCalc
  ************************************************/
 void Splitter::processTrack(const Job &job)
 {
+    TraceScope trace("Splitter::processTrack", job.track.trackNum());
 
     emit trackProgress(job.track, TrackState::Splitting, 0);
 
@@ -41,6 +41,10 @@ public:
     PreGapType pregapType() const { return mPregapType; }
     void       setPregapType(const PreGapType &pregapType);
 
+    // Extract the whole audio file as one track, the first track is used as the job track.
+    bool isWholeImage() const { return mWholeImage; }
+    void setWholeImage(bool value) { mWholeImage = value; }
+
 public slots:
     void run() override;
 
@@ -54,6 +58,7 @@ private:
     const ConvTracks mTracks;
     const QString    mOutDir;
     PreGapType       mPregapType = PreGapType::AddToFirstTrack;
+    bool             mWholeImage = false;
 
     void processTrack(const Job &job);
 };
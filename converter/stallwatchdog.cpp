@@ -0,0 +1,91 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "stallwatchdog.h"
+#include <QFileInfo>
+#include <QLoggingCategory>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "StallWatchdog")
+}
+
+using namespace Conv;
+
+/************************************************
+ *
+ ************************************************/
+StalledError::StalledError(const QString &program, int timeout) :
+    FlaconError(QString("The '%1' program made no progress for %2 seconds and was killed.").arg(QFileInfo(program).fileName()).arg(timeout / 1000)),
+    mProgram(QFileInfo(program).fileName())
+{
+}
+
+/************************************************
+ *
+ ************************************************/
+StallWatchdog::StallWatchdog(const QString &program, int timeout, const CancellationToken &token) :
+    mProgram(program),
+    mTimeout(timeout),
+    mCancel(token)
+{
+    mLastProgress.start();
+    mTotal.start();
+}
+
+/************************************************
+ *
+ ************************************************/
+void StallWatchdog::setBytes(qint64 bytes)
+{
+    if (bytes != mBytes) {
+        mBytes = bytes;
+        mLastProgress.restart();
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+double StallWatchdog::bytesPerSecond() const
+{
+    qint64 msec = mTotal.elapsed();
+    return msec ? mBytes * 1000.0 / msec : 0;
+}
+
+/************************************************
+ *
+ ************************************************/
+void StallWatchdog::check()
+{
+    if (mCancel.isPaused()) {
+        mLastProgress.restart();
+        return;
+    }
+
+    if (mTimeout > 0 && mLastProgress.elapsed() > mTimeout) {
+        qCWarning(LOG) << "The" << mProgram << "program is stalled, processed" << mBytes << "bytes," << bytesPerSecond() << "bytes/sec";
+        throw StalledError(mProgram, mTimeout);
+    }
+}
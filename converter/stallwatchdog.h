@@ -0,0 +1,78 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include "types.h"
+#include "cancellationtoken.h"
+
+namespace Conv {
+
+class StalledError : public FlaconError
+{
+public:
+    StalledError(const QString &program, int timeout);
+    QString program() const { return mProgram; }
+
+private:
+    QString mProgram;
+};
+
+/************************************************
+ * Counts the bytes the external program consumed
+ * or produced. If there was no progress for the
+ * timeout, check() throws StalledError and the
+ * caller kills the program. The time in the pause
+ * is not counted.
+ ************************************************/
+class StallWatchdog
+{
+public:
+    // The timeout in msec, 0 disables the watchdog.
+    StallWatchdog(const QString &program, int timeout, const CancellationToken &token = CancellationToken());
+
+    void addBytes(qint64 bytes) { setBytes(mBytes + bytes); }
+    void setBytes(qint64 bytes);
+
+    void check() noexcept(false);
+
+    qint64 bytes() const { return mBytes; }
+    double bytesPerSecond() const;
+
+private:
+    QString           mProgram;
+    int               mTimeout = 0;
+    CancellationToken mCancel;
+    qint64            mBytes = 0;
+    QElapsedTimer     mLastProgress;
+    QElapsedTimer     mTotal;
+};
+
+} // namespace
+
+#endif // STALLWATCHDOG_H
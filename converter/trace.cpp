@@ -0,0 +1,184 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "trace.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QLoggingCategory>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "Trace")
+}
+
+using namespace Conv;
+
+QAtomicInt Trace::mEnabled(0);
+
+namespace {
+
+struct Event
+{
+    const char *name;
+    qint64      start;
+    qint64      duration;
+    int         track;
+};
+
+struct ThreadBuffer
+{
+    int            tid = 0;
+    QString        name;
+    QVector<Event> events;
+};
+
+struct Registry
+{
+    QMutex                  mutex;
+    QVector<ThreadBuffer *> buffers;
+    QElapsedTimer           timer;
+};
+
+Registry *registry()
+{
+    static Registry res;
+    return &res;
+}
+
+thread_local ThreadBuffer *threadBuffer = nullptr;
+
+ThreadBuffer *currentBuffer()
+{
+    if (threadBuffer) {
+        return threadBuffer;
+    }
+
+    Registry     *reg = registry();
+    QMutexLocker  locker(&reg->mutex);
+    ThreadBuffer *buf = new ThreadBuffer();
+
+    buf->tid = reg->buffers.count() + 1;
+    if (QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread()) {
+        buf->name = "main";
+    }
+    else {
+        buf->name = QString("worker %1").arg(buf->tid);
+    }
+
+    // The buffer outlives the thread, the events are saved after the workers are finished
+    reg->buffers << buf;
+    threadBuffer = buf;
+    return buf;
+}
+
+} // namespace
+
+/************************************************
+ *
+ ************************************************/
+void Trace::setEnabled(bool value)
+{
+    Registry *reg = registry();
+    if (value) {
+        QMutexLocker locker(&reg->mutex);
+        for (ThreadBuffer *buf : qAsConst(reg->buffers)) {
+            buf->events.clear();
+        }
+        reg->timer.start();
+    }
+
+    mEnabled.storeRelease(value ? 1 : 0);
+}
+
+/************************************************
+ *
+ ************************************************/
+qint64 Trace::now()
+{
+    return registry()->timer.nsecsElapsed() / 1000;
+}
+
+/************************************************
+ *
+ ************************************************/
+void Trace::add(const char *name, qint64 start, qint64 duration, int track)
+{
+    currentBuffer()->events.append(Event { name, start, duration, track });
+}
+
+/************************************************
+ *
+ ************************************************/
+bool Trace::save(const QString &fileName)
+{
+    QJsonArray events;
+
+    Registry    *reg = registry();
+    QMutexLocker locker(&reg->mutex);
+    for (const ThreadBuffer *buf : qAsConst(reg->buffers)) {
+        QJsonObject threadName;
+        threadName["name"] = "thread_name";
+        threadName["ph"]   = "M";
+        threadName["pid"]  = 1;
+        threadName["tid"]  = buf->tid;
+        threadName["args"] = QJsonObject { { "name", buf->name } };
+        events << threadName;
+
+        for (const Event &e : buf->events) {
+            QJsonObject event;
+            event["name"] = QString::fromLatin1(e.name);
+            event["cat"]  = "converter";
+            event["ph"]   = "X";
+            event["ts"]   = e.start;
+            event["dur"]  = e.duration;
+            event["pid"]  = 1;
+            event["tid"]  = buf->tid;
+            if (e.track > -1) {
+                event["args"] = QJsonObject { { "track", e.track } };
+            }
+            events << event;
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"]     = events;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qCWarning(LOG) << "Can't write trace" << fileName << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
@@ -0,0 +1,95 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QAtomicInt>
+#include <QString>
+
+namespace Conv {
+
+/************************************************
+ * Timing of the conversion stages. Every thread
+ * appends the events to its own buffer, the lock
+ * is taken only once per thread. When the trace
+ * is disabled, TraceScope costs one atomic load.
+ ************************************************/
+class Trace
+{
+public:
+    static bool isEnabled() { return mEnabled.loadAcquire() != 0; }
+
+    // Should be called before the conversion starts.
+    // On enable the old events are removed.
+    static void setEnabled(bool value);
+
+    // Microseconds since the trace was enabled.
+    static qint64 now();
+
+    static void add(const char *name, qint64 start, qint64 duration, int track = -1);
+
+    // Chrome trace event format, can be opened in chrome://tracing or Perfetto.
+    static bool save(const QString &fileName);
+
+private:
+    static QAtomicInt mEnabled;
+};
+
+/************************************************
+ * The name should be a string literal, it is
+ * stored without copying.
+ ************************************************/
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name, int track = -1) :
+        mName(Trace::isEnabled() ? name : nullptr),
+        mTrack(track)
+    {
+        if (mName) {
+            mStart = Trace::now();
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (mName) {
+            Trace::add(mName, mStart, Trace::now() - mStart, mTrack);
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *mName  = nullptr;
+    int         mTrack = -1;
+    qint64      mStart = 0;
+};
+
+} // namespace
+
+#endif // TRACE_H
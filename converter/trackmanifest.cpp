@@ -0,0 +1,202 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "trackmanifest.h"
+#include "track.h"
+#include "disc.h"
+#include "profiles.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QStandardPaths>
+#include <QLoggingCategory>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "TrackManifest")
+}
+
+using namespace Conv;
+
+static constexpr auto OUT_SIZE_KEY  = "outSize";
+static constexpr auto OUT_MTIME_KEY = "outMtime";
+
+/************************************************
+ *
+ ************************************************/
+static QString fileHash(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+/************************************************
+ *
+ ************************************************/
+static QString tagsHash(const Track &track)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (int i = int(TagId::Album); i <= int(TagId::TrackCount); ++i) {
+        hash.addData(QByteArray::number(i));
+        hash.addData("=");
+        hash.addData(track.tag(TagId(i)).toUtf8());
+        hash.addData("\n");
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+/************************************************
+ *
+ ************************************************/
+static QString profileHash(const Profile &profile)
+{
+    QStringList values;
+    values << profile.formatId();
+    values << QString::number(profile.bitsPerSample());
+    values << QString::number(int(profile.sampleRate()));
+    values << gainTypeToString(profile.gainType());
+    values << QString::number(profile.isCreateCue());
+    values << QString::number(profile.isEmbedCue());
+    values << profile.cueFileName();
+    values << preGapTypeToString(profile.preGapType());
+    values << QString::number(profile.isWholeImage());
+    values << coverModeToString(profile.copyCoverOptions().mode);
+    values << QString::number(profile.copyCoverOptions().size);
+    values << coverModeToString(profile.embedCoverOptions().mode);
+    values << QString::number(profile.embedCoverOptions().size);
+
+    QStringList keys = profile.outFormat()->defaultParameters().keys();
+    keys.sort();
+    for (const QString &key : qAsConst(keys)) {
+        values << key + "=" + profile.value(key).toString();
+    }
+
+    return QString::fromLatin1(QCryptographicHash::hash(values.join("\n").toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+/************************************************
+ *
+ ************************************************/
+TrackManifest::TrackManifest(const Track &track, const Profile &profile) :
+    mResultFilePath(track.resultFilePath(profile))
+{
+    QFileInfo source(track.audioFile().filePath());
+    mData["source"]      = source.absoluteFilePath();
+    mData["sourceSize"]  = QString::number(source.size());
+    mData["sourceMtime"] = QString::number(source.lastModified().toMSecsSinceEpoch());
+
+    const Disc *disc = track.disc();
+    if (disc) {
+        mData["cueHash"] = fileHash(disc->cueFilePath());
+
+        const Track *next = (track.index() + 1 < disc->count()) ? disc->track(track.index() + 1) : nullptr;
+        mData["end"]      = next ? next->cueIndex(1).toString(false) : QString();
+    }
+
+    mData["index0"]      = track.cueIndex(0).toString(false);
+    mData["index1"]      = track.cueIndex(1).toString(false);
+    mData["tagsHash"]    = tagsHash(track);
+    mData["profileHash"] = profileHash(profile);
+}
+
+/************************************************
+ *
+ ************************************************/
+QString TrackManifest::dir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/manifests";
+}
+
+/************************************************
+ *
+ ************************************************/
+QString TrackManifest::manifestPath() const
+{
+    QByteArray hash = QCryptographicHash::hash(QFileInfo(mResultFilePath).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QString("%1/%2/%3.json").arg(dir(), QString::fromLatin1(hash.left(2)), QString::fromLatin1(hash));
+}
+
+/************************************************
+ *
+ ************************************************/
+bool TrackManifest::isUpToDate() const
+{
+    QFileInfo out(mResultFilePath);
+    if (!out.exists()) {
+        return false;
+    }
+
+    QFile file(manifestPath());
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    QJsonObject stored = QJsonDocument::fromJson(file.readAll()).object();
+
+    if (stored.value(OUT_SIZE_KEY).toString() != QString::number(out.size()) ||
+        stored.value(OUT_MTIME_KEY).toString() != QString::number(out.lastModified().toMSecsSinceEpoch())) {
+        qCDebug(LOG) << "Output file was changed" << mResultFilePath;
+        return false;
+    }
+
+    stored.remove(OUT_SIZE_KEY);
+    stored.remove(OUT_MTIME_KEY);
+    return stored == mData;
+}
+
+/************************************************
+ *
+ ************************************************/
+void TrackManifest::save() const
+{
+    QFileInfo out(mResultFilePath);
+
+    QJsonObject data    = mData;
+    data[OUT_SIZE_KEY]  = QString::number(out.size());
+    data[OUT_MTIME_KEY] = QString::number(out.lastModified().toMSecsSinceEpoch());
+
+    QString path = manifestPath();
+    if (!QDir().mkpath(QFileInfo(path).path())) {
+        qCWarning(LOG) << "Can't create directory" << QFileInfo(path).path();
+        return;
+    }
+
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qCWarning(LOG) << "Can't write manifest" << path << file.errorString();
+        return;
+    }
+
+    file.write(QJsonDocument(data).toJson(QJsonDocument::Compact));
+}
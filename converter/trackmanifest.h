@@ -0,0 +1,67 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef TRACKMANIFEST_H
+#define TRACKMANIFEST_H
+
+#include <QJsonObject>
+#include <QString>
+
+class Track;
+class Profile;
+
+namespace Conv {
+
+/************************************************
+ * Describes everything the output track was made
+ * from: the source file, CUE, track range, tags
+ * and profile. The manifests are stored in the
+ * cache directory, one file for each output file.
+ ************************************************/
+class TrackManifest
+{
+public:
+    TrackManifest(const Track &track, const Profile &profile);
+
+    QString resultFilePath() const { return mResultFilePath; }
+
+    // True if the stored manifest matches and the output file was not changed after that.
+    bool isUpToDate() const;
+
+    // Call it when the output file is written.
+    void save() const;
+
+    static QString dir();
+
+private:
+    QString     mResultFilePath;
+    QJsonObject mData;
+
+    QString manifestPath() const;
+};
+
+} // namespace
+
+#endif // TRACKMANIFEST_H
@@ -29,6 +29,7 @@
 #include "convertertypes.h"
 #include <QObject>
 #include "track.h"
+#include "cancellationtoken.h"
 
 class Disc;
 
@@ -41,15 +42,29 @@ public:
     explicit Worker(QObject *parent = nullptr);
     virtual ~Worker();
 
+    // The token is shared with the pipeline, the worker stops
+    // its loops and kills external programs when it is canceled.
+    CancellationToken cancellationToken() const { return mCancel; }
+    void              setCancellationToken(const CancellationToken &token) { mCancel = token; }
+
+    // The external program without progress for this time is killed, msec.
+    int  stallTimeout() const { return mStallTimeout; }
+    void setStallTimeout(int value) { mStallTimeout = value; }
+
 public slots:
     virtual void run() = 0;
 
 signals:
     void error(const Conv::ConvTrack &track, const QString &message);
     void trackProgress(const Conv::ConvTrack &track, TrackState state, int percent);
+    void stalled(const Conv::ConvTrack &track, const QString &program);
 
 protected:
     bool deleteFile(const QString &fileName) const;
+
+private:
+    CancellationToken mCancel;
+    int               mStallTimeout = 0;
 };
 
 } // namespace
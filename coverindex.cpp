@@ -0,0 +1,245 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "coverindex.h"
+
+#include <QDir>
+#include <QImageReader>
+#include <QQueue>
+#include <QSet>
+#include <QLoggingCategory>
+#include <algorithm>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "CoverIndex")
+}
+
+/************************************************
+ *
+ ************************************************/
+static bool compareCoverImages(const QFileInfo &f1, const QFileInfo &f2)
+{
+    const static QStringList order(QStringList()
+                                   << "COVER"
+                                   << "FRONT"
+                                   << "FOLDER");
+
+    QString f1up = f1.baseName().toUpper();
+    QString f2up = f2.baseName().toUpper();
+
+    int n1 = 9999;
+    int n2 = 9999;
+
+    for (int i = 0; i < order.count(); ++i) {
+        const QString &pattern = order.at(i);
+
+        // complete match ..................
+        if (f1up == pattern) {
+            n1 = i;
+        }
+
+        if (f2up == pattern) {
+            n2 = i;
+        }
+
+        // filename contains pattern .......
+        if (f1up.contains(pattern)) {
+            n1 = i + order.count();
+        }
+
+        if (f2up.contains(pattern)) {
+            n2 = i + order.count();
+        }
+    }
+
+    if (n1 != n2)
+        return n1 < n2;
+
+    // If we have 2 files with same name but in different directories,
+    // we choose the nearest (with the shorter path).
+    int l1 = f1.absoluteFilePath().length();
+    int l2 = f2.absoluteFilePath().length();
+    if (l1 != l2)
+        return l1 < l2;
+
+    return f1.absoluteFilePath() < f2.absoluteFilePath();
+}
+
+/************************************************
+ *
+ ************************************************/
+CoverIndex *CoverIndex::instance()
+{
+    static CoverIndex *res = new CoverIndex();
+    return res;
+}
+
+/************************************************
+ * The listing is done without the lock, two threads
+ * can list the same directory, but they get the
+ * same result.
+ ************************************************/
+CoverIndex::Dir CoverIndex::listDir(const QString &path)
+{
+    QDateTime mtime = QFileInfo(path).lastModified();
+    {
+        QMutexLocker locker(&mMutex);
+        auto         it = mDirs.constFind(path);
+        if (it != mDirs.constEnd() && it->mtime.isValid() && it->mtime == mtime) {
+            return it.value();
+        }
+    }
+
+    qCDebug(LOG) << "List directory" << path;
+
+    QStringList exts;
+    exts << "*.jpg";
+    exts << "*.jpeg";
+    exts << "*.png";
+    exts << "*.bmp";
+    exts << "*.tiff";
+
+    QDir dir(path);
+    Dir  res;
+    res.mtime = mtime;
+    res.dirs  = dir.entryInfoList(QDir::Dirs | QDir::Readable | QDir::NoDotAndDotDot);
+    res.files = dir.entryInfoList(exts, QDir::Files | QDir::Readable);
+
+    QMutexLocker locker(&mMutex);
+    mDirs.insert(path, res);
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+bool CoverIndex::isActual(const Tree &tree) const
+{
+    for (auto it = tree.dirs.constBegin(); it != tree.dirs.constEnd(); ++it) {
+        QDateTime mtime = QFileInfo(it.key()).lastModified();
+        if (!mtime.isValid() || mtime != it.value()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/************************************************
+ * Many discs share the same start directory, the
+ * tree is walked and sorted once, the next calls
+ * only check the directories mtime.
+ ************************************************/
+QStringList CoverIndex::images(const QString &startDir)
+{
+    Tree cached;
+    {
+        QMutexLocker locker(&mMutex);
+        cached = mTrees.value(startDir);
+    }
+
+    if (!cached.dirs.isEmpty() && isActual(cached)) {
+        return cached.images;
+    }
+
+    qCDebug(LOG) << "Search images in" << startDir;
+
+    Tree          tree;
+    QFileInfoList files;
+
+    QQueue<QString> query;
+    query << startDir;
+
+    QSet<QString> processed;
+    while (!query.isEmpty()) {
+        QString path = query.dequeue();
+        Dir     dir  = listDir(path);
+        tree.dirs.insert(path, dir.mtime);
+
+        foreach (QFileInfo d, dir.dirs) {
+            if (d.isSymLink())
+                d = QFileInfo(d.symLinkTarget());
+
+            if (!processed.contains(d.absoluteFilePath())) {
+                processed << d.absoluteFilePath();
+                query << d.absoluteFilePath();
+            }
+        }
+
+        files << dir.files;
+    }
+
+    std::stable_sort(files.begin(), files.end(), compareCoverImages);
+
+    foreach (QFileInfo f, files)
+        tree.images << f.absoluteFilePath();
+
+    QMutexLocker locker(&mMutex);
+    mTrees.insert(startDir, tree);
+    return tree.images;
+}
+
+/************************************************
+ * QImageReader::size() reads only the header, for
+ * the formats without the size in the header the
+ * image is decoded.
+ ************************************************/
+QSize CoverIndex::imageSize(const QString &fileName)
+{
+    QFileInfo fi(fileName);
+    {
+        QMutexLocker locker(&mMutex);
+        auto         it = mImages.constFind(fileName);
+        if (it != mImages.constEnd() && it->fileSize == fi.size() && it->mtime == fi.lastModified()) {
+            return it->size;
+        }
+    }
+
+    Image img;
+    img.fileSize = fi.size();
+    img.mtime    = fi.lastModified();
+
+    QImageReader reader(fileName);
+    if (reader.canRead()) {
+        img.size = reader.size();
+        if (!img.size.isValid()) {
+            img.size = reader.read().size();
+        }
+    }
+
+    QMutexLocker locker(&mMutex);
+    mImages.insert(fileName, img);
+    return img.size;
+}
+
+/************************************************
+ *
+ ************************************************/
+void CoverIndex::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mDirs.clear();
+    mTrees.clear();
+    mImages.clear();
+}
@@ -0,0 +1,93 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef COVERINDEX_H
+#define COVERINDEX_H
+
+#include <QDateTime>
+#include <QFileInfoList>
+#include <QHash>
+#include <QMutex>
+#include <QSize>
+#include <QStringList>
+
+/************************************************
+ * Cache of the directory listings, the image lists
+ * and the image sizes for the cover search, shared
+ * by all discs. The directory is listed again when
+ * its mtime is changed, the image list is built
+ * again when the mtime of any directory in the tree
+ * is changed, the image size is read again when the
+ * file size or mtime is changed.
+ * All methods are thread safe.
+ ************************************************/
+class CoverIndex
+{
+public:
+    static CoverIndex *instance();
+
+    // The images in the startDir and all subdirectories,
+    // the most probable covers come first.
+    QStringList images(const QString &startDir);
+
+    // Reads only the image header, returns the invalid
+    // size if the file is not an image.
+    QSize imageSize(const QString &fileName);
+
+    void clear();
+
+private:
+    struct Dir
+    {
+        QDateTime     mtime;
+        QFileInfoList dirs;
+        QFileInfoList files;
+    };
+
+    struct Tree
+    {
+        QHash<QString, QDateTime> dirs;
+        QStringList               images;
+    };
+
+    struct Image
+    {
+        qint64    fileSize = 0;
+        QDateTime mtime;
+        QSize     size;
+    };
+
+    CoverIndex() = default;
+
+    QMutex                mMutex;
+    QHash<QString, Dir>   mDirs;
+    QHash<QString, Tree>  mTrees;
+    QHash<QString, Image> mImages;
+
+    Dir  listDir(const QString &path);
+    bool isActual(const Tree &tree) const;
+};
+
+#endif // COVERINDEX_H
@@ -0,0 +1,161 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "cueindex.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QLoggingCategory>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "CueIndex")
+}
+
+/************************************************
+ *
+ ************************************************/
+CueIndex *CueIndex::instance()
+{
+    static CueIndex *res = new CueIndex();
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+QSharedPointer<CueIndex::Dir> CueIndex::dir(const QString &path)
+{
+    QMutexLocker locker(&mMutex);
+
+    QSharedPointer<Dir> &res = mDirs[path];
+    if (!res) {
+        res.reset(new Dir());
+    }
+    return res;
+}
+
+/************************************************
+ * Called with the locked dir mutex. The CUE files
+ * are parsed only once, the broken files are
+ * remembered too.
+ ************************************************/
+void CueIndex::refresh(Dir *dir, const QString &path)
+{
+    QDateTime mtime = QFileInfo(path).lastModified();
+    if (!dir->mtime.isValid() || dir->mtime != mtime) {
+        qCDebug(LOG) << "List directory" << path;
+        dir->mtime      = mtime;
+        dir->audioFiles = AudioFileMatcher::listAudioFiles(path);
+
+        dir->cueFiles.clear();
+        for (const QFileInfo &fi : QDir(path).entryInfoList(QStringList("*.cue"), QDir::Files | QDir::Readable)) {
+            dir->cueFiles << fi.absoluteFilePath();
+        }
+
+        // The matchers depend on the audio files list
+        dir->cues.clear();
+    }
+
+    for (const QString &file : qAsConst(dir->cueFiles)) {
+        QFileInfo  fi(file);
+        CueRecord &rec = dir->cues[file];
+        if (rec.mtime.isValid() && rec.mtime == fi.lastModified() && rec.size == fi.size()) {
+            continue;
+        }
+
+        qCDebug(LOG) << "Parse" << file;
+        rec.size  = fi.size();
+        rec.mtime = fi.lastModified();
+        try {
+            rec.cue     = Cue(file);
+            rec.matcher = AudioFileMatcher(rec.cue.filePath(), rec.cue.tracks(), dir->audioFiles);
+            rec.valid   = true;
+        }
+        catch (FlaconError &) {
+            rec.valid = false; // Just skipping the incorrect files.
+        }
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+QList<CueIndex::Entry> CueIndex::cues(const QString &path)
+{
+    QSharedPointer<Dir> d = dir(path);
+    QMutexLocker        locker(&d->mutex);
+    refresh(d.data(), path);
+
+    QList<Entry> res;
+    for (const QString &file : qAsConst(d->cueFiles)) {
+        const CueRecord &rec = d->cues[file];
+        if (rec.valid) {
+            res << Entry { rec.cue, rec.matcher };
+        }
+    }
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+QFileInfoList CueIndex::audioFiles(const QString &path)
+{
+    QSharedPointer<Dir> d = dir(path);
+    QMutexLocker        locker(&d->mutex);
+    refresh(d.data(), path);
+    return d->audioFiles;
+}
+
+/************************************************
+ *
+ ************************************************/
+AudioFileMatcher CueIndex::matcher(const Cue &cue)
+{
+    if (cue.isEmbedded()) {
+        return AudioFileMatcher(cue.filePath(), cue.tracks());
+    }
+
+    QString             path = QFileInfo(cue.filePath()).dir().absolutePath();
+    QSharedPointer<Dir> d    = dir(path);
+    QMutexLocker        locker(&d->mutex);
+    refresh(d.data(), path);
+
+    auto it = d->cues.constFind(cue.filePath());
+    if (it != d->cues.constEnd() && it->valid) {
+        return it->matcher;
+    }
+
+    return AudioFileMatcher(cue.filePath(), cue.tracks(), d->audioFiles);
+}
+
+/************************************************
+ *
+ ************************************************/
+void CueIndex::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mDirs.clear();
+}
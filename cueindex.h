@@ -0,0 +1,96 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef CUEINDEX_H
+#define CUEINDEX_H
+
+#include "cue.h"
+#include "audiofilematcher.h"
+
+#include <QDateTime>
+#include <QFileInfoList>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+
+/************************************************
+ * Per-directory cache of the audio files list, the
+ * parsed CUE files and their AudioFileMatchers.
+ * The directory is listed again when its mtime is
+ * changed, the CUE file is parsed again when its
+ * size or mtime is changed.
+ * All methods are thread safe.
+ ************************************************/
+class CueIndex
+{
+public:
+    struct Entry
+    {
+        Cue              cue;
+        AudioFileMatcher matcher;
+    };
+
+    static CueIndex *instance();
+
+    // The correct CUE files in the directory, sorted by name.
+    QList<Entry> cues(const QString &dir);
+
+    QFileInfoList audioFiles(const QString &dir);
+
+    // The cached matcher for the indexed CUE file, for other
+    // CUE the matcher uses the cached audio files list.
+    AudioFileMatcher matcher(const Cue &cue);
+
+    void clear();
+
+private:
+    struct CueRecord
+    {
+        qint64           size = 0;
+        QDateTime        mtime;
+        bool             valid = false;
+        Cue              cue;
+        AudioFileMatcher matcher;
+    };
+
+    struct Dir
+    {
+        QMutex                    mutex;
+        QDateTime                 mtime;
+        QFileInfoList             audioFiles;
+        QStringList               cueFiles;
+        QHash<QString, CueRecord> cues;
+    };
+
+    CueIndex() = default;
+
+    QMutex                              mMutex;
+    QHash<QString, QSharedPointer<Dir>> mDirs;
+
+    QSharedPointer<Dir> dir(const QString &path);
+    void                refresh(Dir *dir, const QString &path);
+};
+
+#endif // CUEINDEX_H
@@ -31,13 +31,14 @@
 #include "formats_in/informat.h"
 #include "formats_out/outformat.h"
 #include "audiofilematcher.h"
+#include "cueindex.h"
+#include "coverindex.h"
 
 #include "assert.h"
 #include <QTextCodec>
 #include <QFileInfo>
 #include <QStringList>
 #include <QDir>
-#include <QQueue>
 #include <QtAlgorithms>
 #include <QDebug>
 #include <QLoggingCategory>
@@ -111,7 +112,7 @@ void Disc::searchCueFile(bool replaceExisting)
 
     // Embedded CUE ........................
     try {
-        QByteArray embeddedCue = this->audioFiles().first().format()->readEmbeddedCue(this->audioFilePaths().first());
+        QByteArray embeddedCue = this->audioFiles().first().embeddedCue();
         if (!embeddedCue.isEmpty()) {
             QBuffer buf(&embeddedCue);
             buf.open(QBuffer::ReadOnly);
@@ -125,28 +126,17 @@ void Disc::searchCueFile(bool replaceExisting)
 
     // Serarch CUE files ...................
 
-    QFileInfo     audioFile = QFileInfo(audioFiles.first());
-    QList<Cue>    cues;
-    QFileInfoList files = audioFile.dir().entryInfoList(QStringList("*.cue"), QDir::Files | QDir::Readable);
-    foreach (QFileInfo f, files) {
-        try {
-            cues << Cue(f.absoluteFilePath());
-        }
-        catch (FlaconError &) {
-            continue; // Just skipping the incorrect files.
-        }
-    }
+    QFileInfo audioFile = QFileInfo(audioFiles.first());
 
     unsigned int bestWeight = 99999;
     Cue          bestDisc;
 
-    foreach (const Cue &cue, cues) {
-        AudioFileMatcher matcher(cue.filePath(), cue.tracks());
-        if (matcher.containsAudioFile(audioFile.filePath())) {
-            unsigned int weight = levenshteinDistance(QFileInfo(cue.filePath()).baseName(), audioFile.baseName());
+    for (const CueIndex::Entry &entry : CueIndex::instance()->cues(audioFile.dir().absolutePath())) {
+        if (entry.matcher.containsAudioFile(audioFile.filePath())) {
+            unsigned int weight = levenshteinDistance(QFileInfo(entry.cue.filePath()).baseName(), audioFile.baseName());
             if (weight < bestWeight) {
                 bestWeight = weight;
-                bestDisc   = cue;
+                bestDisc   = entry.cue;
             }
         }
     }
@@ -167,7 +157,7 @@ void Disc::searchAudioFiles(bool replaceExisting)
     qCDebug(LOG_SEARCH_AUDIO_FILES) << "fullPath=" << fullPath;
     qCDebug(LOG_SEARCH_AUDIO_FILES) << "Audio files=" << audioFileNames();
 
-    AudioFileMatcher matcher(fullPath, mCue.tracks());
+    AudioFileMatcher matcher = CueIndex::instance()->matcher(mCue);
     for (int i = 0; i < audioFiles().count(); ++i) {
         if (audioFiles()[i].isNull() || replaceExisting) {
 
@@ -750,116 +740,30 @@ void Disc::setDiscTag(TagId tagId, const QByteArray &value)
         track->setTag(tagId, value);
 }
 
-/************************************************
-
- ************************************************/
-bool compareCoverImages(const QFileInfo &f1, const QFileInfo &f2)
-{
-    const static QStringList order(QStringList()
-                                   << "COVER"
-                                   << "FRONT"
-                                   << "FOLDER");
-
-    QString f1up = f1.baseName().toUpper();
-    QString f2up = f2.baseName().toUpper();
-
-    int n1 = 9999;
-    int n2 = 9999;
-
-    for (int i = 0; i < order.count(); ++i) {
-        const QString &pattern = order.at(i);
-
-        // complete match ..................
-        if (f1up == pattern) {
-            n1 = i;
-        }
-
-        if (f2up == pattern) {
-            n2 = i;
-        }
-
-        // filename contains pattern .......
-        if (f1up.contains(pattern)) {
-            n1 = i + order.count();
-        }
-
-        if (f2up.contains(pattern)) {
-            n2 = i + order.count();
-        }
-    }
-
-    if (n1 != n2)
-        return n1 < n2;
-
-    // If we have 2 files with same name but in different directories,
-    // we choose the nearest (with the shorter path).
-    int l1 = f1.absoluteFilePath().length();
-    int l2 = f2.absoluteFilePath().length();
-    if (l1 != l2)
-        return l1 < l2;
-
-    return f1.absoluteFilePath() < f2.absoluteFilePath();
-}
-
 /************************************************
 
  ************************************************/
 QStringList Disc::searchCoverImages(const QString &startDir)
 {
-    QFileInfoList files;
-
-    QStringList exts;
-    exts << "*.jpg";
-    exts << "*.jpeg";
-    exts << "*.png";
-    exts << "*.bmp";
-    exts << "*.tiff";
-
-    QQueue<QString> query;
-    query << startDir;
-
-    QSet<QString> processed;
-    while (!query.isEmpty()) {
-        QDir dir(query.dequeue());
-
-        QFileInfoList dirs = dir.entryInfoList(QDir::Dirs | QDir::Readable | QDir::NoDotAndDotDot);
-        foreach (QFileInfo d, dirs) {
-            if (d.isSymLink())
-                d = QFileInfo(d.symLinkTarget());
-
-            if (!processed.contains(d.absoluteFilePath())) {
-                processed << d.absoluteFilePath();
-                query << d.absoluteFilePath();
-            }
-        }
-
-        files << dir.entryInfoList(exts, QDir::Files | QDir::Readable);
-    }
-
-    std::stable_sort(files.begin(), files.end(), compareCoverImages);
-
-    QStringList res;
-    foreach (QFileInfo f, files)
-        res << f.absoluteFilePath();
-
-    return res;
+    return CoverIndex::instance()->images(startDir);
 }
 
 /************************************************
-
+ Only the image headers are read, the sizes and
+ the directory listings are shared by all discs.
  ************************************************/
 QString Disc::searchCoverImage(const QString &startDir)
 {
     QString res;
 
     for (const QString &file : searchCoverImages(startDir)) {
-        QImage img(file);
+        QSize size = CoverIndex::instance()->imageSize(file);
 
-        if (img.isNull()) {
+        if (size.isEmpty()) {
             continue;
         }
 
-        double ratio = double(img.width()) / double(img.height());
+        double ratio = double(size.width()) / double(size.height());
 
         if (std::abs(1 - ratio) < 0.2) {
             return file;
@@ -0,0 +1,268 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "flacmetadata.h"
+#include "types.h"
+
+#include <QIODevice>
+#include <QtEndian>
+
+static constexpr int STREAMINFO     = 0;
+static constexpr int VORBIS_COMMENT = 4;
+static constexpr int CUESHEET       = 5;
+static constexpr int PICTURE        = 6;
+static constexpr int INVALID        = 127;
+
+static constexpr int STREAMINFO_SIZE = 34;
+
+/************************************************
+ *
+ ************************************************/
+static QByteArray mustRead(QIODevice *device, qint64 size)
+{
+    QByteArray res = device->read(size);
+    if (res.size() != size) {
+        throw FlaconError("Broken FLAC metadata");
+    }
+    return res;
+}
+
+/************************************************
+ * Some taggers put the ID3v2 tag before the FLAC
+ * stream. The tag size is syncsafe, 7 bits per
+ * byte, without the 10 bytes header and footer.
+ ************************************************/
+static void skipId3v2(QIODevice *device)
+{
+    const qint64     start = device->pos();
+    const QByteArray hdr   = device->peek(10);
+    if (hdr.size() < 10 || !hdr.startsWith("ID3")) {
+        return;
+    }
+
+    const uchar *p    = reinterpret_cast<const uchar *>(hdr.constData());
+    qint64       size = (p[6] & 0x7F) << 21 | (p[7] & 0x7F) << 14 | (p[8] & 0x7F) << 7 | (p[9] & 0x7F);
+    size += 10;
+    if (p[5] & 0x10) {
+        size += 10; // Footer
+    }
+
+    if (!device->seek(start + size)) {
+        throw FlaconError("Broken ID3v2 tag");
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+FlacMetadata::FlacMetadata(QIODevice *device)
+{
+    skipId3v2(device);
+
+    if (mustRead(device, 4) != "fLaC") {
+        throw FlaconError("Not a FLAC stream");
+    }
+
+    bool last = false;
+    while (!last) {
+        QByteArray   hdr  = mustRead(device, 4);
+        const uchar *p    = reinterpret_cast<const uchar *>(hdr.constData());
+        int          type = p[0] & 0x7F;
+        qint64       size = qFromBigEndian<quint32>(p) & 0x00FFFFFF;
+        qint64       end  = device->pos() + size;
+        last              = p[0] & 0x80;
+
+        switch (type) {
+            case STREAMINFO:
+                readStreamInfo(mustRead(device, size));
+                break;
+
+            case VORBIS_COMMENT:
+                readVorbisComment(mustRead(device, size));
+                break;
+
+            case CUESHEET:
+                mCueSheetBlock = mustRead(device, size);
+                break;
+
+            case PICTURE:
+                readPictureHeader(device, end);
+                break;
+
+            case INVALID:
+                throw FlaconError("Broken FLAC metadata");
+        }
+
+        if (!device->seek(end)) {
+            throw FlaconError("Broken FLAC metadata");
+        }
+    }
+
+    if (mStreamInfo.sampleRate == 0) {
+        throw FlaconError("FLAC STREAMINFO block not found");
+    }
+
+    mAudioOffset = device->pos();
+}
+
+/************************************************
+ *  16 bits  min block size
+ *  16 bits  max block size
+ *  24 bits  min frame size
+ *  24 bits  max frame size
+ *  20 bits  sample rate
+ *   3 bits  channels - 1
+ *   5 bits  bits per sample - 1
+ *  36 bits  total samples, 0 if unknown
+ *  128 bits MD5
+ ************************************************/
+void FlacMetadata::readStreamInfo(const QByteArray &data)
+{
+    if (data.size() < STREAMINFO_SIZE) {
+        throw FlaconError("Broken FLAC STREAMINFO block");
+    }
+
+    quint64 v = qFromBigEndian<quint64>(reinterpret_cast<const uchar *>(data.constData()) + 10);
+
+    mStreamInfo.sampleRate    = quint32(v >> 44);
+    mStreamInfo.channelsCount = uint((v >> 41) & 0x07) + 1;
+    mStreamInfo.bitsPerSample = int((v >> 36) & 0x1F) + 1;
+    mStreamInfo.totalSamples  = v & 0xFFFFFFFFFull;
+}
+
+/************************************************
+ * Unlike the rest of FLAC, the Vorbis comment
+ * is little-endian:
+ *   vendor length, vendor string,
+ *   comments count, [length, "KEY=VALUE"] ...
+ * The broken comment block is ignored.
+ ************************************************/
+void FlacMetadata::readVorbisComment(const QByteArray &data)
+{
+    const uchar *p   = reinterpret_cast<const uchar *>(data.constData());
+    const qint64 end = data.size();
+    qint64       pos = 0;
+
+    auto readLen = [&]() -> qint64 {
+        if (pos + 4 > end) {
+            return -1;
+        }
+        qint64 res = qFromLittleEndian<quint32>(p + pos);
+        pos += 4;
+        return res;
+    };
+
+    qint64 len = readLen();
+    if (len < 0 || pos + len > end) {
+        return;
+    }
+    pos += len; // Vendor
+
+    qint64 count = readLen();
+    for (qint64 i = 0; i < count; ++i) {
+        len = readLen();
+        if (len < 0 || pos + len > end) {
+            return;
+        }
+
+        QByteArray comment = data.mid(pos, len);
+        pos += len;
+
+        int n = comment.indexOf('=');
+        if (n > 0) {
+            mComments << qMakePair(comment.left(n).toUpper(), comment.mid(n + 1));
+        }
+    }
+}
+
+/************************************************
+ *   32 bits  picture type
+ *   32 bits  MIME type length, MIME type
+ *   32 bits  description length, description UTF-8
+ *   32 bits  width
+ *   32 bits  height
+ *   32 bits  color depth
+ *   32 bits  number of colors
+ *   32 bits  data length, data
+ ************************************************/
+void FlacMetadata::readPictureHeader(QIODevice *device, qint64 blockEnd)
+{
+    auto readUInt32 = [device]() {
+        QByteArray d = mustRead(device, 4);
+        return qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(d.constData()));
+    };
+
+    auto readString = [device, blockEnd, readUInt32]() {
+        quint32 len = readUInt32();
+        if (device->pos() + len > blockEnd) {
+            throw FlaconError("Broken FLAC PICTURE block");
+        }
+        return mustRead(device, len);
+    };
+
+    Picture pic;
+    pic.type        = readUInt32();
+    pic.mimeType    = QString::fromLatin1(readString());
+    pic.description = QString::fromUtf8(readString());
+    pic.width       = readUInt32();
+    pic.height      = readUInt32();
+    readUInt32(); // Color depth
+    readUInt32(); // Number of colors
+    pic.dataSize   = readUInt32();
+    pic.dataOffset = device->pos();
+
+    if (pic.dataOffset + pic.dataSize > blockEnd) {
+        throw FlaconError("Broken FLAC PICTURE block");
+    }
+
+    mPictures << pic;
+}
+
+/************************************************
+ *
+ ************************************************/
+QByteArray FlacMetadata::readPicture(QIODevice *device, const Picture &picture)
+{
+    if (!device->seek(picture.dataOffset)) {
+        return QByteArray();
+    }
+
+    QByteArray res = device->read(picture.dataSize);
+    return res.size() == picture.dataSize ? res : QByteArray();
+}
+
+/************************************************
+ *
+ ************************************************/
+QByteArray FlacMetadata::comment(const QByteArray &key) const
+{
+    const QByteArray k = key.toUpper();
+    for (const auto &c : mComments) {
+        if (c.first == k) {
+            return c.second;
+        }
+    }
+    return QByteArray();
+}
@@ -0,0 +1,98 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef FLACMETADATA_H
+#define FLACMETADATA_H
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+class QIODevice;
+
+/************************************************
+ * Walks the FLAC metadata blocks once. The picture
+ * data is not loaded, only its position is stored,
+ * see readPicture().
+ ************************************************/
+class FlacMetadata
+{
+public:
+    struct StreamInfo
+    {
+        quint32 sampleRate    = 0;
+        int     bitsPerSample = 0;
+        uint    channelsCount = 0;
+        quint64 totalSamples  = 0; // 0 if unknown
+    };
+
+    struct Picture
+    {
+        quint32 type = 0; // ID3v2 APIC picture type, 3 is the front cover
+        QString mimeType;
+        QString description;
+        quint32 width      = 0;
+        quint32 height     = 0;
+        qint64  dataOffset = 0;
+        qint64  dataSize   = 0;
+    };
+
+    FlacMetadata() = default;
+    explicit FlacMetadata(QIODevice *device) noexcept(false);
+
+    const StreamInfo &streamInfo() const { return mStreamInfo; }
+
+    // The key is case insensitive, returns the first value.
+    QByteArray comment(const QByteArray &key) const;
+
+    const QList<QPair<QByteArray, QByteArray>> &comments() const { return mComments; }
+
+    // The CUESHEET Vorbis comment, the text form used by the most programs.
+    QByteArray cueSheet() const { return comment("CUESHEET"); }
+
+    // The raw CUESHEET metadata block.
+    const QByteArray &cueSheetBlock() const { return mCueSheetBlock; }
+
+    const QList<Picture> &pictures() const { return mPictures; }
+
+    // The position of the first audio frame.
+    qint64 audioOffset() const { return mAudioOffset; }
+
+    static QByteArray readPicture(QIODevice *device, const Picture &picture);
+
+private:
+    StreamInfo                           mStreamInfo;
+    QList<QPair<QByteArray, QByteArray>> mComments;
+    QByteArray                           mCueSheetBlock;
+    QList<Picture>                       mPictures;
+    qint64                               mAudioOffset = 0;
+
+    void readStreamInfo(const QByteArray &data);
+    void readVorbisComment(const QByteArray &data);
+    void readPictureHeader(QIODevice *device, qint64 blockEnd);
+};
+
+#endif // FLACMETADATA_H
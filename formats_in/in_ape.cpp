@@ -24,6 +24,8 @@
  * END_COMMON_COPYRIGHT_HEADER */
 
 #include "in_ape.h"
+#include <QIODevice>
+#include <QtEndian>
 
 REGISTER_INPUT_FORMAT(Format_Ape)
 
@@ -56,3 +58,61 @@ QString Format_Ape::filterDecoderStderr(const QString &stdErr) const
 
     return stdErr;
 }
+
+/************************************************
+ * APE_DESCRIPTOR, since version 3.98:
+ *   char     cID[4];                "MAC "
+ *   uint16_t nVersion;
+ *   uint16_t nPadding;
+ *   uint32_t nDescriptorBytes;
+ *   ...
+ * APE_HEADER at nDescriptorBytes:
+ *   uint16_t nCompressionLevel;
+ *   uint16_t nFormatFlags;
+ *   uint32_t nBlocksPerFrame;
+ *   uint32_t nFinalFrameBlocks;
+ *   uint32_t nTotalFrames;
+ *   uint16_t nBitsPerSample;
+ *   uint16_t nChannels;
+ *   uint32_t nSampleRate;
+ *
+ * The older files are left to the decoder.
+ ************************************************/
+bool Format_Ape::probeHeader(QIODevice *device, HeaderInfo *info) const
+{
+    static constexpr int DESCRIPTOR_MIN_VERSION = 3980;
+    static constexpr int HEADER_SIZE            = 24;
+
+    const QByteArray data = device->read(PROBE_SIZE);
+
+    if (data.size() < 12 || !data.startsWith(magic())) {
+        return false;
+    }
+
+    const uchar *p       = reinterpret_cast<const uchar *>(data.constData());
+    quint16      version = qFromLittleEndian<quint16>(p + 4);
+    if (version < DESCRIPTOR_MIN_VERSION) {
+        return false;
+    }
+
+    quint32 descriptorBytes = qFromLittleEndian<quint32>(p + 8);
+    if (descriptorBytes < 12 || data.size() < qint64(descriptorBytes) + HEADER_SIZE) {
+        return false;
+    }
+
+    const uchar *hdr             = p + descriptorBytes;
+    quint32      blocksPerFrame  = qFromLittleEndian<quint32>(hdr + 4);
+    quint32      finalFrameBlock = qFromLittleEndian<quint32>(hdr + 8);
+    quint32      totalFrames     = qFromLittleEndian<quint32>(hdr + 12);
+
+    if (totalFrames == 0) {
+        return false;
+    }
+
+    info->bitsPerSample = qFromLittleEndian<quint16>(hdr + 16);
+    info->channelsCount = qFromLittleEndian<quint16>(hdr + 18);
+    info->sampleRate    = qFromLittleEndian<quint32>(hdr + 20);
+    info->totalSamples  = quint64(totalFrames - 1) * blocksPerFrame + finalFrameBlock;
+
+    return info->totalSamples > 0;
+}
@@ -40,6 +40,8 @@ public:
     virtual QString     decoderProgramName() const override { return "mac"; }
     virtual QStringList decoderArgs(const QString &fileName) const override;
     virtual QString     filterDecoderStderr(const QString &stdErr) const override;
+
+    bool probeHeader(QIODevice *device, HeaderInfo *info) const override;
 };
 
 #endif // IN_APE_H
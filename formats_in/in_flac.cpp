@@ -24,9 +24,15 @@
  * END_COMMON_COPYRIGHT_HEADER */
 
 #include "in_flac.h"
+#include "flacmetadata.h"
+#include "types.h"
 #include <QDebug>
-#include <taglib/flacfile.h>
-#include <taglib/xiphcomment.h>
+#include <QFile>
+#include <QLoggingCategory>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "FormatFlac")
+}
 
 REGISTER_INPUT_FORMAT(Format_Flac)
 
@@ -51,25 +57,40 @@ QStringList Format_Flac::decoderArgs(const QString &fileName) const
  ************************************************/
 QByteArray Format_Flac::readEmbeddedCue(const QString &fileName) const
 {
-    TagLib::FLAC::File file(fileName.toLocal8Bit().data());
-    if (!file.isOpen()) {
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
         return QByteArray();
     }
 
-    TagLib::Ogg::XiphComment *comment = file.xiphComment(false);
-    if (!comment) {
+    try {
+        return FlacMetadata(&file).cueSheet();
+    }
+    catch (const FlaconError &err) {
+        qCWarning(LOG) << "Can't read embedded CUE from" << fileName << ":" << err.what();
         return QByteArray();
     }
+}
 
-    const TagLib::Ogg::FieldListMap &tags = comment->fieldListMap();
-
-    static constexpr auto CUE_SHEET_TAGS = { "CUESHEET", "cuesheet" };
+/************************************************
+ * All metadata blocks are read in one pass, so
+ * the embedded CUE comes for free.
+ ************************************************/
+bool Format_Flac::probeHeader(QIODevice *device, HeaderInfo *info) const
+{
+    try {
+        FlacMetadata meta(device);
 
-    for (auto key : CUE_SHEET_TAGS) {
-        if (tags.contains(key)) {
-            return QByteArray(tags[key].front().toCString(true));
-        }
+        info->sampleRate    = meta.streamInfo().sampleRate;
+        info->bitsPerSample = meta.streamInfo().bitsPerSample;
+        info->channelsCount = meta.streamInfo().channelsCount;
+        info->totalSamples  = meta.streamInfo().totalSamples;
+        info->embeddedCue   = meta.cueSheet();
+    }
+    catch (const FlaconError &err) {
+        // The caller falls back to the decoder, so it is not an error
+        qCDebug(LOG) << "Can't probe the header:" << err.what();
+        return false;
     }
 
-    return QByteArray();
+    return info->sampleRate > 0 && info->totalSamples > 0;
 }
@@ -41,6 +41,8 @@ public:
     virtual uint       magicOffset() const override { return 0; }
 
     QByteArray readEmbeddedCue(const QString &fileName) const override;
+
+    bool probeHeader(QIODevice *device, HeaderInfo *info) const override;
 };
 
 #endif // IN_FLAC_H
@@ -25,6 +25,8 @@
 
 #include "in_tta.h"
 #include <QDebug>
+#include <QIODevice>
+#include <QtEndian>
 
 REGISTER_INPUT_FORMAT(Format_Tta)
 
@@ -54,3 +56,33 @@ QString Format_Tta::filterDecoderStderr(const QString &stdErr) const
 
     return "";
 }
+
+/************************************************
+ * TTA1 header:
+ *   char     signature[4];  "TTA1"
+ *   uint16_t format;
+ *   uint16_t channels;
+ *   uint16_t bitsPerSample;
+ *   uint32_t sampleRate;
+ *   uint32_t dataLength;    in samples
+ *   uint32_t crc32;
+ ************************************************/
+bool Format_Tta::probeHeader(QIODevice *device, HeaderInfo *info) const
+{
+    static constexpr int HEADER_SIZE = 22;
+
+    const QByteArray data = device->read(PROBE_SIZE);
+
+    if (data.size() < HEADER_SIZE || !data.startsWith(magic())) {
+        return false;
+    }
+
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+
+    info->channelsCount = qFromLittleEndian<quint16>(p + 6);
+    info->bitsPerSample = qFromLittleEndian<quint16>(p + 8);
+    info->sampleRate    = qFromLittleEndian<quint32>(p + 10);
+    info->totalSamples  = qFromLittleEndian<quint32>(p + 14);
+
+    return info->totalSamples > 0;
+}
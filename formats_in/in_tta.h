@@ -39,6 +39,8 @@ public:
     virtual QString     decoderProgramName() const override { return "ttaenc"; }
     virtual QStringList decoderArgs(const QString &fileName) const override;
     virtual QString     filterDecoderStderr(const QString &stdErr) const override;
+
+    bool probeHeader(QIODevice *device, HeaderInfo *info) const override;
 };
 
 #endif // IN_TTA_H
@@ -24,6 +24,8 @@
  * END_COMMON_COPYRIGHT_HEADER */
 
 #include "in_wv.h"
+#include <QIODevice>
+#include <QtEndian>
 
 REGISTER_INPUT_FORMAT(Format_Wv)
 
@@ -50,3 +52,74 @@ QStringList Format_Wv::decoderArgs(const QString &fileName) const
 
     return args;
 }
+
+/************************************************
+ * The first block header, 32 bytes:
+ *   char     ckID[4];          "wvpk"
+ *   uint32_t ckSize;
+ *   uint16_t version;
+ *   uint8_t  block_index_u8;
+ *   uint8_t  total_samples_u8; upper 8 bits of the total samples
+ *   uint32_t total_samples;    lower 32 bits, -1 if unknown
+ *   uint32_t block_index;
+ *   uint32_t block_samples;
+ *   uint32_t flags;
+ *   uint32_t crc;
+ *
+ * The multichannel, DSD, float and custom rate
+ * streams are left to the decoder.
+ ************************************************/
+bool Format_Wv::probeHeader(QIODevice *device, HeaderInfo *info) const
+{
+    static constexpr int     HEADER_SIZE   = 32;
+    static constexpr quint32 BYTES_STORED  = 0x00000003;
+    static constexpr quint32 MONO_FLAG     = 0x00000004;
+    static constexpr quint32 FLOAT_DATA    = 0x00000080;
+    static constexpr quint32 INITIAL_BLOCK = 0x00000800;
+    static constexpr quint32 FINAL_BLOCK   = 0x00001000;
+    static constexpr int     SHIFT_LSB     = 13;
+    static constexpr quint32 SHIFT_MASK    = 0x1F << SHIFT_LSB;
+    static constexpr int     SRATE_LSB     = 23;
+    static constexpr quint32 SRATE_MASK    = 0x0F << SRATE_LSB;
+    static constexpr quint32 DSD_FLAG      = 0x80000000;
+
+    static constexpr quint32 SAMPLE_RATES[] = { 6000, 8000, 9600, 11025, 12000, 16000, 22050, 24000,
+                                                32000, 44100, 48000, 64000, 88200, 96000, 192000 };
+
+    const QByteArray data = device->read(PROBE_SIZE);
+
+    int pos = data.indexOf(magic());
+    if (pos < 0 || data.size() < pos + HEADER_SIZE) {
+        return false;
+    }
+
+    const uchar *hdr   = reinterpret_cast<const uchar *>(data.constData()) + pos;
+    quint32      flags = qFromLittleEndian<quint32>(hdr + 24);
+
+    if ((flags & (INITIAL_BLOCK | FINAL_BLOCK)) != (INITIAL_BLOCK | FINAL_BLOCK)) {
+        return false;
+    }
+
+    if (flags & (FLOAT_DATA | DSD_FLAG)) {
+        return false;
+    }
+
+    quint32 rateIndex = (flags & SRATE_MASK) >> SRATE_LSB;
+    if (rateIndex >= sizeof(SAMPLE_RATES) / sizeof(SAMPLE_RATES[0])) {
+        return false;
+    }
+
+    quint32 totalLow = qFromLittleEndian<quint32>(hdr + 12);
+    if (totalLow == 0xFFFFFFFF) {
+        return false;
+    }
+
+    int bytesPerSample = int(flags & BYTES_STORED) + 1;
+
+    info->sampleRate    = SAMPLE_RATES[rateIndex];
+    info->channelsCount = (flags & MONO_FLAG) ? 1 : 2;
+    info->bitsPerSample = bytesPerSample * 8 - int((flags & SHIFT_MASK) >> SHIFT_LSB);
+    info->totalSamples  = (quint64(hdr[11]) << 32) + totalLow;
+
+    return info->totalSamples > 0;
+}
@@ -39,6 +39,8 @@ public:
     virtual QString     decoderProgramName() const override { return "wvunpack"; }
     virtual QStringList decoderArgs(const QString &fileName) const override;
 
+    bool probeHeader(QIODevice *device, HeaderInfo *info) const override;
+
 protected:
     virtual bool checkMagic(const QByteArray &data) const override;
 };
@@ -110,6 +110,14 @@ QByteArray InputFormat::readEmbeddedCue(const QString &) const
     return QByteArray();
 }
 
+/************************************************
+ *
+ ************************************************/
+bool InputFormat::probeHeader(QIODevice *, HeaderInfo *) const
+{
+    return false;
+}
+
 /************************************************
  *
  ************************************************/
@@ -38,6 +38,18 @@ typedef QList<const InputFormat *> AudioFormatList;
 class InputFormat
 {
 public:
+    struct HeaderInfo
+    {
+        quint32 sampleRate    = 0;
+        int     bitsPerSample = 0;
+        uint    channelsCount = 0;
+        quint64 totalSamples  = 0;
+
+        // Filled by the formats that keep the CUE inside the file
+        // and can read it in the same pass.
+        QByteArray embeddedCue;
+    };
+
     InputFormat();
     virtual ~InputFormat();
 
@@ -65,6 +77,14 @@ public:
 
     virtual QByteArray readEmbeddedCue(const QString &fileName) const;
 
+    // Reads the audio parameters from the file header, without running
+    // the decoder program. The device is positioned at the start of the
+    // file, most formats need only the first PROBE_SIZE bytes. Returns
+    // false if the format has no native probe or the header is not
+    // supported, then the caller should use the decoder.
+    static constexpr int PROBE_SIZE = 4096;
+    virtual bool         probeHeader(QIODevice *device, HeaderInfo *info) const;
+
 protected:
     virtual bool checkMagic(const QByteArray &data) const;
 };
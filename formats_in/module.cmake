@@ -7,6 +7,8 @@ list(APPEND SOURCES
 
     ${CMAKE_CURRENT_LIST_DIR}/in_flac.h
     ${CMAKE_CURRENT_LIST_DIR}/in_flac.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/flacmetadata.h
+    ${CMAKE_CURRENT_LIST_DIR}/flacmetadata.cpp
 
     ${CMAKE_CURRENT_LIST_DIR}/in_tta.h
     ${CMAKE_CURRENT_LIST_DIR}/in_tta.cpp
@@ -78,6 +78,7 @@ QHash<QString, QVariant> OutFormat_Flac::defaultParameters() const
     QHash<QString, QVariant> res;
     res.insert("Compression", 5);
     res.insert("ReplayGain", gainTypeToString(GainType::Disable));
+    res.insert("SmartSplit", false);
     return res;
 }
 
@@ -123,6 +124,7 @@ ConfigPage_Flac::ConfigPage_Flac(QWidget *parent) :
 void ConfigPage_Flac::load(const Profile &profile)
 {
     loadWidget(profile, "Compression", flacCompressionSlider);
+    loadWidget(profile, "SmartSplit", flacSmartSplitCheck);
 }
 
 /************************************************
@@ -131,4 +133,5 @@ void ConfigPage_Flac::load(const Profile &profile)
 void ConfigPage_Flac::save(Profile *profile)
 {
     saveWidget(profile, "Compression", flacCompressionSlider);
+    saveWidget(profile, "SmartSplit", flacSmartSplitCheck);
 }
@@ -55,6 +55,7 @@
 #include <QStyleFactory>
 #include <QToolBar>
 #include <QToolButton>
+#include <QMenu>
 #include <QStandardPaths>
 
 #ifdef MAC_UPDATER
@@ -163,6 +164,10 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(outProfileCombo, qOverload<int>(&QComboBox::currentIndexChanged),
             this, &MainWindow::setOutProfile);
 
+    outProfileCombo->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(outProfileCombo, &QComboBox::customContextMenuRequested,
+            this, &MainWindow::showOutProfileMenu);
+
     connect(codepageCombo, qOverload<int>(&QComboBox::currentIndexChanged),
             this, &MainWindow::setCodePage);
 
@@ -187,6 +192,19 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(project, &Project::discChanged, this, &MainWindow::refreshEdits);
     connect(project, &Project::discChanged, this, &MainWindow::setControlsEnable);
 
+    connect(project, &Project::discLoaded, this, [this](Disc *disc) {
+        if (mSelectLoadedDisc) {
+            mSelectLoadedDisc = false;
+            this->trackView->selectDisc(disc);
+        }
+    });
+
+    connect(project, &Project::loadProgress, this, [this](int loaded, int total) {
+        statusbar->showMessage(tr("Loading discs: %1 of %2", "Status bar message").arg(loaded).arg(total));
+    });
+
+    connect(project, &Project::loadFinished, this, &MainWindow::scanFinished);
+
     connect(Application::instance(), &Application::visualModeChanged,
             []() {
                 Icon::setDarkMode(Application::instance()->isDarkVisualMode());
@@ -240,6 +258,11 @@ MainWindow::~MainWindow()
  ************************************************/
 void MainWindow::closeEvent(QCloseEvent *)
 {
+    if (mScanner)
+        mScanner->stop();
+
+    project->cancelLoading();
+
     if (mConverter)
         mConverter->stop();
     saveSettings();
@@ -351,7 +374,7 @@ void MainWindow::setOutProfile()
 void MainWindow::setControlsEnable()
 {
     bool convert = mConverter && mConverter->isRunning();
-    bool scan    = mScanner;
+    bool scan    = mScanner || project->isLoading();
     bool running = scan || convert;
 
     bool tracksSelected = !trackView->selectedTracks().isEmpty();
@@ -597,6 +620,58 @@ void MainWindow::startConvertSelected()
     startConvert(jobs);
 }
 
+/************************************************
+ * The user can select additional profiles, the
+ * disks are converted to all of them in one pass.
+ ************************************************/
+void MainWindow::showOutProfileMenu(const QPoint &pos)
+{
+    QStringList ids = Settings::i()->value(Settings::OutFiles_AdditionalProfiles).toStringList();
+
+    QMenu menu;
+    menu.addSection(tr("Also convert to", "Main window, additional profiles menu"));
+    for (const Profile &p : Settings::i()->profiles()) {
+        if (p.id() == project->currentProfile().id()) {
+            continue;
+        }
+
+        QAction *act = menu.addAction(p.name());
+        act->setCheckable(true);
+        act->setChecked(ids.contains(p.id()));
+
+        const QString id = p.id();
+        connect(act, &QAction::toggled, this, [id](bool checked) {
+            QStringList ids = Settings::i()->value(Settings::OutFiles_AdditionalProfiles).toStringList();
+            ids.removeAll(id);
+            if (checked) {
+                ids << id;
+            }
+            Settings::i()->setValue(Settings::OutFiles_AdditionalProfiles, ids);
+        });
+    }
+
+    menu.exec(outProfileCombo->mapToGlobal(pos));
+}
+
+/************************************************
+
+ ************************************************/
+Profiles MainWindow::outProfiles() const
+{
+    Profiles res;
+    res << project->currentProfile();
+
+    const QStringList ids = Settings::i()->value(Settings::OutFiles_AdditionalProfiles).toStringList();
+    for (const QString &id : ids) {
+        int n = Settings::i()->profiles().indexOf(id);
+        if (n > -1 && id != project->currentProfile().id()) {
+            res << Settings::i()->profiles().at(n);
+        }
+    }
+
+    return res;
+}
+
 /************************************************
 
  ************************************************/
@@ -646,7 +721,7 @@ void MainWindow::startConvert(const Conv::Converter::Jobs &jobs)
         setWindowTitle(tr("Flacon"));
     });
 
-    mConverter->start(jobs, project->currentProfile());
+    mConverter->start(jobs, outProfiles());
     setControlsEnable();
 }
 
@@ -815,47 +890,83 @@ void MainWindow::downloadDiscInfo(Disc *disc)
  ************************************************/
 void MainWindow::addFileOrDir(const QString &fileName)
 {
-    bool isFirst   = true;
-    bool showError = false;
-    auto addFile   = [&](const QString &file) {
-        try {
-            QFileInfo fi = QFileInfo(file);
-            DiscList  discs;
-            if (fi.size() > 102400)
-                discs << project->addAudioFile(file);
-            else
-                discs << project->addCueFile(file);
-
-            if (!discs.isEmpty() && isFirst) {
-                isFirst = false;
-                this->trackView->selectDisc(discs.first());
-            }
-        }
+    QFileInfo fi = QFileInfo(fileName);
 
-        catch (FlaconError &err) {
-            if (showError)
-                showErrorMessage(err.what());
-        }
-    };
+    if (fi.isDir()) {
+        scanDir(fi.absoluteFilePath());
+        return;
+    }
 
     QApplication::setOverrideCursor(Qt::WaitCursor);
-    QFileInfo fi = QFileInfo(fileName);
+    Disc *disc = addFile(fileName, true);
+    if (disc) {
+        this->trackView->selectDisc(disc);
+    }
+    QApplication::restoreOverrideCursor();
+}
 
-    if (fi.isDir()) {
-        mScanner = new Scanner;
-        setControlsEnable();
-        showError = false;
-        connect(mScanner, &Scanner::found, addFile);
-        mScanner->start(fi.absoluteFilePath());
-        delete mScanner;
-        mScanner = nullptr;
-        setControlsEnable();
+/************************************************
+
+ ************************************************/
+Disc *MainWindow::addFile(const QString &fileName, bool showError)
+{
+    try {
+        QFileInfo fi = QFileInfo(fileName);
+        if (fi.size() > 102400)
+            return project->addAudioFile(fileName);
+        else
+            return project->addCueFile(fileName);
     }
-    else {
-        showError = true;
-        addFile(fileName);
+
+    catch (FlaconError &err) {
+        if (showError)
+            showErrorMessage(err.what());
+    }
+
+    return nullptr;
+}
+
+/************************************************
+ The scanner works in the background, the next
+ directories are added to the running scanner.
+ The found files are loaded on the thread pool
+ while the scanner is still running.
+ ************************************************/
+void MainWindow::scanDir(const QString &dir)
+{
+    if (!mScanner) {
+        if (!project->isLoading()) {
+            QApplication::setOverrideCursor(Qt::BusyCursor);
+            mSelectLoadedDisc = true;
+        }
+
+        mScanner = new Scanner(this);
+        connect(mScanner, &Scanner::found, project, &Project::addFilesAsync);
+
+        connect(mScanner, &Scanner::finished, this, [this]() {
+            mScanner->deleteLater();
+            mScanner = nullptr;
+            scanFinished();
+        });
     }
+
+    mScanner->start(dir);
+    setControlsEnable();
+}
+
+/************************************************
+
+ ************************************************/
+void MainWindow::scanFinished()
+{
+    if (mScanner || project->isLoading()) {
+        return;
+    }
+
+    statusbar->clearMessage();
+    mSelectLoadedDisc = false;
     QApplication::restoreOverrideCursor();
+    setControlsEnable();
 }
 
 /************************************************
@@ -1006,6 +1117,8 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
     if (event->key() == Qt::Key_Escape) {
         if (mScanner)
             mScanner->stop();
+
+        project->cancelLoading();
     }
 }
 
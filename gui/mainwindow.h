@@ -31,6 +31,7 @@
 #include "types.h"
 #include <QPointer>
 #include "converter.h"
+#include "profiles.h"
 
 namespace Ui {
 class MainWindow;
@@ -39,6 +40,7 @@ class MainWindow;
 class Project;
 class Converter;
 class Scanner;
+class Disc;
 
 class MainWindow : public QMainWindow, private Ui::MainWindow, private Messages::Handler
 {
@@ -69,6 +71,7 @@ private slots:
 
     void setControlsEnable();
     void refreshEdits();
+    void scanFinished();
 
     void openAddFileDialog();
 
@@ -108,15 +111,21 @@ protected:
 private:
     QPointer<Conv::Converter> mConverter;
     Scanner                  *mScanner;
+    bool                      mSelectLoadedDisc = false;
     QString                   getOpenFileFilter(bool includeAudio, bool includeCue);
 
     void polishView();
     void initActions();
     void initToolBar();
     void refreshOutProfileCombo();
+    void showOutProfileMenu(const QPoint &pos);
+    Profiles outProfiles() const;
 
     void startConvert(const Conv::Converter::Jobs &jobs);
 
+    Disc *addFile(const QString &fileName, bool showError);
+    void  scanDir(const QString &dir);
+
     QIcon loadMainIcon();
 
     void showErrorMessage(const QString &message) override;
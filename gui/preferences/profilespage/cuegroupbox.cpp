@@ -65,6 +65,7 @@ CueGroupBox::CueGroupBox(QWidget *parent) :
 
     connect(ui->writeToFileButton, &QCheckBox::clicked, this, &CueGroupBox::refresh);
     connect(ui->embedButton, &QCheckBox::clicked, this, &CueGroupBox::refresh);
+    connect(ui->wholeImageButton, &QCheckBox::clicked, this, &CueGroupBox::refresh);
 
     refresh();
 }
@@ -82,6 +83,7 @@ void CueGroupBox::fromProfile(const Profile &profile)
     ui->embedButton->setChecked(profile.isEmbedCue());
     ui->perTrackCueFormatEdit->setText(profile.cueFileName());
     ui->preGapComboBox->setValue(profile.preGapType());
+    ui->wholeImageButton->setChecked(profile.isWholeImage());
     refresh();
 }
 
@@ -91,6 +93,7 @@ void CueGroupBox::toProfile(Profile *profile) const
     profile->setEmbedCue(ui->embedButton->isChecked());
     profile->setCueFileName(ui->perTrackCueFormatEdit->text());
     profile->setPregapType(ui->preGapComboBox->value());
+    profile->setWholeImage(ui->wholeImageButton->isChecked());
 }
 
 void CueGroupBox::refresh()
@@ -98,6 +101,6 @@ void CueGroupBox::refresh()
     ui->embedButton->setVisible(mSupportEmbeddedCue);
     ui->perTrackCueFormatEdit->setEnabled(ui->writeToFileButton->isChecked());
     ui->perTrackCueFormatBtn->setEnabled(ui->writeToFileButton->isChecked());
-    ui->preGapComboBox->setEnabled(ui->writeToFileButton->isChecked() || ui->embedButton->isChecked());
+    ui->preGapComboBox->setEnabled(!ui->wholeImageButton->isChecked() && (ui->writeToFileButton->isChecked() || ui->embedButton->isChecked()));
     ui->preGapLabel->setEnabled(ui->preGapComboBox->isEnabled());
 }
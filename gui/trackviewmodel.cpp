@@ -130,11 +130,13 @@ TrackViewModel::TrackViewModel(TrackView *parent) :
     connect(project, &Project::discChanged,
             this, &TrackViewModel::discDataChanged);
 
+    // The discs loaded on the thread pool emit layoutChanged
+    // from the worker threads, so the context object is needed.
     connect(project, &Project::layoutChanged,
-            [this]() { this->layoutChanged(); });
+            this, [this]() { this->layoutChanged(); });
 
     connect(project, &Project::afterRemoveDisc,
-            [this]() { this->layoutChanged(); });
+            this, [this]() { this->layoutChanged(); });
 
     connect(project, &Project::beforeRemoveDisc,
             this, &TrackViewModel::invalidateCache);
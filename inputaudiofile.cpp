@@ -26,12 +26,14 @@
 #include "inputaudiofile.h"
 #include "decoder.h"
 #include "formats_in/informat.h"
+#include "probecache.h"
 #include <settings.h>
 #include <QProcess>
 #include <QStringList>
 #include <QByteArray>
 #include <QTextStream>
 #include <QDebug>
+#include <QFile>
 #include <QFileInfo>
 #include <QDir>
 #include <QLoggingCategory>
@@ -51,7 +53,8 @@ InputAudioFile::Data::Data(const InputAudioFile::Data &other) :
     mDuration(other.mDuration),
     mValid(other.mValid),
     mCdQuality(other.mCdQuality),
-    mChannelsCount(other.mChannelsCount)
+    mChannelsCount(other.mChannelsCount),
+    mEmbeddedCue(other.mEmbeddedCue)
 {
 }
 
@@ -78,6 +81,15 @@ void InputAudioFile::Data::load(const QString &filePath)
         return;
     }
 
+    if (loadFromCache()) {
+        return;
+    }
+
+    if (probe()) {
+        saveToCache();
+        return;
+    }
+
     try {
         Conv::Decoder dec;
         dec.open(mFilePath);
@@ -88,8 +100,10 @@ void InputAudioFile::Data::load(const QString &filePath)
         mCdQuality     = dec.wavHeader().isCdQuality();
         mDuration      = dec.duration();
         mChannelsCount = dec.wavHeader().numChannels();
+        mEmbeddedCue   = mFormat->readEmbeddedCue(mFilePath);
 
         mValid = true;
+        saveToCache();
 
         // clang-format off
         qCDebug(LOG) << "Audio is loaded: "
@@ -107,6 +121,103 @@ void InputAudioFile::Data::load(const QString &filePath)
     }
 }
 
+/************************************************
+ * Fills the properties from the file header,
+ * so the decoder program is not started.
+ ************************************************/
+bool InputAudioFile::Data::probe()
+{
+    QFile file(mFilePath);
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    const InputFormat *format = InputFormat::formatForFile(&file);
+    if (!format) {
+        return false;
+    }
+
+    file.seek(0);
+    InputFormat::HeaderInfo info;
+    if (!format->probeHeader(&file, &info)) {
+        qCDebug(LOG) << "Can't probe the header, use the decoder";
+        return false;
+    }
+
+    if (info.sampleRate == 0 || info.bitsPerSample == 0 || info.channelsCount == 0) {
+        return false;
+    }
+
+    mFormat        = format;
+    mSampleRate    = info.sampleRate;
+    mBitsPerSample = info.bitsPerSample;
+    mChannelsCount = info.channelsCount;
+    mDuration      = uint(info.totalSamples * 1000ull / info.sampleRate);
+    mCdQuality     = mChannelsCount == 2 && mBitsPerSample == 16 && mSampleRate == 44100;
+    mEmbeddedCue   = info.embeddedCue;
+    mValid         = true;
+
+    // clang-format off
+    qCDebug(LOG) << "Audio header is probed: "
+                    "format="         << mFormat <<
+                    "mDuration"       << mDuration <<
+                    "mCdQuality="     << mCdQuality <<
+                    "mSampleRate="    << mSampleRate <<
+                    "mBitsPerSample=" << mBitsPerSample;
+    // clang-format on
+    return true;
+}
+
+/************************************************
+ *
+ ************************************************/
+bool InputAudioFile::Data::loadFromCache()
+{
+    ProbeCache::Entry entry;
+    if (!ProbeCache::instance()->get(mFilePath, &entry)) {
+        return false;
+    }
+
+    for (const InputFormat *format : InputFormat::allFormats()) {
+        if (format->name() == entry.format) {
+            mFormat        = format;
+            mSampleRate    = entry.sampleRate;
+            mBitsPerSample = entry.bitsPerSample;
+            mChannelsCount = entry.channelsCount;
+            mDuration      = entry.duration;
+            mCdQuality     = entry.cdQuality;
+            mEmbeddedCue   = entry.embeddedCue;
+            mValid         = true;
+
+            qCDebug(LOG) << "Audio is loaded from the cache:" << mFilePath;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/************************************************
+ *
+ ************************************************/
+void InputAudioFile::Data::saveToCache() const
+{
+    if (!mFormat) {
+        return;
+    }
+
+    ProbeCache::Entry entry;
+    entry.format        = mFormat->name();
+    entry.sampleRate    = mSampleRate;
+    entry.bitsPerSample = mBitsPerSample;
+    entry.channelsCount = mChannelsCount;
+    entry.duration      = mDuration;
+    entry.cdQuality     = mCdQuality;
+    entry.embeddedCue   = mEmbeddedCue;
+
+    ProbeCache::instance()->put(mFilePath, entry);
+}
+
 bool InputAudioFile::operator==(const InputAudioFile &other) const
 {
     return mData->mFilePath == other.mData->mFilePath;
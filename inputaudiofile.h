@@ -27,6 +27,7 @@
 #define INPUTAUDIOFILE_H
 
 #include <QString>
+#include <QByteArray>
 #include <QList>
 #include <QExplicitlySharedDataPointer>
 
@@ -52,8 +53,12 @@ private:
         bool               mValid         = false;
         bool               mCdQuality     = false;
         uint               mChannelsCount = 0;
+        QByteArray         mEmbeddedCue;
 
         void load(const QString &fileName);
+        bool probe();
+        bool loadFromCache();
+        void saveToCache() const;
     };
 
     QExplicitlySharedDataPointer<Data> mData;
@@ -78,6 +83,9 @@ public:
     uint duration() const { return mData->mDuration; }
     uint channelsCount() const { return mData->mChannelsCount; }
 
+    // The CUE stored inside the audio file, read together with the header.
+    QByteArray embeddedCue() const { return mData->mEmbeddedCue; }
+
     const InputFormat *format() const { return mData->mFormat; }
 };
 
@@ -0,0 +1,304 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "jsonout.h"
+#include "disc.h"
+#include "converter/conversioncache.h"
+#include "converter/processusage.h"
+
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <stdio.h>
+
+/************************************************
+ *
+ ************************************************/
+static qint64 trackBytes(const Track &track)
+{
+    const InputAudioFile &audio = track.audioFile();
+    return qint64(track.duration()) * audio.sampleRate() * audio.channelsCount() * (audio.bitsPerSample() / 8) / 1000;
+}
+
+/************************************************
+ *
+ ************************************************/
+static bool isFinalState(TrackState state)
+{
+    switch (state) {
+        case TrackState::Canceled:
+        case TrackState::Error:
+        case TrackState::Aborted:
+        case TrackState::OK:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/************************************************
+ * Times are in seconds, max RSS in KiB. The empty
+ * tag is the splitting stage.
+ ************************************************/
+static QJsonObject usageToJson(const QMap<QString, Conv::ProcessUsage> &usage)
+{
+    QJsonObject res;
+    for (auto it = usage.constBegin(); it != usage.constEnd(); ++it) {
+        const Conv::ProcessUsage &u = it.value();
+
+        QJsonObject obj;
+        obj["count"]               = u.count;
+        obj["userTime"]            = u.userTime / 1000000.0;
+        obj["systemTime"]          = u.systemTime / 1000000.0;
+        obj["wallTime"]            = u.wallTime / 1000000.0;
+        obj["maxRss"]              = u.maxRss;
+        obj["inBlocks"]            = u.inBlocks;
+        obj["outBlocks"]           = u.outBlocks;
+        obj["voluntarySwitches"]   = u.voluntarySwitches;
+        obj["involuntarySwitches"] = u.involuntarySwitches;
+
+        res[it.key().isEmpty() ? "splitter" : it.key()] = obj;
+    }
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+JsonOut::JsonOut(QObject *parent) :
+    QObject(parent)
+{
+    mStdOut.open(stdout, QFile::WriteOnly | QFile::Unbuffered);
+    mTimer.start();
+}
+
+/************************************************
+ *
+ ************************************************/
+void JsonOut::setOutput(QIODevice *out)
+{
+    mOut = out;
+}
+
+/************************************************
+ *
+ ************************************************/
+void JsonOut::write(QJsonObject &event)
+{
+    event["time"] = mTimer.elapsed();
+
+    QByteArray line = QJsonDocument(event).toJson(QJsonDocument::Compact);
+    line += '\n';
+    mOut->write(line);
+}
+
+/************************************************
+ *
+ ************************************************/
+void JsonOut::fillTrack(QJsonObject &event, const Track &track, const QString &resultFile) const
+{
+    if (!resultFile.isEmpty()) {
+        event["file"] = resultFile;
+    }
+    event["track"] = int(track.trackNum());
+    if (track.disc()) {
+        event["disc"] = track.disc()->cueFilePath();
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void JsonOut::converterStarted()
+{
+    mTimer.restart();
+
+    QJsonObject event;
+    event["event"] = "started";
+    write(event);
+}
+
+/************************************************
+ *
+ ************************************************/
+void JsonOut::converterFinished()
+{
+    mFinishTime = mTimer.elapsed();
+}
+
+/************************************************
+ * The converter repeats the same progress, only
+ * changes are written.
+ ************************************************/
+void JsonOut::outputProgress(const Track &track, const Profile &profile, const QString &resultFile, TrackState state, Percent percent)
+{
+    TrackInfo &info = mTracks[Key { track.disc(), int(track.trackNum()), profile.id() }];
+    info.file       = resultFile;
+    if (info.state == state && info.percent == percent) {
+        return;
+    }
+
+    const qint64 now = mTimer.elapsed();
+    if (info.state != state) {
+        if (info.state != TrackState::NotRunning) {
+            info.durations[trackStateToString(info.state)] += now - info.stateStart;
+        }
+        info.state      = state;
+        info.stateStart = now;
+    }
+    info.percent = percent;
+
+    const qint64 total = trackBytes(track);
+    if (state == TrackState::Splitting || state == TrackState::Encoding) {
+        info.bytes = total * percent / 100;
+    }
+    if (state == TrackState::OK) {
+        info.bytes = total;
+    }
+
+    QJsonObject event;
+    event["event"] = "track";
+    fillTrack(event, track, resultFile);
+    event["profile"]    = profile.id();
+    event["state"]      = trackStateToString(state);
+    event["percent"]    = int(percent);
+    event["bytes"]      = info.bytes;
+    event["totalBytes"] = total;
+
+    if (isFinalState(state)) {
+        QJsonObject durations;
+        for (auto it = info.durations.constBegin(); it != info.durations.constEnd(); ++it) {
+            durations[it.key()] = it.value();
+        }
+        event["durations"] = durations;
+
+        if (state == TrackState::OK) {
+            event["outputSize"] = QFileInfo(resultFile).size();
+        }
+
+        if (!info.error.isEmpty()) {
+            event["error"] = info.error;
+        }
+    }
+
+    write(event);
+}
+
+/************************************************
+ * The failed attempt can be retried, so the track
+ * state is not changed.
+ ************************************************/
+void JsonOut::trackFailed(const Track &track, const Profile &profile, const QString &resultFile, const QString &message)
+{
+    TrackInfo &info = mTracks[Key { track.disc(), int(track.trackNum()), profile.id() }];
+    info.file       = resultFile;
+    info.error      = message;
+
+    QJsonObject event;
+    event["event"] = "error";
+    fillTrack(event, track, resultFile);
+    event["profile"] = profile.id();
+    event["message"] = message;
+    write(event);
+}
+
+/************************************************
+ * The stalled program can be the splitter, so the
+ * event has no output file.
+ ************************************************/
+void JsonOut::trackStalled(const Track &track, const QString &program)
+{
+    mStalls[program]++;
+
+    QJsonObject event;
+    event["event"] = "stalled";
+    fillTrack(event, track, QString());
+    event["program"] = program;
+    write(event);
+}
+
+/************************************************
+ *
+ ************************************************/
+void JsonOut::printStatistic()
+{
+    qint64 duration = mFinishTime ? mFinishTime : mTimer.elapsed();
+
+    // In whole image mode all tracks have the same output file
+    QMap<QString, int> states;
+    QSet<QString>      outputFiles;
+    qint64             inputBytes  = 0;
+    qint64             outputBytes = 0;
+    for (auto it = mTracks.constBegin(); it != mTracks.constEnd(); ++it) {
+        states[trackStateToString(it.value().state)]++;
+        if (it.value().state == TrackState::OK) {
+            inputBytes += it.value().bytes;
+            outputFiles << it.value().file;
+        }
+    }
+
+    for (const QString &file : qAsConst(outputFiles)) {
+        outputBytes += QFileInfo(file).size();
+    }
+
+    QJsonObject event;
+    event["event"]       = "summary";
+    event["duration"]    = duration;
+    event["inputBytes"]  = inputBytes;
+    event["outputBytes"] = outputBytes;
+    event["throughput"]  = duration ? inputBytes * 1000.0 / duration : 0.0; // Input bytes per second
+
+    QJsonObject tracks;
+    for (auto it = states.constBegin(); it != states.constEnd(); ++it) {
+        tracks[it.key()] = it.value();
+    }
+    event["tracks"] = tracks;
+
+    if (!mStalls.isEmpty()) {
+        QJsonObject stalls;
+        for (auto it = mStalls.constBegin(); it != mStalls.constEnd(); ++it) {
+            stalls[it.key()] = it.value();
+        }
+        event["stalls"] = stalls;
+    }
+
+    Conv::ProcessUsageStatistic *usage = Conv::ProcessUsageStatistic::instance();
+    if (!usage->byProgram().isEmpty()) {
+        event["programs"] = usageToJson(usage->byProgram());
+        event["profiles"] = usageToJson(usage->byTag());
+    }
+
+    Conv::ConversionCache *cache = Conv::ConversionCache::instance();
+    if (cache->isEnabled()) {
+        QJsonObject stat;
+        stat["hits"]   = cache->statistic().hits;
+        stat["misses"] = cache->statistic().misses;
+        event["cache"] = stat;
+    }
+
+    write(event);
+}
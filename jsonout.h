@@ -0,0 +1,103 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef JSONOUT_H
+#define JSONOUT_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include "track.h"
+#include "profiles.h"
+
+class QJsonObject;
+class Disc;
+
+/************************************************
+ * The --progress=json output, one JSON object per
+ * line. Every line is written with a single
+ * unbuffered write, so the reader never gets
+ * a partial line from the pipe.
+ ************************************************/
+class JsonOut : public QObject
+{
+    Q_OBJECT
+public:
+    explicit JsonOut(QObject *parent = nullptr);
+
+    // The events are written to the stdout by default.
+    void setOutput(QIODevice *out);
+
+public slots:
+    void converterStarted();
+    void converterFinished();
+    void outputProgress(const Track &track, const Profile &profile, const QString &resultFile, TrackState state, Percent percent);
+    void trackFailed(const Track &track, const Profile &profile, const QString &resultFile, const QString &message);
+    void trackStalled(const Track &track, const QString &program);
+
+    void printStatistic();
+
+private:
+    struct TrackInfo
+    {
+        QString               file;
+        TrackState            state      = TrackState::NotRunning;
+        int                   percent    = -1;
+        qint64                bytes      = 0;
+        qint64                stateStart = 0;
+        QString               error;
+        QMap<QString, qint64> durations; // State -> msec
+    };
+
+    // Disc, track number and profile ID. With several profiles
+    // every track has several output files.
+    struct Key
+    {
+        const Disc *disc;
+        int         trackNum;
+        QString     profileId;
+
+        bool operator==(const Key &other) const { return disc == other.disc && trackNum == other.trackNum && profileId == other.profileId; }
+    };
+    friend uint qHash(const Key &key, uint seed = 0)
+    {
+        return ::qHash(key.disc, seed) ^ ::qHash(key.trackNum, seed) ^ ::qHash(key.profileId, seed);
+    }
+
+    QFile                 mStdOut;
+    QIODevice            *mOut        = &mStdOut;
+    QElapsedTimer         mTimer;
+    qint64                mFinishTime = 0;
+    QHash<Key, TrackInfo> mTracks;
+    QMap<QString, int>    mStalls;
+
+    void write(QJsonObject &event);
+    void fillTrack(QJsonObject &event, const Track &track, const QString &resultFile) const;
+};
+
+#endif // JSONOUT_H
@@ -29,9 +29,13 @@
 #include "mainwindow.h"
 #include "settings.h"
 #include "converter/converter.h"
+#include "converter/journal.h"
+#include "converter/trace.h"
 #include "project.h"
 #include "scanner.h"
+#include "probecache.h"
 #include "consoleout.h"
+#include "jsonout.h"
 
 #include <QString>
 #include <QLocale>
@@ -42,6 +46,7 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QDir>
+#include <QSet>
 #include <QTimer>
 #include <QLoggingCategory>
 
@@ -49,6 +54,13 @@
 #include "updater/updater.h"
 #endif
 
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 // clang-format off
 #if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
 namespace Qt {
@@ -57,8 +69,13 @@ namespace Qt {
 #endif
 // clang-format on
 
-static bool quiet;
-static bool progress;
+static bool        quiet;
+static bool        progress;
+static bool        jsonProgress;
+static QStringList profileIds;
+static bool        incremental;
+static bool        resume;
+static QString     traceFile;
 
 /************************************************
  *
@@ -75,6 +92,22 @@ Generic options:
   -c --config <file>        Specify an alternative configuration file.
   -q --quiet                Quiet mode (no output).
   -p --progress             Show progress during conversion.
+  --progress=json           Print the progress and the result as JSON
+                            objects, one per line.
+  -P --profile <id>         Convert using the profile with the specified ID.
+                            Can be specified several times or as a comma
+                            separated list to convert to several formats
+                            in one pass.
+  --incremental             Convert only the tracks whose source, CUE, tags
+                            or profile were changed since the last
+                            incremental conversion.
+  --resume                  Continue the interrupted conversion, the tracks
+                            that were already converted are skipped. If no
+                            file is specified, the files and profiles of the
+                            interrupted conversion are used.
+  --trace <file>            Write the timing of the conversion stages to
+                            the file in the Chrome trace format, it can be
+                            opened in chrome://tracing or Perfetto.
   -h, --help                Show help about options
   --version                 Show version information
   --debug                   Enable debug output
@@ -82,6 +115,11 @@ Generic options:
 Arguments:
   file                      CUE or Audio file
 
+Signals:
+  SIGUSR1                Pause the conversion, the running encoders are
+                         suspended.
+  SIGUSR2                Resume the paused conversion.
+
 Environment variables:
   FLACON_DEBUG           If variable is set, flacon prints debugging information
                          to the console.)";
@@ -146,61 +184,161 @@ void translate(QApplication *app)
     app->installTranslator(appTranslator);
 }
 
+#ifdef Q_OS_UNIX
+static int signalFd[2] = { -1, -1 };
+
+/************************************************
+ *
+ ************************************************/
+static void pauseSignalHandler(int sig)
+{
+    char    c   = char(sig);
+    ssize_t res = ::write(signalFd[0], &c, 1);
+    Q_UNUSED(res)
+}
+
+/************************************************
+ * The handler only writes the signal number to
+ * the socket, the converter is called from the
+ * event loop.
+ ************************************************/
+static void installPauseHandler(Conv::Converter *converter)
+{
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalFd) != 0) {
+        qWarning() << "Can't create socket for the signal handler";
+        return;
+    }
+
+    QSocketNotifier *notifier = new QSocketNotifier(signalFd[1], QSocketNotifier::Read, converter);
+    QObject::connect(notifier, &QSocketNotifier::activated, converter, [converter]() {
+        char c = 0;
+        if (::read(signalFd[1], &c, 1) != 1) {
+            return;
+        }
+
+        if (c == SIGUSR1 && !converter->isPaused()) {
+            converter->pause();
+            if (!quiet) {
+                QTextStream(stderr) << "Conversion paused" << Qt::endl;
+            }
+        }
+
+        if (c == SIGUSR2 && converter->isPaused()) {
+            converter->resume();
+            if (!quiet) {
+                QTextStream(stderr) << "Conversion resumed" << Qt::endl;
+            }
+        }
+    });
+
+    struct sigaction sa = {};
+    sa.sa_handler       = pauseSignalHandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &sa, nullptr);
+    sigaction(SIGUSR2, &sa, nullptr);
+}
+#endif
+
 /************************************************
  *
  ************************************************/
-int runConsole(int argc, char *argv[], const QStringList &files)
+int runConsole(int argc, char *argv[], QStringList files)
 {
     qInstallMessageHandler(consoleErroHandler);
     QCoreApplication app(argc, argv);
 
-    auto addFile = [&](const QString &file, bool showError = false) {
-        try {
-            QFileInfo fi = QFileInfo(file);
-            DiscList  discs;
-            if (fi.size() > 102400)
-                discs << project->addAudioFile(file);
-            else
-                discs << project->addCueFile(file);
+    if (resume) {
+        Conv::Journal::State state = Conv::Journal(Conv::Journal::lastFileName()).read();
+        if (files.isEmpty()) {
+            files = state.discFiles;
         }
 
-        catch (FlaconError &err) {
-            if (showError)
-                qWarning() << "Error: " << err.what();
+        if (profileIds.isEmpty()) {
+            profileIds = state.profileIds;
         }
-    };
+    }
 
-    for (QString file : files) {
+    // The scanned files are sorted, so the discs order doesn't
+    // depend on the scanner threads.
+    QStringList   loadFiles;
+    QSet<QString> explicitFiles;
+    for (const QString &file : qAsConst(files)) {
         QFileInfo fi = QFileInfo(file);
 
         if (fi.isDir()) {
-            Scanner scanner;
-            scanner.connect(&scanner, &Scanner::found, addFile);
+            QStringList found;
+            Scanner     scanner;
+            scanner.connect(&scanner, &Scanner::found, [&](const QStringList &batch) {
+                found << batch;
+            });
             scanner.start(fi.absoluteFilePath());
+            scanner.waitForFinished();
+
+            found.sort();
+            loadFiles << found;
         }
         else {
-            addFile(file, true);
+            loadFiles << file;
+            explicitFiles << file;
         }
     }
 
+    app.connect(project, &Project::loadError, &app,
+                [&](const QString &fileName, const QString &message) {
+                    if (explicitFiles.contains(fileName))
+                        qWarning() << "Error: " << message;
+                });
+
+    project->addFilesAsync(loadFiles);
+    project->waitForLoaded();
+
+    ProbeCache::instance()->save();
+
     if (project->count() == 0)
         return 10;
 
     ConsoleOut      out;
+    JsonOut         jsonOut;
     Conv::Converter converter;
-    if (!quiet) {
+    if (!quiet && jsonProgress) {
+        QObject::connect(&converter, &Conv::Converter::started,
+                         &jsonOut, &JsonOut::converterStarted);
+
+        QObject::connect(&converter, &Conv::Converter::finished,
+                         &jsonOut, &JsonOut::converterFinished);
+
+        QObject::connect(&converter, &Conv::Converter::outputProgress,
+                         &jsonOut, &JsonOut::outputProgress);
+
+        QObject::connect(&converter, &Conv::Converter::trackFailed,
+                         &jsonOut, &JsonOut::trackFailed);
+
+        QObject::connect(&converter, &Conv::Converter::trackStalled,
+                         &jsonOut, &JsonOut::trackStalled);
+
+        QObject::connect(&converter, &Conv::Converter::destroyed,
+                         &jsonOut, &JsonOut::printStatistic);
+    }
+    else if (!quiet) {
         QObject::connect(&converter, &Conv::Converter::started,
                          &out, &ConsoleOut::converterStarted);
 
         QObject::connect(&converter, &Conv::Converter::finished,
                          &out, &ConsoleOut::converterFinished);
 
+        QObject::connect(&converter, &Conv::Converter::trackFailed,
+                         &out, &ConsoleOut::trackFailed);
+
+        QObject::connect(&converter, &Conv::Converter::trackStalled,
+                         &out, &ConsoleOut::trackStalled);
+
         QObject::connect(&converter, &Conv::Converter::destroyed,
                          &out, &ConsoleOut::printStatistic);
 
         if (progress) {
-            QObject::connect(&converter, &Conv::Converter::trackProgress,
-                             &out, &ConsoleOut::trackProgress);
+            QObject::connect(&converter, &Conv::Converter::outputProgress,
+                             &out, &ConsoleOut::outputProgress);
         }
     }
 
@@ -212,11 +350,47 @@ int runConsole(int argc, char *argv[], const QStringList &files)
                     consoleErroHandler(QtCriticalMsg, QMessageLogContext(), message);
                 });
 
-    converter.start(project->currentProfile());
-    if (!converter.isRunning())
+    Profiles profiles;
+    for (const QString &id : qAsConst(profileIds)) {
+        int n = Settings::i()->profiles().indexOf(id);
+        if (n < 0) {
+            qWarning() << "Error: Unknown profile" << id;
+            return 12;
+        }
+        profiles << Settings::i()->profiles().at(n);
+    }
+
+    if (profiles.isEmpty()) {
+        profiles << project->currentProfile();
+    }
+
+    converter.setIncremental(incremental);
+    converter.setResume(resume);
+    converter.setJournalEnabled(true);
+#ifdef Q_OS_UNIX
+    installPauseHandler(&converter);
+#endif
+    Conv::Trace::setEnabled(!traceFile.isEmpty());
+    converter.start(profiles);
+    if (!converter.isRunning()) {
+        int tracksCount = 0;
+        for (int i = 0; i < project->count(); ++i) {
+            tracksCount += project->disc(i)->count();
+        }
+
+        // All output files are up to date
+        if ((incremental || resume) && converter.upToDateCount() == tracksCount) {
+            return 0;
+        }
+
         return 11;
+    }
 
-    return app.exec();
+    int res = app.exec();
+    if (!traceFile.isEmpty()) {
+        Conv::Trace::save(traceFile);
+    }
+    return res;
 }
 
 /************************************************
@@ -247,7 +421,9 @@ int runGui(int argc, char *argv[], const QStringList &files)
     });
 #endif
 
-    return app.exec();
+    int res = app.exec();
+    ProbeCache::instance()->save();
+    return res;
 }
 
 /************************************************
@@ -276,12 +452,34 @@ int main(int argc, char *argv[])
     parser.addOption(QCommandLineOption(QStringList() << "p"
                                                       << "progress",
                                         ""));
+    parser.addOption(QCommandLineOption(QStringList() << "P"
+                                                      << "profile",
+                                        "", "profile id"));
+    parser.addOption(QCommandLineOption("incremental", ""));
+    parser.addOption(QCommandLineOption("resume", ""));
+    parser.addOption(QCommandLineOption("trace", "", "trace file"));
     parser.addOption(QCommandLineOption("debug", ""));
 
     QStringList args;
     for (int i = 0; i < argc; ++i)
         args << QString::fromLocal8Bit(argv[i]);
 
+    // The --progress option is a flag, but it also accepts the format
+    for (QString &arg : args) {
+        if (arg.startsWith("--progress=")) {
+            QString format = arg.mid(QString("--progress=").length());
+            if (format != "json" && format != "text") {
+                QTextStream(stderr) << "Unknown progress format: " << format << Qt::endl
+                                    << Qt::endl;
+                printHelp(stderr);
+                return 1;
+            }
+
+            jsonProgress = (format == "json");
+            arg          = "--progress";
+        }
+    }
+
     if (!parser.parse(args)) {
         QTextStream(stderr) << parser.errorText() << Qt::endl
                             << Qt::endl;
@@ -315,8 +513,19 @@ int main(int argc, char *argv[])
                                          "default.debug=true\n");
     }
 
-    quiet    = parser.isSet("quiet");
-    progress = parser.isSet("progress");
+    quiet       = parser.isSet("quiet");
+    progress    = parser.isSet("progress");
+    incremental = parser.isSet("incremental");
+    resume      = parser.isSet("resume");
+    traceFile   = parser.value("trace");
+
+    for (const QString &value : parser.values("profile")) {
+        for (const QString &id : value.split(',')) {
+            if (!id.trimmed().isEmpty()) {
+                profileIds << id.trimmed();
+            }
+        }
+    }
 
 #ifndef GIT_BRANCH
     qInfo() << "Start flacon " << FLACON_VERSION;
@@ -0,0 +1,248 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "probecache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "ProbeCache")
+}
+
+static constexpr quint32 MAGIC       = 0x464C5043; // FLPC
+static constexpr quint32 VERSION     = 1;
+static constexpr int     MAX_RECORDS = 100000;
+
+/************************************************
+ *
+ ************************************************/
+ProbeCache *ProbeCache::instance()
+{
+    static ProbeCache *res = new ProbeCache(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/probe.cache");
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+ProbeCache::ProbeCache(const QString &fileName) :
+    mFileName(fileName)
+{
+}
+
+/************************************************
+ *
+ ************************************************/
+bool ProbeCache::FileKey::operator==(const FileKey &other) const
+{
+    return size == other.size && mtime == other.mtime && inode == other.inode;
+}
+
+/************************************************
+ *
+ ************************************************/
+bool ProbeCache::fileKey(const QString &filePath, QString *canonicalPath, FileKey *key)
+{
+    QFileInfo fi(filePath);
+    *canonicalPath = fi.canonicalFilePath();
+    if (canonicalPath->isEmpty()) {
+        return false;
+    }
+
+    key->size  = fi.size();
+    key->mtime = fi.lastModified().toMSecsSinceEpoch();
+
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (::stat(QFile::encodeName(*canonicalPath).constData(), &st) != 0) {
+        return false;
+    }
+    key->inode = st.st_ino;
+#endif
+
+    return true;
+}
+
+/************************************************
+ * The whole file is mapped and parsed at once, a
+ * broken or outdated file is ignored.
+ ************************************************/
+void ProbeCache::load()
+{
+    mLoaded = true;
+
+    QFile file(mFileName);
+    if (!file.open(QFile::ReadOnly) || file.size() == 0) {
+        return;
+    }
+
+    uchar *data = file.map(0, file.size());
+    if (!data) {
+        qCWarning(LOG) << "Can't map" << mFileName << file.errorString();
+        return;
+    }
+
+    QByteArray  buf = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(file.size()));
+    QDataStream stream(buf);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic   = 0;
+    quint32 version = 0;
+    quint32 count   = 0;
+    stream >> magic >> version >> count;
+    if (magic != MAGIC || version != VERSION) {
+        qCDebug(LOG) << "Ignore outdated cache" << mFileName;
+        return;
+    }
+
+    // The count is read from the file, a broken file must not allocate a huge table
+    mRecords.reserve(int(qMin(count, quint32(MAX_RECORDS))));
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Record  rec;
+        stream >> path;
+        stream >> rec.key.size >> rec.key.mtime >> rec.key.inode;
+        stream >> rec.entry.format >> rec.entry.sampleRate >> rec.entry.bitsPerSample >> rec.entry.channelsCount;
+        stream >> rec.entry.duration >> rec.entry.cdQuality >> rec.entry.embeddedCue;
+
+        if (stream.status() == QDataStream::Ok) {
+            mRecords.insert(path, rec);
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(LOG) << "Broken cache file" << mFileName;
+    }
+
+    qCDebug(LOG) << "Loaded" << mRecords.count() << "entries from" << mFileName;
+}
+
+/************************************************
+ *
+ ************************************************/
+bool ProbeCache::get(const QString &filePath, Entry *entry)
+{
+    QString path;
+    FileKey key;
+    if (!fileKey(filePath, &path, &key)) {
+        return false;
+    }
+
+    QMutexLocker locker(&mMutex);
+    if (!mLoaded) {
+        load();
+    }
+
+    auto it = mRecords.find(path);
+    if (it == mRecords.end() || !(it->key == key)) {
+        return false;
+    }
+
+    it->used = true;
+    *entry   = it->entry;
+    return true;
+}
+
+/************************************************
+ *
+ ************************************************/
+void ProbeCache::put(const QString &filePath, const Entry &entry)
+{
+    Record  rec;
+    QString path;
+    if (!fileKey(filePath, &path, &rec.key)) {
+        return;
+    }
+    rec.entry = entry;
+    rec.used  = true;
+
+    QMutexLocker locker(&mMutex);
+    if (!mLoaded) {
+        load();
+    }
+
+    mRecords.insert(path, rec);
+    mModified = true;
+}
+
+/************************************************
+ * If the cache grows too big, only the entries
+ * used in this session are kept.
+ ************************************************/
+void ProbeCache::save()
+{
+    QMutexLocker locker(&mMutex);
+    if (!mModified) {
+        return;
+    }
+
+    if (mRecords.count() > MAX_RECORDS) {
+        for (auto it = mRecords.begin(); it != mRecords.end();) {
+            if (it->used) {
+                ++it;
+            }
+            else {
+                it = mRecords.erase(it);
+            }
+        }
+    }
+
+    QDir().mkpath(QFileInfo(mFileName).absolutePath());
+    QSaveFile file(mFileName);
+    if (!file.open(QSaveFile::WriteOnly)) {
+        qCWarning(LOG) << "Can't save" << mFileName << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << MAGIC << VERSION << quint32(mRecords.count());
+
+    for (auto it = mRecords.constBegin(); it != mRecords.constEnd(); ++it) {
+        const Record &rec = it.value();
+        stream << it.key();
+        stream << rec.key.size << rec.key.mtime << rec.key.inode;
+        stream << rec.entry.format << rec.entry.sampleRate << rec.entry.bitsPerSample << rec.entry.channelsCount;
+        stream << rec.entry.duration << rec.entry.cdQuality << rec.entry.embeddedCue;
+    }
+
+    if (!file.commit()) {
+        qCWarning(LOG) << "Can't save" << mFileName << file.errorString();
+        return;
+    }
+
+    mModified = false;
+}
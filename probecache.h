@@ -0,0 +1,95 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef PROBECACHE_H
+#define PROBECACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+/************************************************
+ * Persistent cache of the InputAudioFile probe
+ * results. The entry is valid while the canonical
+ * path, size, modification time and inode of the
+ * file are the same.
+ * The file is loaded on the first use, the new
+ * entries are written by save().
+ * All methods are thread safe.
+ ************************************************/
+class ProbeCache
+{
+public:
+    struct Entry
+    {
+        QString    format;
+        quint32    sampleRate    = 0;
+        int        bitsPerSample = 0;
+        uint       channelsCount = 0;
+        uint       duration      = 0;
+        bool       cdQuality     = false;
+        QByteArray embeddedCue;
+    };
+
+    static ProbeCache *instance();
+
+    explicit ProbeCache(const QString &fileName);
+
+    QString fileName() const { return mFileName; }
+
+    bool get(const QString &filePath, Entry *entry);
+    void put(const QString &filePath, const Entry &entry);
+
+    void save();
+
+private:
+    struct FileKey
+    {
+        qint64  size  = 0;
+        qint64  mtime = 0;
+        quint64 inode = 0;
+
+        bool operator==(const FileKey &other) const;
+    };
+
+    struct Record
+    {
+        FileKey key;
+        Entry   entry;
+        bool    used = false;
+    };
+
+    const QString          mFileName;
+    QMutex                 mMutex;
+    QHash<QString, Record> mRecords;
+    bool                   mLoaded   = false;
+    bool                   mModified = false;
+
+    void        load();
+    static bool fileKey(const QString &filePath, QString *canonicalPath, FileKey *key);
+};
+
+#endif // PROBECACHE_H
@@ -42,6 +42,7 @@ static constexpr const char *EMBED_CUE_KEY        = "EmbedCue";
 static constexpr const char *CUE_FILE_NAME_KEY    = "CueFileName";
 static constexpr const char *PREGAP_TYPE_KEY      = "PregapType";
 static constexpr const char *REPLAY_GAIN_KEY      = "ReplayGain";
+static constexpr const char *WHOLE_IMAGE_KEY      = "WholeImage";
 static constexpr const char *COVER_FILE_MODE_KEY  = "CoverFile/Mode";
 static constexpr const char *COVER_FILE_SIZE_KEY  = "CoverFile/Size";
 static constexpr const char *COVER_EMBED_MODE_KEY = "CoverEmbed/Mode";
@@ -364,6 +365,22 @@ void Profile::setPregapType(PreGapType value)
     setValue(PREGAP_TYPE_KEY, preGapTypeToString(value));
 }
 
+/************************************************
+ *
+ ************************************************/
+bool Profile::isWholeImage() const
+{
+    return value(WHOLE_IMAGE_KEY, false).toBool();
+}
+
+/************************************************
+ *
+ ************************************************/
+void Profile::setWholeImage(bool value)
+{
+    setValue(WHOLE_IMAGE_KEY, value);
+}
+
 /************************************************
  *
  ************************************************/
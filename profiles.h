@@ -81,6 +81,10 @@ public:
     PreGapType preGapType() const;
     void       setPregapType(PreGapType value);
 
+    // Encode the whole disc into one file with the embedded CUE.
+    bool isWholeImage() const;
+    void setWholeImage(bool value);
+
     const OutFormat *  outFormat() const { return mFormat; }
     QString            formatId() const { return mFormat->id(); }
     QString            formatName() const { return mFormat->name(); }
@@ -26,12 +26,75 @@
 #include "project.h"
 #include "settings.h"
 #include "cue.h"
+#include "track.h"
 #include "inputaudiofile.h"
+#include "formats_in/informat.h"
+#include "decoder.h"
 
 #include <QDebug>
 #include <QApplication>
 #include <QMessageBox>
 #include <QDir>
+#include <QEventLoop>
+#include <QRunnable>
+#include <QLoggingCategory>
+
+namespace {
+Q_LOGGING_CATEGORY(LOG, "Project")
+}
+
+/************************************************
+ * Creates the disc in the thread pool and moves it
+ * to the thread of the project.
+ * The settings are not thread safe, so the values
+ * are read in the main thread.
+ ************************************************/
+class Project::LoadTask : public QRunnable
+{
+public:
+    LoadTask(Project *project, int id, const QString &fileName, const QString &defaultCodepage, const Conv::Decoder::Programs &decoderPrograms) :
+        mProject(project),
+        mId(id),
+        mFileName(fileName),
+        mDefaultCodepage(defaultCodepage),
+        mDecoderPrograms(decoderPrograms)
+    {
+    }
+
+    void run() override
+    {
+        UcharDet::setThreadDefaultCodepage(mDefaultCodepage);
+        Conv::Decoder::setThreadPrograms(mDecoderPrograms);
+
+        LoadResult res;
+        res.fileName = mFileName;
+
+        if (!mProject->mLoadAbort.loadAcquire()) {
+            try {
+                if (InputFormat::formatForFile(mFileName)) {
+                    res.disc = loadAudioDisc(mFileName);
+                }
+                else {
+                    Cue cue(mFileName);
+                    res.disc = loadCueDisc(cue);
+                }
+                res.disc->moveToThread(mProject->thread());
+            }
+            catch (FlaconError &err) {
+                res.error = err.what();
+            }
+        }
+
+        mProject->loadFinishedTask(mId, res);
+    }
+
+private:
+    Project                *mProject;
+    int                     mId;
+    QString                 mFileName;
+    QString                 mDefaultCodepage;
+    Conv::Decoder::Programs mDecoderPrograms;
+};
 
 /************************************************
 
@@ -145,6 +208,17 @@ Disc *Project::addAudioFile(const QString &fileName) noexcept(false)
             return nullptr;
     }
 
+    Disc *disc = loadAudioDisc(fileName);
+    addDisc(disc);
+    return disc;
+}
+
+/************************************************
+ * Doesn't touch the project, so it's safe to call
+ * from the thread pool.
+ ************************************************/
+Disc *Project::loadAudioDisc(const QString &fileName) noexcept(false)
+{
     InputAudioFile audio(QFileInfo(fileName).absoluteFilePath());
     if (!audio.isValid()) {
         throw FlaconError(audio.errorString());
@@ -156,7 +230,18 @@ Disc *Project::addAudioFile(const QString &fileName) noexcept(false)
         disc->searchAudioFiles(false);
     }
     disc->searchCoverImage();
-    addDisc(disc);
+    return disc;
+}
+
+/************************************************
+ * Doesn't touch the project, so it's safe to call
+ * from the thread pool.
+ ************************************************/
+Disc *Project::loadCueDisc(Cue &cue)
+{
+    Disc *disc = new Disc(cue);
+    disc->searchAudioFiles();
+    disc->searchCoverImage();
     return disc;
 }
 
@@ -172,9 +257,7 @@ Disc *Project::addCueFile(const QString &fileName)
             return nullptr;
         }
 
-        Disc *disc = new Disc(cue);
-        disc->searchAudioFiles();
-        disc->searchCoverImage();
+        Disc *disc = loadCueDisc(cue);
         addDisc(disc);
         emit layoutChanged();
         return disc;
@@ -227,3 +310,135 @@ void Project::emitLayoutChanged() const
 {
     emit layoutChanged();
 }
+
+/************************************************
+ *
+ ************************************************/
+void Project::addFilesAsync(const QStringList &fileNames)
+{
+    if (fileNames.isEmpty()) {
+        return;
+    }
+
+    if (mLoadTotal == 0) {
+        mLoadAbort.storeRelease(0);
+    }
+
+    const QString                 codepage = Settings::i()->defaultCodepage();
+    const Conv::Decoder::Programs programs = Conv::Decoder::programsFromSettings();
+    for (const QString &fileName : fileNames) {
+        mLoadTotal++;
+        mLoadPool.start(new LoadTask(this, mLoadNextId++, fileName, codepage, programs));
+    }
+
+    emit loadProgress(mLoadDone, mLoadTotal);
+}
+
+/************************************************
+ * The queued tasks still finish, without loading.
+ ************************************************/
+void Project::cancelLoading()
+{
+    if (isLoading()) {
+        mLoadAbort.storeRelease(1);
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void Project::waitForLoaded()
+{
+    if (!isLoading()) {
+        return;
+    }
+
+    QEventLoop loop;
+    connect(this, &Project::loadFinished, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+/************************************************
+ * Called from the thread pool.
+ ************************************************/
+void Project::loadFinishedTask(int id, const LoadResult &result)
+{
+    QMutexLocker locker(&mLoadMutex);
+    mLoadResults.insert(id, result);
+
+    if (!mLoadInsertPosted) {
+        mLoadInsertPosted = true;
+        QMetaObject::invokeMethod(this, "insertLoadedDiscs", Qt::QueuedConnection);
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+bool Project::isLoadedDiscExists(const Disc *disc) const
+{
+    if (!disc->cueFilePath().isEmpty()) {
+        return const_cast<Project *>(this)->discExists(disc->cueFilePath());
+    }
+
+    for (const Disc *d : mDiscs) {
+        for (const QString &file : disc->audioFilePaths()) {
+            if (d->audioFilePaths().contains(file)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/************************************************
+ * The results are waiting for all previous files,
+ * so the discs are added in the order of files.
+ ************************************************/
+void Project::insertLoadedDiscs()
+{
+    QList<LoadResult> ready;
+    {
+        QMutexLocker locker(&mLoadMutex);
+        mLoadInsertPosted = false;
+
+        auto it = mLoadResults.find(mLoadInsertId);
+        while (it != mLoadResults.end()) {
+            ready << it.value();
+            mLoadResults.erase(it);
+            it = mLoadResults.find(++mLoadInsertId);
+        }
+    }
+
+    for (const LoadResult &res : qAsConst(ready)) {
+        mLoadDone++;
+
+        if (!res.error.isEmpty()) {
+            qCWarning(LOG) << res.fileName << res.error;
+            emit loadError(res.fileName, res.error);
+            continue;
+        }
+
+        if (!res.disc) {
+            continue;
+        }
+
+        if (mLoadAbort.loadAcquire() || isLoadedDiscExists(res.disc)) {
+            delete res.disc;
+            continue;
+        }
+
+        addDisc(res.disc);
+        emit discLoaded(res.disc);
+    }
+
+    if (!ready.isEmpty()) {
+        emit loadProgress(mLoadDone, mLoadTotal);
+    }
+
+    if (mLoadTotal > 0 && mLoadDone == mLoadTotal) {
+        mLoadTotal = 0;
+        mLoadDone  = 0;
+        emit loadFinished();
+    }
+}
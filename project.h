@@ -29,6 +29,10 @@
 #include <QObject>
 #include <QList>
 #include <QIcon>
+#include <QMap>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QThreadPool>
 #include "disc.h"
 #include "validator.h"
 
@@ -61,6 +65,16 @@ public:
     Disc *addAudioFile(const QString &fileName) noexcept(false);
     Disc *addCueFile(const QString &fileName);
 
+    // The discs are loaded on the thread pool and added in the order
+    // of the calls and the files. The files with a known audio format
+    // are loaded as audio files, others as CUE files.
+    void addFilesAsync(const QStringList &fileNames);
+    void cancelLoading();
+    bool isLoading() const { return mLoadTotal > 0; }
+
+    // Processes the events until all files are loaded.
+    void waitForLoaded();
+
     const Profile &currentProfile() const;
     Profile &      currentProfile();
     bool           selectProfile(const QString &profileId);
@@ -73,12 +87,46 @@ signals:
     void beforeRemoveDisc(Disc *disc);
     void afterRemoveDisc();
 
+    void discLoaded(Disc *disc);
+    void loadError(const QString &fileName, const QString &message);
+    void loadProgress(int loaded, int total);
+    void loadFinished();
+
 protected:
     explicit Project(QObject *parent = nullptr);
 
+private slots:
+    void insertLoadedDiscs();
+
 private:
+    class LoadTask;
+
+    struct LoadResult
+    {
+        QString fileName;
+        Disc *  disc = nullptr;
+        QString error;
+    };
+
     QList<Disc *> mDiscs;
     Validator     mValidator;
+
+    QThreadPool mLoadPool;
+    QAtomicInt  mLoadAbort;
+    int         mLoadNextId   = 0;
+    int         mLoadInsertId = 0;
+    int         mLoadTotal    = 0;
+    int         mLoadDone     = 0;
+
+    // Shared with the tasks .......
+    QMutex                mLoadMutex;
+    QMap<int, LoadResult> mLoadResults;
+    bool                  mLoadInsertPosted = false;
+
+    static Disc *loadAudioDisc(const QString &fileName) noexcept(false);
+    static Disc *loadCueDisc(Cue &cue);
+    void         loadFinishedTask(int id, const LoadResult &result);
+    bool         isLoadedDiscExists(const Disc *disc) const;
 };
 
 #define project Project::instance()
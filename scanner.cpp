@@ -25,24 +25,65 @@
 
 #include "scanner.h"
 #include "formats_in/informat.h"
-#include "inputaudiofile.h"
 
-#include "project.h"
-
-#include <QStringList>
-#include <QSet>
-#include <QQueue>
 #include <QDir>
-#include <QApplication>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QRunnable>
+
+#ifdef Q_OS_UNIX
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+/************************************************
+ *
+ ************************************************/
+class Scanner::Task : public QRunnable
+{
+public:
+    Task(Scanner *scanner, const QString &dir) :
+        mScanner(scanner),
+        mDir(dir)
+    {
+    }
+
+    void run() override
+    {
+        if (!mScanner->mAbort.loadAcquire()) {
+            mScanner->scanDir(mDir);
+        }
+        mScanner->taskDone();
+    }
+
+private:
+    Scanner *mScanner;
+    QString  mDir;
+};
 
 /************************************************
 
  ************************************************/
 Scanner::Scanner(QObject *parent) :
-    QObject(parent),
-    mActive(false),
-    mAbort(false)
+    QObject(parent)
 {
+    for (const InputFormat *format : InputFormat::allFormats()) {
+        mExts << format->ext().toLower();
+    }
+
+    mFlushTimer.setInterval(BATCH_INTERVAL);
+    connect(&mFlushTimer, &QTimer::timeout, this, &Scanner::flush);
+}
+
+/************************************************
+
+ ************************************************/
+Scanner::~Scanner()
+{
+    mAbort.storeRelease(1);
+    mPool.waitForDone();
 }
 
 /************************************************
@@ -50,51 +91,258 @@ Scanner::Scanner(QObject *parent) :
  ************************************************/
 void Scanner::start(const QString &startDir)
 {
-    mActive = true;
-    mAbort  = false;
+    if (!mRunning) {
+        mRunning = true;
+        mAbort.storeRelease(0);
+        mVisited.clear();
+        mVisitedPaths.clear();
+        mBatch.clear();
+        mFlushPosted = false;
+        mFlushTimer.start();
+    }
 
-    QStringList exts;
-    foreach (const InputFormat *format, InputFormat::allFormats()) {
-        exts << QString("*.%1").arg(format->ext());
+    QFileInfo fi(startDir);
+    bool      isNew = false;
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (::stat(QFile::encodeName(fi.absoluteFilePath()).constData(), &st) == 0) {
+        isNew = markVisited(st.st_dev, st.st_ino);
     }
+#else
+    isNew = markVisited(fi.canonicalFilePath());
+#endif
 
-    QQueue<QString> query;
-    query << startDir;
+    if (isNew) {
+        enqueue(fi.absoluteFilePath());
+    }
+    else if (mPending.loadAcquire() == 0) {
+        QMetaObject::invokeMethod(this, "finish", Qt::QueuedConnection);
+    }
+}
 
-    QSet<QString> processed;
-    while (!query.isEmpty()) {
-        QDir dir(query.dequeue());
+/************************************************
 
-        QFileInfoList dirs = dir.entryInfoList(QDir::Dirs | QDir::Readable | QDir::NoDotAndDotDot);
-        foreach (QFileInfo d, dirs) {
-            qApp->processEvents();
-            if (mAbort)
-                return;
+ ************************************************/
+void Scanner::stop()
+{
+    mAbort.storeRelease(1);
+}
+
+/************************************************
 
-            if (d.isSymLink())
-                d = QFileInfo(d.symLinkTarget());
+ ************************************************/
+void Scanner::waitForFinished()
+{
+    if (!mRunning) {
+        return;
+    }
+
+    QEventLoop loop;
+    connect(this, &Scanner::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+/************************************************
+
+ ************************************************/
+void Scanner::enqueue(const QString &dir)
+{
+    mPending.ref();
+    mPool.start(new Task(this, dir));
+}
+
+/************************************************
+ * Called from the worker thread.
+ ************************************************/
+void Scanner::taskDone()
+{
+    if (!mPending.deref()) {
+        QMetaObject::invokeMethod(this, "finish", Qt::QueuedConnection);
+    }
+}
+
+/************************************************
+ * Returns false if the directory was already
+ * visited, so the symlink loops are skipped.
+ ************************************************/
+bool Scanner::markVisited(quint64 device, quint64 inode)
+{
+    QMutexLocker locker(&mMutex);
+    auto         key = qMakePair(device, inode);
+    if (mVisited.contains(key)) {
+        return false;
+    }
+
+    mVisited << key;
+    return true;
+}
+
+/************************************************
+
+ ************************************************/
+bool Scanner::markVisited(const QString &canonicalPath)
+{
+    QMutexLocker locker(&mMutex);
+    if (canonicalPath.isEmpty() || mVisitedPaths.contains(canonicalPath)) {
+        return false;
+    }
 
-            if (!processed.contains(d.absoluteFilePath())) {
-                processed << d.absoluteFilePath();
-                query << d.absoluteFilePath();
+    mVisitedPaths << canonicalPath;
+    return true;
+}
+
+/************************************************
+
+ ************************************************/
+bool Scanner::isAudioFile(const QString &fileName) const
+{
+    int n = fileName.lastIndexOf('.');
+    return n > -1 && mExts.contains(fileName.mid(n + 1).toLower());
+}
+
+#ifdef Q_OS_UNIX
+/************************************************
+ * Called from the worker thread. The entries are
+ * checked relative to the directory descriptor.
+ ************************************************/
+void Scanner::scanDir(const QString &dirPath)
+{
+    const QByteArray path = QFile::encodeName(dirPath);
+
+    int fd = ::open(path.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+
+    DIR *dir = ::fdopendir(fd);
+    if (!dir) {
+        ::close(fd);
+        return;
+    }
+
+    const QString prefix = dirPath.endsWith('/') ? dirPath : dirPath + '/';
+    QStringList   files;
+
+    while (!mAbort.loadAcquire()) {
+        struct dirent *entry = ::readdir(dir);
+        if (!entry) {
+            break;
+        }
+
+        // The hidden entries are skipped, like QDir does without QDir::Hidden
+        const char *name = entry->d_name;
+        if (name[0] == '.') {
+            continue;
+        }
+
+        bool isDir  = entry->d_type == DT_DIR;
+        bool isFile = entry->d_type == DT_REG;
+
+        // The symlinks are followed, the directories need the inode
+        struct stat st;
+        if (isDir || entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN) {
+            if (::fstatat(fd, name, &st, 0) != 0) {
+                continue;
             }
+            isDir  = S_ISDIR(st.st_mode);
+            isFile = S_ISREG(st.st_mode);
         }
 
-        QFileInfoList files = dir.entryInfoList(exts, QDir::Files | QDir::Readable);
-        foreach (QFileInfo f, files) {
-            qApp->processEvents();
-            if (mAbort)
-                return;
+        if (isDir) {
+            if (::faccessat(fd, name, R_OK | X_OK, 0) == 0 && markVisited(st.st_dev, st.st_ino)) {
+                enqueue(prefix + QFile::decodeName(name));
+            }
+            continue;
+        }
+
+        if (isFile) {
+            QString fileName = QFile::decodeName(name);
+            if (isAudioFile(fileName) && ::faccessat(fd, name, R_OK, 0) == 0) {
+                files << prefix + fileName;
+            }
+        }
+    }
+
+    ::closedir(dir);
+
+    files.sort();
+    addFiles(files);
+}
+#else
+/************************************************
+ * Called from the worker thread.
+ ************************************************/
+void Scanner::scanDir(const QString &dirPath)
+{
+    QDir dir(dirPath);
 
-            emit found(f.absoluteFilePath());
+    const QFileInfoList dirs = dir.entryInfoList(QDir::Dirs | QDir::Readable | QDir::NoDotAndDotDot);
+    for (const QFileInfo &d : dirs) {
+        if (mAbort.loadAcquire()) {
+            return;
         }
+
+        if (markVisited(d.canonicalFilePath())) {
+            enqueue(d.absoluteFilePath());
+        }
+    }
+
+    QStringList         files;
+    const QFileInfoList entries = dir.entryInfoList(InputFormat::allFileExts(), QDir::Files | QDir::Readable, QDir::Name);
+    for (const QFileInfo &f : entries) {
+        files << f.absoluteFilePath();
+    }
+
+    addFiles(files);
+}
+#endif
+
+/************************************************
+ * Called from the worker thread.
+ ************************************************/
+void Scanner::addFiles(const QStringList &files)
+{
+    if (files.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&mMutex);
+    mBatch << files;
+
+    if (mBatch.size() >= BATCH_SIZE && !mFlushPosted) {
+        mFlushPosted = true;
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
     }
 }
 
 /************************************************
 
  ************************************************/
-void Scanner::stop()
+void Scanner::flush()
 {
-    mAbort = true;
+    QStringList files;
+    {
+        QMutexLocker locker(&mMutex);
+        files.swap(mBatch);
+        mFlushPosted = false;
+    }
+
+    if (!files.isEmpty() && !mAbort.loadAcquire()) {
+        emit found(files);
+    }
+}
+
+/************************************************
+
+ ************************************************/
+void Scanner::finish()
+{
+    if (!mRunning || mPending.loadAcquire() != 0) {
+        return;
+    }
+
+    flush();
+    mFlushTimer.stop();
+    mRunning = false;
+    emit finished();
 }
@@ -27,23 +27,74 @@
 #define SCANNER_H
 
 #include <QObject>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
 
+/************************************************
+ * The directories are walked in parallel on the
+ * thread pool. The found files are collected and
+ * emitted in batches in the thread of the scanner,
+ * so the handlers of the found signal run in the
+ * scanner thread.
+ ************************************************/
 class Scanner : public QObject
 {
     Q_OBJECT
 public:
+    static constexpr int BATCH_SIZE     = 256;
+    static constexpr int BATCH_INTERVAL = 100; // msec
+
     explicit Scanner(QObject *parent = nullptr);
+    ~Scanner() override;
+
+    bool isRunning() const { return mRunning; }
+
+    // Processes the events until the scan is finished.
+    void waitForFinished();
 
 signals:
-    void found(const QString &file);
+    void found(const QStringList &files);
+    void finished();
 
 public slots:
+    // Can be called while running, all directories are scanned together.
     void start(const QString &startDir);
     void stop();
 
+private slots:
+    void flush();
+    void finish();
+
 private:
-    bool mActive;
-    bool mAbort;
+    class Task;
+
+    bool          mRunning = false;
+    QThreadPool   mPool;
+    QSet<QString> mExts;
+    QTimer        mFlushTimer;
+
+    QAtomicInt mAbort;
+    QAtomicInt mPending;
+
+    // Shared with the tasks .......
+    QMutex                        mMutex;
+    QSet<QPair<quint64, quint64>> mVisited; // device, inode
+    QSet<QString>                 mVisitedPaths;
+    QStringList                   mBatch;
+    bool                          mFlushPosted = false;
+
+    void enqueue(const QString &dir);
+    void scanDir(const QString &dir);
+    bool markVisited(quint64 device, quint64 inode);
+    bool markVisited(const QString &canonicalPath);
+    bool isAudioFile(const QString &fileName) const;
+    void addFiles(const QStringList &files);
+    void taskDone();
 };
 
 #endif // SCANNER_H
@@ -116,9 +116,18 @@ void Settings::init()
     // Globals **********************************
     setDefaultValue(Encoder_ThreadCount, qMax(4, QThread::idealThreadCount()));
     setDefaultValue(Encoder_TmpDir, "");
+    setDefaultValue(Encoder_RetryCount, 2);
+    setDefaultValue(Encoder_RetryDelay, 1000);
+    setDefaultValue(Encoder_StallTimeout, 120);
 
     // Out Files ********************************
     setDefaultValue(OutFiles_Profile, "FLAC");
+    setDefaultValue(OutFiles_AdditionalProfiles, QStringList());
+
+    // Conversion cache *************************
+    setDefaultValue(ConvCache_Enabled, false);
+    setDefaultValue(ConvCache_Dir, QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/conversion");
+    setDefaultValue(ConvCache_MaxSize, 2048);
 
     // Misc *************************************
     setDefaultValue(Misc_LastDir, QDir::homePath());
@@ -202,6 +211,12 @@ QString Settings::keyToString(Settings::Key key) const
             return "Encoder/ThreadCount";
         case Encoder_TmpDir:
             return "Encoder/TmpDir";
+        case Encoder_RetryCount:
+            return "Encoder/RetryCount";
+        case Encoder_RetryDelay:
+            return "Encoder/RetryDelay";
+        case Encoder_StallTimeout:
+            return "Encoder/StallTimeout";
 
         // Out Files ***************************
         case OutFiles_Profile:
@@ -210,6 +225,16 @@ QString Settings::keyToString(Settings::Key key) const
             return "OutFiles/PatternHistory";
         case OutFiles_DirectoryHistory:
             return "OutFiles/DirectoryHistory";
+        case OutFiles_AdditionalProfiles:
+            return "OutFiles/AdditionalProfiles";
+
+        // Conversion cache *********************
+        case ConvCache_Enabled:
+            return "ConversionCache/Enabled";
+        case ConvCache_Dir:
+            return "ConversionCache/Directory";
+        case ConvCache_MaxSize:
+            return "ConversionCache/MaxSizeMb";
 
         // Misc *********************************
         case Misc_LastDir:
@@ -43,11 +43,20 @@ public:
         // Globals ******************************
         Encoder_ThreadCount,
         Encoder_TmpDir,
+        Encoder_RetryCount,
+        Encoder_RetryDelay,
+        Encoder_StallTimeout,
 
         // Out Files ****************************
         OutFiles_DirectoryHistory,
         OutFiles_Profile,
         OutFiles_PatternHistory,
+        OutFiles_AdditionalProfiles,
+
+        // Conversion cache *********************
+        ConvCache_Enabled,
+        ConvCache_Dir,
+        ConvCache_MaxSize,
 
         // Misc *********************************
         Misc_LastDir,
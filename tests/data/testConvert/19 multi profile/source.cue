@@ -0,0 +1,25 @@
+REM GENRE "Genre"
+REM DATE 2013
+REM DISCID 123456789
+REM COMMENT "ExactAudioCopy v0.99pb4"
+PERFORMER "Artist_02"
+TITLE "Album"
+FILE "en.wav" WAVE
+  TRACK 01 AUDIO
+    TITLE "Song01"
+    SONGWRITER "Song Writer A"
+    INDEX 01 00:00:00
+  TRACK 02 AUDIO
+    TITLE "Song02"
+    SONGWRITER "Song Writer B"
+    INDEX 01 00:46:00
+  TRACK 03 AUDIO
+    TITLE "Song03"
+    SONGWRITER "Song Writer C"
+    INDEX 00 01:22:22
+    INDEX 01 01:25:10
+  TRACK 04 AUDIO
+    TITLE "Song04"
+    SONGWRITER "Song Writer D"
+    INDEX 00 02:39:54
+    INDEX 01 02:41:05
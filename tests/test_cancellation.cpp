@@ -0,0 +1,257 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "tools.h"
+#include "disc.h"
+#include "settings.h"
+#include "../converter/cancellationtoken.h"
+#include "../converter/converter.h"
+#include "../converter/extprogram.h"
+#include "../converter/stallwatchdog.h"
+
+#include <QTest>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+#include <thread>
+#include <chrono>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+
+// The workers poll the token every POLL_INTERVAL
+static constexpr int STOP_LATENCY = 100; // msec
+
+/************************************************
+ * The zombie is reaped by init, so we wait a bit.
+ ************************************************/
+static bool waitForProcessGone(pid_t pid, int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (::kill(pid, 0) == 0 || errno != ESRCH) {
+        if (timer.elapsed() > msecs) {
+            return false;
+        }
+        QThread::msleep(5);
+    }
+    return true;
+}
+
+/************************************************
+ * Direct children of the test process, the
+ * programs started by the converter.
+ ************************************************/
+static int childProcessCount()
+{
+    int res = 0;
+    for (const QString &pid : QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QFile file(QString("/proc/%1/stat").arg(pid));
+        if (!file.open(QFile::ReadOnly)) {
+            continue;
+        }
+
+        // pid (comm) state ppid ..., the comm can contain spaces
+        QByteArray        stat   = file.readAll();
+        QList<QByteArray> fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+        if (fields.count() > 1 && fields.at(1).toInt() == ::getpid()) {
+            ++res;
+        }
+    }
+    return res;
+}
+
+/************************************************
+ * The shell starts a child, both must be killed.
+ ************************************************/
+void TestFlacon::testCancellationToken()
+{
+    Conv::CancellationToken token;
+
+    ExtProgram proc;
+    proc.start("sh", QStringList() << "-c"
+                                   << "sleep 10 & echo $!; wait");
+    QVERIFY(proc.waitForStarted());
+    QVERIFY(proc.waitForReadyRead(1000));
+
+    const pid_t group    = pid_t(proc.processId());
+    const pid_t sleepPid = pid_t(proc.readLine().trimmed().toInt());
+    QVERIFY(sleepPid > 0);
+
+    std::chrono::steady_clock::time_point canceledAt;
+
+    std::thread canceler([token, &canceledAt]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        canceledAt = std::chrono::steady_clock::now();
+        token.cancel();
+    });
+
+    bool canceled = false;
+    try {
+        token.waitForFinished(&proc);
+    }
+    catch (const Conv::CanceledError &) {
+        canceled = true;
+    }
+    canceler.join();
+
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - canceledAt).count();
+
+    QVERIFY(canceled);
+    QVERIFY2(latency < STOP_LATENCY, QString("Latency %1 ms").arg(latency).toLocal8Bit());
+
+    proc.waitForFinished(1000);
+    QCOMPARE(proc.state(), QProcess::NotRunning);
+
+    // The grandchild and the whole process group are gone
+    QVERIFY2(waitForProcessGone(sleepPid, 1000), "The sleep process is still running");
+    QVERIFY2(waitForProcessGone(-group, 1000), "The process group is still running");
+}
+
+/************************************************
+ * The stop() cancels all workers, their programs
+ * are killed within STOP_LATENCY.
+ ************************************************/
+void TestFlacon::testConverterStop()
+{
+    const QString root     = dir();
+    const QString flacFile = root + "/disc.flac";
+    QVERIFY(QFile::copy(mAudio_cd_flac, flacFile));
+
+    TestCueFile cueFile(root + "/disc.cue");
+    cueFile.setWavFile("disc.flac");
+    cueFile.addTrack("00:00:00");
+    cueFile.addTrack("07:30:00");
+    cueFile.write();
+
+    QScopedPointer<Disc> disc(loadFromCue(cueFile.fileName()));
+    QVERIFY(disc);
+
+    Settings::i()->selectProfile("FLAC");
+    Profile profile = Settings::i()->currentProfile();
+    profile.setOutFileDir(root + "/out");
+    profile.setValue("Compression", 8);
+
+    Conv::Converter::Job job;
+    job.disc = disc.data();
+    for (int i = 0; i < disc->count(); ++i) {
+        job.tracks << disc->track(i);
+    }
+
+    Conv::Converter converter;
+    bool            encoding = false;
+    connect(&converter, &Conv::Converter::trackProgress, [&encoding](const Track &, TrackState state, Percent) {
+        encoding = encoding || state == TrackState::Encoding;
+    });
+
+    converter.start(Conv::Converter::Jobs() << job, profile);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!encoding && converter.isRunning() && timer.elapsed() < 30 * 1000) {
+        QTest::qWait(10);
+    }
+    QVERIFY2(encoding, "The encoder was not started");
+    QVERIFY(converter.isRunning());
+    QVERIFY(childProcessCount() > 0);
+
+    timer.restart();
+    converter.stop();
+    QVERIFY(!converter.isRunning());
+
+    while (childProcessCount() > 0 && timer.elapsed() < 3000) {
+        QTest::qWait(5);
+    }
+
+    QCOMPARE(childProcessCount(), 0);
+    QVERIFY2(timer.elapsed() < STOP_LATENCY, QString("Latency %1 ms").arg(timer.elapsed()).toLocal8Bit());
+}
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testCancellationTokenPause()
+{
+    Conv::CancellationToken token;
+    token.pause();
+    QVERIFY(token.isPaused());
+
+    std::thread resumer([token]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        token.resume();
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    token.waitIfPaused();
+    resumer.join();
+
+    QVERIFY2(timer.elapsed() >= 90, QString("Elapsed %1 ms").arg(timer.elapsed()).toLocal8Bit());
+    QVERIFY(!token.isPaused());
+
+    // The parked worker is released by cancel
+    token.pause();
+    std::thread canceler([token]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        token.cancel();
+    });
+
+    QVERIFY_EXCEPTION_THROWN(token.waitIfPaused(), Conv::CanceledError);
+    canceler.join();
+}
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testStallWatchdog()
+{
+    Conv::CancellationToken token;
+    Conv::StallWatchdog     watchdog("/usr/bin/mac", 100, token);
+
+    // The progress restarts the timer
+    for (int i = 0; i < 5; ++i) {
+        QTest::qSleep(40);
+        watchdog.addBytes(1024);
+        watchdog.check();
+    }
+    QCOMPARE(watchdog.bytes(), qint64(5 * 1024));
+
+    // The time in the pause is not counted
+    token.pause();
+    QTest::qSleep(150);
+    watchdog.check();
+    token.resume();
+    watchdog.check();
+
+    QTest::qSleep(150);
+    try {
+        watchdog.check();
+        QFAIL("StalledError is not thrown");
+    }
+    catch (const Conv::StalledError &err) {
+        QCOMPARE(err.program(), QString("mac"));
+    }
+}
@@ -0,0 +1,150 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "tools.h"
+#include "settings.h"
+#include "../converter/conversioncache.h"
+
+#include <QTest>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+/************************************************
+ *
+ ************************************************/
+static QByteArray readAll(const QString &fileName)
+{
+    QFile file(fileName);
+    file.open(QFile::ReadOnly);
+    return file.readAll();
+}
+
+/************************************************
+ *
+ ************************************************/
+static void writeData(const QString &fileName, const QByteArray &data)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        QFAIL(QString("Can't create %1: %2").arg(fileName, file.errorString()).toLocal8Bit());
+    }
+    file.write(data);
+}
+
+/************************************************
+ *
+ ************************************************/
+static void setMTime(const QString &fileName, const QDateTime &time)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadWrite) || !file.setFileTime(time, QFileDevice::FileModificationTime)) {
+        QFAIL(QString("Can't set time for %1: %2").arg(fileName, file.errorString()).toLocal8Bit());
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testConversionCache()
+{
+    const QString root     = dir();
+    const QString cacheDir = root + "/cache";
+    const QString input    = root + "/track.wav";
+    const QString program  = root + "/encoder";
+    const QString encoded  = root + "/encoded";
+    const QString out      = root + "/out";
+
+    Settings::i()->setValue(Settings::ConvCache_Enabled, true);
+    Settings::i()->setValue(Settings::ConvCache_Dir, cacheDir);
+    Settings::i()->setValue(Settings::ConvCache_MaxSize, 1); // Mb
+
+    QVERIFY(QFile::copy(mTmpDir + "1sec.wav", input));
+    writeData(program, "#!/bin/sh\n");
+    writeData(encoded, QByteArray(400 * 1024, 'E'));
+
+    Settings::i()->selectProfile("FLAC");
+    const Profile profile = Settings::i()->currentProfile();
+
+    Conv::ConversionCache *cache = Conv::ConversionCache::instance();
+    cache->resetStatistic();
+
+    ReplayGain::TrackGain trackGain;
+    QByteArray            wav = readAll(input);
+    trackGain.add(wav.constData(), wav.size());
+    const ReplayGain::Result gain = trackGain.result();
+
+    // Hit .....................................
+    const QByteArray key = cache->key(input, profile, program);
+    QVERIFY(!key.isEmpty());
+    QVERIFY(!cache->get(key, out, false, nullptr));
+
+    cache->put(key, encoded, &gain);
+
+    ReplayGain::Result cached;
+    QVERIFY(cache->get(key, out, true, &cached));
+    QCOMPARE(readAll(out), readAll(encoded));
+    QCOMPARE(cached.gain(), gain.gain());
+    QCOMPARE(cached.peak(), gain.peak());
+
+    QCOMPARE(cache->statistic().hits, 1);
+    QCOMPARE(cache->statistic().misses, 1);
+
+    // Changed encoder mtime, miss .............
+    setMTime(program, QFileInfo(program).lastModified().addSecs(10));
+
+    const QByteArray changed = cache->key(input, profile, program);
+    QVERIFY(changed != key);
+    QVERIFY(!cache->get(changed, out, false, nullptr));
+    QCOMPARE(cache->statistic().misses, 2);
+
+    // LRU eviction by size ....................
+    QVERIFY(QDir(cacheDir).removeRecursively());
+
+    QList<QByteArray> keys;
+    QStringList       entries;
+    for (int i = 0; i < 3; ++i) {
+        keys << cache->key(input, profile, program, QByteArray::number(i));
+        entries << QString("%1/%2/%3").arg(cacheDir, QString::fromLatin1(keys.last().left(2)), QString::fromLatin1(keys.last()));
+        cache->put(keys.last(), encoded, nullptr);
+        QVERIFY(QFile::exists(entries.last()));
+        setMTime(entries.last(), QDateTime::currentDateTime().addSecs(-300 + i * 100));
+    }
+
+    // The first entry is the oldest, but it was just used
+    QVERIFY(cache->get(keys[0], out, false, nullptr));
+
+    cache->evict();
+    QVERIFY(QFile::exists(entries[0]));
+    QVERIFY(!QFile::exists(entries[1]));
+    QVERIFY(QFile::exists(entries[2]));
+
+    // The cache fits, nothing is removed
+    cache->evict();
+    QVERIFY(QFile::exists(entries[0]));
+    QVERIFY(QFile::exists(entries[2]));
+}
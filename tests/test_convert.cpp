@@ -68,13 +68,19 @@ static void createStartSh(const QString fileName, const QString flaconBin, const
 /************************************************
  *
  ************************************************/
-static bool runConvert(const QString &dir, const QString &inDir, const QString &cfgFile)
+static bool runConvert(const QString &dir, const QString &inDir, const QString &cfgFile, const QStringList &profiles, QByteArray *stdOut)
 {
     QString     flacon = QCoreApplication::applicationDirPath() + "/../flacon";
     QStringList args;
     args << "--config" << cfgFile;
     args << "--start";
     args << "--debug";
+
+    if (!profiles.isEmpty()) {
+        args << "--profile" << profiles.join(",");
+        args << "--progress";
+    }
+
     args << inDir.toLocal8Bit().data();
 
     createStartSh(dir + "/start.sh", flacon, args);
@@ -90,10 +96,12 @@ static bool runConvert(const QString &dir, const QString &inDir, const QString &
         return false;
     }
 
+    *stdOut = proc.readAllStandardOutput();
+
     if (proc.exitCode() != 0) {
         FAIL(QString("flacon returned non-zero exit status %1: %2")
                      .arg(proc.exitCode())
-                     .arg(QString::fromLocal8Bit(proc.readAll()))
+                     .arg(QString::fromLocal8Bit(*stdOut))
                      .toLocal8Bit());
         return false;
     }
@@ -151,6 +159,24 @@ static QByteArray readTag(const QString &file, const QString &tag)
     return {};
 }
 
+/************************************************
+ * Returns the value without the "TAG=" prefix,
+ * the value can be multiline.
+ ************************************************/
+static QString readFlacTag(const QString &file, const QString &tag)
+{
+    QProcess proc;
+    proc.start("metaflac", QStringList() << "--show-tag=" + tag << file);
+    proc.waitForFinished();
+    if (proc.exitCode() != 0) {
+        FAIL(QString("Can't read \"%1\" tag from \"%2\": %3").arg(tag, file, QString::fromLocal8Bit(proc.readAllStandardError())).toLocal8Bit());
+        return {};
+    }
+
+    QString res = QString::fromUtf8(proc.readAllStandardOutput()).trimmed();
+    return res.mid(res.indexOf('=') + 1);
+}
+
 /************************************************
  *
  ************************************************/
@@ -250,7 +276,13 @@ void TestFlacon::testConvert()
     // ..........................................
 
     // Run flacon ...............................
-    if (!runConvert(dir(), inDir, cfgFile)) {
+    QStringList profiles;
+    for (const QString &id : spec.value("Run/Profiles").toStringList()) {
+        profiles << id.trimmed();
+    }
+
+    QByteArray stdOut;
+    if (!runConvert(dir(), inDir, cfgFile, profiles, &stdOut)) {
         return;
     }
 
@@ -308,6 +340,19 @@ void TestFlacon::testConvert()
     spec.endGroup();
     // ..........................................
 
+    // ..........................................
+    // With several profiles every output file is reported by the console
+    spec.beginGroup("Result_Progress");
+    const QStringList progress = QString::fromLocal8Bit(stdOut).split('\n');
+    foreach (auto key, spec.allKeys()) {
+        QString line = spec.value(key).toString() + " " + outDir + "/" + key;
+        if (progress.count(line) != 1) {
+            msg += QString("\nThe progress line \"%1\" expected once, found %2 times").arg(line).arg(progress.count(line));
+        }
+    }
+    spec.endGroup();
+    // ..........................................
+
     //    // ******************************************
     //    // Check commands
     //    spec.beginGroup("Check_Commands");
@@ -411,3 +456,97 @@ void TestFlacon::testConvert_data()
     }
     QDir::setCurrent(curDir);
 }
+
+/************************************************
+ * The image is converted together with the
+ * per-track files. The embedded CUE keeps the
+ * source indexes, and each track gain in the CUE
+ * is the same as the gain of the split track.
+ ************************************************/
+void TestFlacon::testConvertWholeImage()
+{
+    if (QProcessEnvironment::systemEnvironment().contains("FLACON_SKIP_CONVERT_TEST"))
+        QTest::qSkip("Skipping testConvert", __FILE__, __LINE__);
+
+    const QString root    = dir();
+    const QString inDir   = root + "/IN";
+    const QString outDir  = root + "/OUT";
+    const QString cfgFile = root + "/flacon.conf";
+    QDir(inDir).mkpath(".");
+
+    QVERIFY(QFile::copy(mTmpDir + "1min.wav", inDir + "/disc.wav"));
+
+    TestCueFile cueFile(inDir + "/disc.cue");
+    cueFile.setWavFile("disc.wav");
+    cueFile.addTrack("00:00:00");
+    cueFile.addTrack("00:14:50", "00:15:00");
+    cueFile.addTrack("00:40:20");
+    cueFile.write();
+
+    writeTextFile(cfgFile, QStringList()
+                                   << "[OutFiles]"
+                                   << "Profile=Image"
+                                   << ""
+                                   << "[Profiles/Image]"
+                                   << "Format=FLAC"
+                                   << "WholeImage=true"
+                                   << "ReplayGain=Track"
+                                   << "CreateCue=false"
+                                   << "CueFileName=image.cue"
+                                   << "OutDirectory=" + outDir + "/image"
+                                   << "OutPattern=%n"
+                                   << ""
+                                   << "[Profiles/Tracks]"
+                                   << "Format=FLAC"
+                                   << "ReplayGain=Track"
+                                   << "CreateCue=false"
+                                   << "OutDirectory=" + outDir + "/tracks"
+                                   << "OutPattern=%n"
+                                   << "PregapType=AddToFirst");
+
+    const QStringList profiles = QStringList() << "Image"
+                                               << "Tracks";
+
+    QByteArray stdOut;
+    if (!runConvert(root, inDir, cfgFile, profiles, &stdOut)) {
+        return;
+    }
+
+    const QString image = outDir + "/image/image.flac";
+    QVERIFY2(QFile::exists(image), image.toLocal8Bit());
+
+    // Parse the embedded CUE ....................
+    QMap<int, QStringList> indexes;
+    QMap<int, QString>     gains;
+    int                    track = 0;
+    for (QString line : readFlacTag(image, "CUESHEET").split('\n')) {
+        line = line.trimmed();
+
+        if (line.startsWith("TRACK ")) {
+            track = line.section(' ', 1, 1).toInt();
+        }
+
+        if (line.startsWith("INDEX ")) {
+            indexes[track] << line;
+        }
+
+        if (line.startsWith("REM REPLAYGAIN_TRACK_GAIN ")) {
+            gains[track] = line.mid(QString("REM REPLAYGAIN_TRACK_GAIN ").length());
+        }
+    }
+
+    QCOMPARE(indexes.value(1), QStringList() << "INDEX 01 00:00:00");
+    QCOMPARE(indexes.value(2), QStringList() << "INDEX 00 00:14:50"
+                                             << "INDEX 01 00:15:00");
+    QCOMPARE(indexes.value(3), QStringList() << "INDEX 01 00:40:20");
+
+    // Per-segment gains .........................
+    QCOMPARE(gains.count(), 3);
+    for (int i = 1; i <= 3; ++i) {
+        const QString file = QString("%1/tracks/%2.flac").arg(outDir).arg(i, 2, 10, QChar('0'));
+        QVERIFY2(QFile::exists(file), file.toLocal8Bit());
+        QCOMPARE(gains.value(i), readFlacTag(file, "REPLAYGAIN_TRACK_GAIN"));
+    }
+
+    clearDir(dir());
+}
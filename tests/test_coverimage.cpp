@@ -0,0 +1,172 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "../converter/coverimage.h"
+#include "../converter/covercache.h"
+
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QDirIterator>
+#include <QBuffer>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSet>
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testCoverImage()
+{
+    const QString root = dir();
+    QDir().mkpath(root);
+
+    const QString fileName = root + "/cover.png";
+    QImage        src(200, 100, QImage::Format_RGB32);
+    src.fill(Qt::red);
+    QVERIFY(src.save(fileName, "PNG"));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray orig = file.readAll();
+    file.close();
+
+    // The image is not resized, the file is used as is
+    CoverImage full(fileName);
+    QCOMPARE(full.data(), orig);
+    QCOMPARE(full.size(), QSize(200, 100));
+    QCOMPARE(full.format(), CoverImage::Format::PNG);
+
+    CoverImage fits(fileName, 500);
+    QCOMPARE(fits.data(), orig);
+
+    CoverImage scaled(fileName, 50);
+    QCOMPARE(scaled.size(), QSize(50, 25));
+    QCOMPARE(scaled.mimeType(), QString("image/png"));
+
+    QImage res;
+    QVERIFY(res.loadFromData(scaled.data(), "PNG"));
+    QCOMPARE(res.size(), QSize(50, 25));
+
+    // The same file with the same size shares the data
+    CoverImage scaled2(fileName, 50);
+    QCOMPARE(scaled2.data().constData(), scaled.data().constData());
+}
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testCoverCache()
+{
+    const QString root = dir();
+    QDir().mkpath(root);
+
+    const QString fileName = root + "/cover.jpg";
+    QImage        src(300, 300, QImage::Format_RGB32);
+    src.fill(Qt::blue);
+    QVERIFY(src.save(fileName, "JPG"));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray orig = file.readAll();
+    file.close();
+
+    CoverCache cache(root + "/cache");
+
+    auto cacheFiles = [&cache]() {
+        QStringList  res;
+        QDirIterator it(cache.dir(), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            res << it.next();
+        }
+        return res;
+    };
+
+    cache.prefetch(fileName, 100);
+    cache.waitForDone();
+
+    QStringList entries = cacheFiles();
+    QCOMPARE(entries.count(), 1);
+
+    QFile entry(entries.first());
+    QVERIFY(entry.open(QFile::ReadOnly));
+    QCOMPARE(cache.scaled(orig, "jpeg", 100), entry.readAll());
+
+    // The images that fit are not cached
+    cache.prefetch(fileName, 500);
+    cache.waitForDone();
+    QCOMPARE(cacheFiles(), entries);
+
+    QImage res;
+    QVERIFY(res.loadFromData(cache.scaled(orig, "jpeg", 100), "JPG"));
+    QCOMPARE(res.size(), QSize(100, 100));
+
+    // Eviction removes the least recently used entries
+    cache.prefetch(fileName, 150);
+    cache.waitForDone();
+    const QString entry150 = (QSet<QString>::fromList(cacheFiles()) - QSet<QString>::fromList(entries)).values().first();
+    entries << entry150;
+
+    cache.prefetch(fileName, 200);
+    cache.waitForDone();
+    const QString entry200 = (QSet<QString>::fromList(cacheFiles()) - QSet<QString>::fromList(entries)).values().first();
+    entries << entry200;
+
+    qint64 total = 0;
+    int    age   = entries.count();
+    for (const QString &path : qAsConst(entries)) {
+        QFile f(path);
+        QVERIFY(f.open(QFile::ReadWrite));
+        QVERIFY(f.setFileTime(QDateTime::currentDateTime().addSecs(-3600 * age--), QFileDevice::FileModificationTime));
+        total += f.size();
+    }
+
+    // The 100 entry is the oldest, but it was just used
+    cache.scaled(orig, "jpeg", 100);
+
+    cache.setMaxSize(total);
+    cache.evict();
+    QCOMPARE(cacheFiles().count(), 3);
+
+    cache.setMaxSize(total - 1);
+    cache.evict();
+    QCOMPARE(QFileInfo::exists(entries.first()), true);
+    QCOMPARE(QFileInfo::exists(entry150), false);
+    QCOMPARE(QFileInfo::exists(entry200), true);
+
+    // The scaled image keeps the format of the source
+    QImage gray(300, 300, QImage::Format_Grayscale8);
+    gray.fill(128);
+    QBuffer grayBuf;
+    grayBuf.open(QBuffer::WriteOnly);
+    QVERIFY(gray.save(&grayBuf, "PNG"));
+
+    QImage grayRes;
+    QVERIFY(grayRes.loadFromData(cache.scaled(grayBuf.data(), "png", 100), "PNG"));
+    QCOMPARE(grayRes.size(), QSize(100, 100));
+    QCOMPARE(grayRes.format(), QImage::Format_Grayscale8);
+}
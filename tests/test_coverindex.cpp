@@ -0,0 +1,63 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "../coverindex.h"
+
+#include <QTest>
+#include <QDir>
+#include <QImage>
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testCoverIndex()
+{
+    const QString root = dir();
+    QDir().mkpath(root + "/scans");
+
+    QImage img(300, 200, QImage::Format_RGB32);
+    img.fill(Qt::red);
+    QVERIFY(img.save(root + "/scans/back.jpg", "JPG"));
+    QVERIFY(img.save(root + "/cover.png", "PNG"));
+
+    CoverIndex *index = CoverIndex::instance();
+
+    QStringList expected;
+    expected << root + "/cover.png";
+    expected << root + "/scans/back.jpg";
+    QCOMPARE(index->images(root), expected);
+    QCOMPARE(index->images(root), expected);
+
+    QCOMPARE(index->imageSize(root + "/cover.png"), QSize(300, 200));
+
+    // The new image in the subdirectory is found, the
+    // sleep guarantees the directory mtime is changed
+    QTest::qSleep(20);
+    QVERIFY(img.save(root + "/scans/front.jpg", "JPG"));
+
+    expected.insert(1, root + "/scans/front.jpg");
+    QCOMPARE(index->images(root), expected);
+}
@@ -0,0 +1,70 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "../cueindex.h"
+
+#include <QTest>
+#include <QDir>
+#include <QFile>
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testCueIndex()
+{
+    const QString root = dir();
+    QDir().mkpath(root);
+
+    auto writeCue = [this](const QString &fileName, const QString &title) {
+        writeTextFile(fileName, QStringList()
+                                        << QString("TITLE \"%1\"").arg(title)
+                                        << "FILE \"1.wav\" WAVE"
+                                        << "  TRACK 01 AUDIO"
+                                        << "    INDEX 01 00:00:00");
+    };
+
+    writeCue(root + "/1.cue", "Album");
+    writeTextFile(root + "/broken.cue", "broken");
+    QFile audio(root + "/1.wav");
+    QVERIFY(audio.open(QFile::WriteOnly));
+    audio.close();
+
+    CueIndex *index = CueIndex::instance();
+
+    QList<CueIndex::Entry> cues = index->cues(root);
+    QCOMPARE(cues.count(), 1);
+    QCOMPARE(cues.first().cue.title(), QString("Album"));
+    QVERIFY(cues.first().matcher.containsAudioFile(root + "/1.wav"));
+    QCOMPARE(index->audioFiles(root).count(), 1);
+
+    // The changed CUE file is parsed again
+    writeCue(root + "/1.cue", "The Album");
+    cues = index->cues(root);
+    QCOMPARE(cues.count(), 1);
+    QCOMPARE(cues.first().cue.title(), QString("The Album"));
+
+    QCOMPARE(index->matcher(cues.first().cue).audioFiles(0), QStringList(root + "/1.wav"));
+}
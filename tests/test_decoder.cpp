@@ -28,6 +28,8 @@
 #include "../converter/decoder.h"
 
 #include <QTest>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QVector>
 #include <QDebug>
 
@@ -90,6 +92,31 @@ void TestFlacon::testDecoder()
     }
 }
 
+/************************************************
+ * The write to the file must not wait for the
+ * bytesWritten, the file never reports it.
+ ************************************************/
+void TestFlacon::testDecoderToFile()
+{
+    QDir().mkpath(dir());
+
+    Conv::Decoder decoder;
+    QElapsedTimer timer;
+    timer.start();
+
+    try {
+        decoder.open(mAudio_cd_wav);
+        decoder.extract(CueTime("00:00:00"), CueTime("00:30:00"), dir() + "/out.wav");
+    }
+    catch (FlaconError &err) {
+        QFAIL(QString("Can't extract file '%1': %2").arg(mAudio_cd_wav, err.what()).toLocal8Bit());
+    }
+    decoder.close();
+
+    QVERIFY2(timer.elapsed() < 5000, QString("The decoding took %1 ms").arg(timer.elapsed()).toLocal8Bit());
+    compareAudioHash(dir() + "/out.wav", "7d6351521a02b625905edd28970b5a73");
+}
+
 /************************************************
  *
  ************************************************/
@@ -0,0 +1,147 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "../formats_in/flacmetadata.h"
+#include "../types.h"
+
+#include <QBuffer>
+#include <QTest>
+#include <QtEndian>
+
+/************************************************
+ *
+ ************************************************/
+static QByteArray flacBlock(int type, const QByteArray &data, bool last = false)
+{
+    uchar hdr[4];
+    qToBigEndian<quint32>(quint32(data.size()), hdr);
+    hdr[0] = uchar(type) | (last ? 0x80 : 0x00);
+    return QByteArray(reinterpret_cast<const char *>(hdr), 4) + data;
+}
+
+/************************************************
+ *
+ ************************************************/
+static QByteArray le32(quint32 v)
+{
+    uchar d[4];
+    qToLittleEndian(v, d);
+    return QByteArray(reinterpret_cast<const char *>(d), 4);
+}
+
+/************************************************
+ *
+ ************************************************/
+static QByteArray be32(quint32 v)
+{
+    uchar d[4];
+    qToBigEndian(v, d);
+    return QByteArray(reinterpret_cast<const char *>(d), 4);
+}
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testFlacMetadata()
+{
+    // 44100 Hz, 2 channels, 16 bits, 441000 samples
+    QByteArray streamInfo(34, '\0');
+    quint64    v = (quint64(44100) << 44) | (quint64(2 - 1) << 41) | (quint64(16 - 1) << 36) | 441000;
+    qToBigEndian(v, reinterpret_cast<uchar *>(streamInfo.data()) + 10);
+
+    QByteArray cue = "FILE \"CD.flac\" WAVE\n  TRACK 01 AUDIO\n    INDEX 01 00:00:00\n";
+
+    QByteArray comments;
+    comments += le32(6) + "vendor";
+    comments += le32(2);
+    comments += le32(12) + "TITLE=Album1";
+    comments += le32(9 + cue.size()) + "cuesheet=" + cue;
+
+    QByteArray image = "IMAGE_DATA";
+    QByteArray picture;
+    picture += be32(3);
+    picture += be32(10) + "image/jpeg";
+    picture += be32(5) + "Front";
+    picture += be32(500) + be32(400) + be32(24) + be32(0);
+    picture += be32(image.size()) + image;
+
+    QByteArray data = "fLaC";
+    data += flacBlock(0, streamInfo);
+    data += flacBlock(4, comments);
+    data += flacBlock(1, QByteArray(16, '\0')); // PADDING
+    data += flacBlock(6, picture, true);
+    qint64 audioOffset = data.size();
+    data += "AUDIO";
+
+    try {
+        QBuffer buf(&data);
+        buf.open(QBuffer::ReadOnly);
+        FlacMetadata meta(&buf);
+
+        QCOMPARE(meta.streamInfo().sampleRate, quint32(44100));
+        QCOMPARE(meta.streamInfo().channelsCount, 2u);
+        QCOMPARE(meta.streamInfo().bitsPerSample, 16);
+        QCOMPARE(meta.streamInfo().totalSamples, quint64(441000));
+
+        QCOMPARE(meta.comment("title"), QByteArray("Album1"));
+        QCOMPARE(meta.cueSheet(), cue);
+
+        QCOMPARE(meta.pictures().count(), 1);
+        const FlacMetadata::Picture &pic = meta.pictures().first();
+        QCOMPARE(pic.type, 3u);
+        QCOMPARE(pic.mimeType, QString("image/jpeg"));
+        QCOMPARE(pic.description, QString("Front"));
+        QCOMPARE(pic.width, 500u);
+        QCOMPARE(pic.height, 400u);
+        QCOMPARE(FlacMetadata::readPicture(&buf, pic), image);
+
+        QCOMPARE(meta.audioOffset(), audioOffset);
+    }
+    catch (FlaconError &err) {
+        FAIL(err.what());
+    }
+
+    // The ID3v2 tag before the stream, 300 bytes
+    QByteArray id3    = QByteArray("ID3\x04\x00\x00", 6) + QByteArray("\x00\x00\x02\x2C", 4) + QByteArray(300, '\0');
+    QByteArray tagged = id3 + data;
+    try {
+        QBuffer buf(&tagged);
+        buf.open(QBuffer::ReadOnly);
+        FlacMetadata meta(&buf);
+
+        QCOMPARE(meta.cueSheet(), cue);
+        QCOMPARE(meta.audioOffset(), id3.size() + audioOffset);
+    }
+    catch (FlaconError &err) {
+        FAIL(err.what());
+    }
+
+    // Truncated stream
+    QByteArray broken = data.left(60);
+    QBuffer    buf(&broken);
+    buf.open(QBuffer::ReadOnly);
+    QVERIFY_EXCEPTION_THROWN(FlacMetadata meta(&buf), FlaconError);
+}
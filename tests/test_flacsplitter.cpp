@@ -0,0 +1,166 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "tools.h"
+#include "disc.h"
+#include "../converter/flacsplitter.h"
+#include "../converter/splitter.h"
+
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QProcess>
+
+/************************************************
+ *
+ ************************************************/
+static QMap<int, QString> runWorker(Conv::Worker *worker)
+{
+    QMap<int, QString> res;
+
+    QObject::connect(worker, &Conv::Worker::error, [](const Conv::ConvTrack &track, const QString &message) {
+        FAIL(QString("Track %1: %2").arg(track.trackNum()).arg(message));
+    });
+
+    auto onReady = [&res](const Conv::ConvTrack &track, const QString &outFileName) {
+        res[track.index()] = outFileName;
+    };
+
+    if (auto *splitter = qobject_cast<Conv::FlacSplitter *>(worker)) {
+        QObject::connect(splitter, &Conv::FlacSplitter::trackReady, onReady);
+    }
+
+    if (auto *splitter = qobject_cast<Conv::Splitter *>(worker)) {
+        QObject::connect(splitter, &Conv::Splitter::trackReady, onReady);
+    }
+
+    worker->run();
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testFlacSplitter()
+{
+    QFETCH(QString, audioFile);
+    QFETCH(QByteArray, trailer);
+
+    const QString root     = dir();
+    const QString flacFile = root + "/" + QFileInfo(audioFile).fileName();
+    QVERIFY(QFile::copy(audioFile, flacFile));
+
+    if (!trailer.isEmpty()) {
+        QFile f(flacFile);
+        QVERIFY(f.open(QFile::Append));
+        QCOMPARE(f.write(trailer), qint64(trailer.size()));
+    }
+
+    // The boundaries are not aligned to the FLAC frames
+    TestCueFile cueFile(root + "/disc.cue");
+    cueFile.setWavFile(QFileInfo(flacFile).fileName());
+    cueFile.addTrack("00:00:00");
+    cueFile.addTrack("01:30:37");
+    cueFile.addTrack("03:03:01");
+    cueFile.addTrack("07:00:55");
+    cueFile.write();
+
+    QScopedPointer<Disc> disc(loadFromCue(cueFile.fileName()));
+    QVERIFY(disc);
+    QCOMPARE(disc->audioFiles().first().filePath(), flacFile);
+
+    Conv::ConvTracks tracks;
+    for (int i = 0; i < disc->count(); ++i) {
+        tracks << Conv::ConvTrack(*disc->track(i));
+    }
+
+    QDir().mkpath(root + "/flac");
+    QDir().mkpath(root + "/wav");
+
+    Conv::FlacSplitter flacSplitter(disc.data(), tracks, root + "/flac");
+    QMap<int, QString> flacFiles = runWorker(&flacSplitter);
+
+    Conv::Splitter     splitter(disc.data(), tracks, root + "/wav");
+    QMap<int, QString> wavFiles = runWorker(&splitter);
+
+    QCOMPARE(flacFiles.count(), tracks.count());
+    QCOMPARE(wavFiles.count(), tracks.count());
+
+    QFile src(flacFile);
+    QVERIFY(src.open(QFile::ReadOnly));
+    QByteArray srcData       = src.readAll();
+    qint64     firstFramePos = 0;
+
+    const Conv::FlacSplitter::StreamInfo srcInfo   = Conv::FlacSplitter::readStreamInfo(reinterpret_cast<const uchar *>(srcData.constData()), srcData.size(), &firstFramePos);
+    const bool                           cdQuality = disc->audioFiles().first().isCdQuality();
+
+    // Only the last frame before the trailing data can't be copied as is
+    const Conv::FlacSplitter::Frames srcFrames = Conv::FlacSplitter::readFrames(reinterpret_cast<const uchar *>(srcData.constData()), srcData.size(), firstFramePos, srcInfo);
+    for (int i = 0; i < srcFrames.count() - 1; ++i) {
+        QVERIFY(srcFrames.at(i).verified);
+    }
+    QCOMPARE(srcFrames.last().verified, trailer.isEmpty());
+
+    auto toSample = [&](const CueTime &time) -> quint64 {
+        return cdQuality ? quint64(time.frames()) * 588 : quint64(time.milliseconds()) * srcInfo.sampleRate / 1000;
+    };
+
+    for (int i = 0; i < tracks.count(); ++i) {
+        const QString file = flacFiles.value(i);
+
+        QProcess flac;
+        flac.start(Settings::i()->programName("flac"), { "-t", "-s", file });
+        QVERIFY(flac.waitForFinished(60000));
+        QVERIFY2(flac.exitCode() == 0, qPrintable(QString::fromLocal8Bit(flac.readAllStandardError())));
+
+        QFile out(file);
+        QVERIFY(out.open(QFile::ReadOnly));
+        QByteArray outData = out.readAll();
+
+        const quint64 start = i == 0 ? 0 : toSample(disc->track(i)->cueIndex(1));
+        const quint64 end   = i + 1 < tracks.count() ? toSample(disc->track(i + 1)->cueIndex(1)) : srcInfo.totalSamples;
+
+        Conv::FlacSplitter::StreamInfo info = Conv::FlacSplitter::readStreamInfo(reinterpret_cast<const uchar *>(outData.constData()), outData.size(), &firstFramePos);
+        QCOMPARE(info.totalSamples, end - start);
+
+        QCOMPARE(calcAudioHash(file), calcAudioHash(wavFiles.value(i)));
+    }
+}
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testFlacSplitter_data()
+{
+    QTest::addColumn<QString>("audioFile");
+    QTest::addColumn<QByteArray>("trailer");
+
+    QByteArray id3v1 = QByteArray("TAG").append("Title").leftJustified(128, '\0');
+
+    QTest::newRow("CD") << mAudio_cd_flac << QByteArray();
+    QTest::newRow("24x96") << mAudio_24x96_flac << QByteArray();
+    QTest::newRow("CD ID3v1") << mAudio_cd_flac << id3v1;
+}
@@ -28,10 +28,12 @@
 #include "../formats_in/informat.h"
 #include "types.h"
 #include "../inputaudiofile.h"
+#include "../converter/decoder.h"
 
 #include <QTest>
 #include <QString>
 #include <QBuffer>
+#include <QFile>
 #include <QDebug>
 
 void TestFlacon::testInputAudioFile()
@@ -114,3 +116,44 @@ void TestFlacon::testInputAudioFile_data()
             << "900000"
             << "WavPack";
 }
+
+void TestFlacon::testProbeHeader()
+{
+    QFETCH(QString, fileName);
+
+    try {
+        QFile file(fileName);
+        QVERIFY(file.open(QFile::ReadOnly));
+        const InputFormat *format = InputFormat::formatForFile(&file);
+        QVERIFY(format);
+
+        file.seek(0);
+        InputFormat::HeaderInfo info;
+        QVERIFY(format->probeHeader(&file, &info));
+
+        // The probe should give the same result as the decoder
+        Conv::Decoder dec;
+        dec.open(fileName);
+        QCOMPARE(info.sampleRate, dec.wavHeader().sampleRate());
+        QCOMPARE(info.bitsPerSample, int(dec.wavHeader().bitsPerSample()));
+        QCOMPARE(info.channelsCount, uint(dec.wavHeader().numChannels()));
+        QCOMPARE(uint(info.totalSamples * 1000 / info.sampleRate), dec.duration());
+    }
+    catch (FlaconError &err) {
+        FAIL(err.what());
+    }
+}
+
+void TestFlacon::testProbeHeader_data()
+{
+    QTest::addColumn<QString>("fileName", nullptr);
+
+    QTest::newRow("01 mAudio_cd_ape") << mAudio_cd_ape;
+    QTest::newRow("02 mAudio_cd_flac") << mAudio_cd_flac;
+    QTest::newRow("03 mAudio_cd_tta") << mAudio_cd_tta;
+    QTest::newRow("04 mAudio_cd_wv") << mAudio_cd_wv;
+    QTest::newRow("05 mAudio_24x96_ape") << mAudio_24x96_ape;
+    QTest::newRow("06 mAudio_24x96_flac") << mAudio_24x96_flac;
+    QTest::newRow("07 mAudio_24x96_tta") << mAudio_24x96_tta;
+    QTest::newRow("08 mAudio_24x96_wv") << mAudio_24x96_wv;
+}
@@ -0,0 +1,96 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "../converter/journal.h"
+
+#include <QTest>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testJournal()
+{
+    const QString root = dir();
+
+    const QString doneFile = root + "/01.flac";
+    const QString failFile = root + "/02.flac";
+    writeTextFile(doneFile, "audio");
+    writeTextFile(failFile, "audio");
+
+    const QFileInfo done(doneFile);
+    const QString   size  = QString::number(done.size());
+    const QString   mtime = QString::number(done.lastModified().toMSecsSinceEpoch());
+
+    QStringList lines;
+    lines << R"({"event":"profile","id":"FLAC"})";
+    lines << R"({"event":"disc","file":"/music/1.cue"})";
+    lines << R"({"event":"disc","file":"/music/2.cue"})";
+    lines << QString(R"({"event":"track","audio":"1.flac","index":0,"state":"OK","files":[{"path":"%1","size":"%2","mtime":"%3"}]})").arg(doneFile, size, mtime);
+    lines << QString(R"({"event":"track","audio":"1.flac","index":1,"state":"OK","files":[{"path":"%1","size":"%2","mtime":"%3"}]})").arg(failFile, size, mtime);
+    lines << QString(R"({"event":"track","audio":"1.flac","index":1,"state":"Error","files":[{"path":"%1"}]})").arg(failFile);
+    lines << R"({"event":"disc","file":"/music/1.cue"})";
+
+    // The process was killed in the middle of the line
+    QFile file(root + "/journal.log");
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write(lines.join("\n").toUtf8());
+    file.write("\n{\"event\":\"track\",\"audio\":\"1.fl");
+    file.close();
+
+    Conv::Journal::State state = Conv::Journal(file.fileName()).read();
+    QCOMPARE(state.profileIds, QStringList() << "FLAC");
+    QCOMPARE(state.discFiles, QStringList() << "/music/1.cue"
+                                            << "/music/2.cue");
+    QCOMPARE(state.finished, false);
+    QVERIFY(state.isDone(doneFile));
+    QVERIFY(!state.isDone(failFile));
+
+    // The changed output is not trusted, even with the same size
+    QFile out(doneFile);
+    QVERIFY(out.open(QFile::ReadWrite));
+    out.setFileTime(done.lastModified().addSecs(-10), QFileDevice::FileModificationTime);
+    out.close();
+    QVERIFY(!state.isDone(doneFile));
+
+    // The records are appended, the old ones are kept
+    Conv::Journal journal(file.fileName());
+    QVERIFY(journal.open());
+    journal.writeFinished();
+    journal.close();
+
+    state = Conv::Journal(file.fileName()).read();
+    QCOMPARE(state.discFiles.count(), 2);
+    QCOMPARE(state.finished, true);
+
+    // The batch doesn't depend on the order
+    QCOMPARE(Conv::Journal::batchFileName({ "/a.cue", "/b.cue" }, { "FLAC", "MP3" }),
+             Conv::Journal::batchFileName({ "/b.cue", "/a.cue" }, { "MP3", "FLAC" }));
+    QVERIFY(Conv::Journal::batchFileName({ "/a.cue" }, { "FLAC" }) != Conv::Journal::batchFileName({ "/b.cue" }, { "FLAC" }));
+}
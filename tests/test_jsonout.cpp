@@ -0,0 +1,143 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "tools.h"
+#include "disc.h"
+#include "settings.h"
+#include "../jsonout.h"
+
+#include <QTest>
+#include <QBuffer>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+/************************************************
+ *
+ ************************************************/
+static QList<QJsonObject> readEvents(const QByteArray &data, const QString &type)
+{
+    QList<QJsonObject> res;
+    for (const QByteArray &line : data.split('\n')) {
+        QJsonObject event = QJsonDocument::fromJson(line).object();
+        if (event["event"].toString() == type) {
+            res << event;
+        }
+    }
+    return res;
+}
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testJsonOut()
+{
+    const QString root = dir();
+
+    QVERIFY(QFile::copy(mTmpDir + "1sec.wav", root + "/disc.wav"));
+
+    writeTextFile(root + "/disc.cue", QStringList()
+                                              << "TITLE \"Album\""
+                                              << "FILE \"disc.wav\" WAVE"
+                                              << "  TRACK 01 AUDIO"
+                                              << "    INDEX 01 00:00:00"
+                                              << "  TRACK 02 AUDIO"
+                                              << "    INDEX 01 00:00:50");
+
+    QScopedPointer<Disc> disc(loadFromCue(root + "/disc.cue"));
+    QVERIFY(disc);
+    const Track &track1 = *disc->track(0);
+    const Track &track2 = *disc->track(1);
+
+    Settings::i()->selectProfile("WAV");
+    Profile wav = Settings::i()->currentProfile();
+    wav.setOutFileDir(root + "/wav");
+
+    Settings::i()->selectProfile("FLAC");
+    Profile flac = Settings::i()->currentProfile();
+    flac.setOutFileDir(root + "/flac");
+
+    const QString wavFile  = track1.resultFilePath(wav);
+    const QString flacFile = track1.resultFilePath(flac);
+    QVERIFY(wavFile != flacFile);
+
+    QDir().mkpath(QFileInfo(wavFile).path());
+    QDir().mkpath(QFileInfo(flacFile).path());
+    writeTextFile(wavFile, "wav audio data");
+    writeTextFile(flacFile, "flac");
+
+    QBuffer buf;
+    buf.open(QBuffer::WriteOnly);
+
+    {
+        JsonOut out;
+        out.setOutput(&buf);
+        out.converterStarted();
+
+        out.outputProgress(track1, wav, wavFile, TrackState::Encoding, 50);
+        out.outputProgress(track1, flac, flacFile, TrackState::Encoding, 10);
+        out.outputProgress(track1, wav, wavFile, TrackState::OK, 0);
+        out.outputProgress(track1, flac, flacFile, TrackState::OK, 0);
+
+        out.trackFailed(track2, flac, track2.resultFilePath(flac), "Encoder failed");
+        out.outputProgress(track2, flac, track2.resultFilePath(flac), TrackState::Error, 0);
+        out.outputProgress(track2, wav, track2.resultFilePath(wav), TrackState::Aborted, 0);
+
+        out.converterFinished();
+        out.printStatistic();
+    }
+
+    // Every output file has its own state ......
+    QMap<QString, QJsonObject> done;
+    for (const QJsonObject &event : readEvents(buf.data(), "track")) {
+        if (event["state"].toString() == trackStateToString(TrackState::OK)) {
+            done[event["file"].toString()] = event;
+        }
+    }
+
+    QCOMPARE(done.count(), 2);
+    QCOMPARE(done[wavFile]["profile"].toString(), wav.id());
+    QCOMPARE(done[wavFile]["outputSize"].toInt(), int(QFileInfo(wavFile).size()));
+    QCOMPARE(done[flacFile]["profile"].toString(), flac.id());
+    QCOMPARE(done[flacFile]["outputSize"].toInt(), int(QFileInfo(flacFile).size()));
+
+    // The error belongs to the FLAC file ......
+    QList<QJsonObject> errors = readEvents(buf.data(), "error");
+    QCOMPARE(errors.count(), 1);
+    QCOMPARE(errors.first()["file"].toString(), track2.resultFilePath(flac));
+    QCOMPARE(errors.first()["profile"].toString(), flac.id());
+
+    // Summary ..................................
+    QList<QJsonObject> summary = readEvents(buf.data(), "summary");
+    QCOMPARE(summary.count(), 1);
+    QCOMPARE(summary.first()["outputBytes"].toInt(), int(QFileInfo(wavFile).size() + QFileInfo(flacFile).size()));
+
+    QJsonObject tracks = summary.first()["tracks"].toObject();
+    QCOMPARE(tracks[trackStateToString(TrackState::OK)].toInt(), 2);
+    QCOMPARE(tracks[trackStateToString(TrackState::Error)].toInt(), 1);
+    QCOMPARE(tracks[trackStateToString(TrackState::Aborted)].toInt(), 1);
+}
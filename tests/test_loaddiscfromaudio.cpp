@@ -92,6 +92,53 @@ void TestFlacon::testLoadDiscFromAudio_data()
     }
 }
 
+void TestFlacon::testLoadDiscsAsync()
+{
+    QLoggingCategory::setFilterRules("InputAudioFile.debug=false\n"
+                                     "AudioFileMatcher.debug=false\n"
+                                     "SearchAudioFiles.debug=false\n");
+
+    QDir          srcDir(mDataDir + "/testLoadDiscFromAudio");
+    QFileInfoList dirs = srcDir.entryInfoList(QStringList("*"), QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+
+    QStringList files;
+    for (const QFileInfo &dir : dirs) {
+        QSettings spec(dir.filePath() + "/test.spec", QSettings::IniFormat);
+        spec.setIniCodec("UTF-8");
+        files << dir.filePath() + "/" + spec.value("LOAD").toString();
+    }
+
+    // The same file twice gives one disc
+    files << files.first();
+
+    TestProject p;
+    int         progress = 0;
+    QStringList errors;
+    connect(&p, &Project::loadProgress, [&](int loaded, int) { progress = loaded; });
+    connect(&p, &Project::loadError, [&](const QString &, const QString &message) { errors << message; });
+
+    p.addFilesAsync(files);
+    QVERIFY(p.isLoading());
+    p.waitForLoaded();
+    QVERIFY(!p.isLoading());
+
+    QCOMPARE(errors, QStringList());
+    QCOMPARE(progress, files.count());
+    QCOMPARE(p.count(), dirs.count());
+
+    // The discs are in the order of files
+    for (int i = 0; i < dirs.count(); ++i) {
+        QSettings spec(dirs[i].filePath() + "/test.spec", QSettings::IniFormat);
+        spec.setIniCodec("UTF-8");
+
+        Disc *disc = p.disc(i);
+        disc->setCodecName(spec.value("CODEC", "UTF-8").toString());
+        Tests::DiscSpec(dirs[i].filePath() + "/disc.expected").verify(*disc);
+    }
+
+    qDeleteAll(p.disks());
+}
+
 void TestFlacon::testLoadDiscFromAudioErrors()
 {
     QFETCH(QString, dir);
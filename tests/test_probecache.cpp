@@ -0,0 +1,84 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "../probecache.h"
+
+#include <QTest>
+#include <QFile>
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testProbeCache()
+{
+    const QString cacheFile = dir() + "/probe.cache";
+    const QString audioFile = dir() + "/1.flac";
+
+    QFile file(audioFile);
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write("1234");
+    file.close();
+
+    ProbeCache::Entry entry;
+    entry.format        = "FLAC";
+    entry.sampleRate    = 44100;
+    entry.bitsPerSample = 16;
+    entry.channelsCount = 2;
+    entry.duration      = 1000;
+    entry.cdQuality     = true;
+    entry.embeddedCue   = "TRACK 01 AUDIO";
+
+    {
+        ProbeCache cache(cacheFile);
+        QVERIFY(!cache.get(audioFile, &entry));
+        cache.put(audioFile, entry);
+        cache.save();
+    }
+
+    {
+        ProbeCache        cache(cacheFile);
+        ProbeCache::Entry res;
+        QVERIFY(cache.get(audioFile, &res));
+        QCOMPARE(res.format, entry.format);
+        QCOMPARE(res.sampleRate, entry.sampleRate);
+        QCOMPARE(res.bitsPerSample, entry.bitsPerSample);
+        QCOMPARE(res.channelsCount, entry.channelsCount);
+        QCOMPARE(res.duration, entry.duration);
+        QCOMPARE(res.cdQuality, entry.cdQuality);
+        QCOMPARE(res.embeddedCue, entry.embeddedCue);
+    }
+
+    // The changed file is probed again
+    QVERIFY(file.open(QFile::Append));
+    file.write("5678");
+    file.close();
+
+    {
+        ProbeCache        cache(cacheFile);
+        ProbeCache::Entry res;
+        QVERIFY(!cache.get(audioFile, &res));
+    }
+}
@@ -0,0 +1,72 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "../converter/extprogram.h"
+#include "../converter/processusage.h"
+
+#include <QTest>
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testProcessUsage()
+{
+#ifdef Q_OS_UNIX
+    Conv::ProcessUsageStatistic *stat = Conv::ProcessUsageStatistic::instance();
+    stat->reset();
+
+    for (int i = 0; i < 2; ++i) {
+        ExtProgram proc;
+        proc.setUsageTag("Test");
+        proc.setProgram("sh");
+        proc.setArguments({ "-c", "read line; echo \"$line\"; exit 3" });
+        proc.start();
+        QVERIFY(proc.waitForStarted());
+        proc.write("hello\n");
+        proc.closeWriteChannel();
+        QVERIFY(proc.waitForFinished());
+
+        // The shim is transparent for the stdio and the exit code
+        QCOMPARE(proc.exitStatus(), QProcess::NormalExit);
+        QCOMPARE(proc.exitCode(), 3);
+        QCOMPARE(proc.readAllStandardOutput(), QByteArray("hello\n"));
+
+        QCOMPARE(proc.usage().count, 1);
+        QVERIFY(proc.usage().wallTime > 0);
+        QVERIFY(proc.usage().maxRss > 0);
+    }
+
+    QMap<QString, Conv::ProcessUsage> programs = stat->byProgram();
+    QCOMPARE(programs.keys(), QStringList() << "sh");
+    QCOMPARE(programs["sh"].count, 2);
+    QCOMPARE(stat->byTag().keys(), QStringList() << "Test");
+
+    stat->reset();
+    QVERIFY(stat->byProgram().isEmpty());
+#else
+    QSKIP("The resource usage is collected on Unix only");
+#endif
+}
@@ -0,0 +1,285 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "tools.h"
+#include "disc.h"
+#include "settings.h"
+#include "../converter/converter.h"
+#include "../jsonout.h"
+
+#include <QTest>
+#include <QBuffer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+namespace {
+
+struct ConvertResult
+{
+    QMap<int, TrackState> states; // Track number -> last state
+    int                   stalls   = 0;
+    int                   failures = 0;
+};
+
+}
+
+/************************************************
+ *
+ ************************************************/
+static void writeScript(const QString &fileName, const QStringList &lines)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        QFAIL(QString("Can't create %1: %2").arg(fileName, file.errorString()).toLocal8Bit());
+    }
+
+    file.write("#!/bin/sh\n");
+    file.write(lines.join("\n").toLocal8Bit());
+    file.write("\n");
+    file.setPermissions(file.permissions() | QFile::ExeOwner | QFile::ExeUser);
+}
+
+/************************************************
+ *
+ ************************************************/
+static int countLines(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        return 0;
+    }
+    return file.readAll().count('\n');
+}
+
+/************************************************
+ * Runs the converter in the event loop until it
+ * is finished.
+ ************************************************/
+static ConvertResult runConverter(Disc *disc, const Profile &profile, JsonOut *json = nullptr)
+{
+    Conv::Converter::Job job;
+    job.disc = disc;
+    for (int i = 0; i < disc->count(); ++i) {
+        job.tracks << disc->track(i);
+    }
+
+    ConvertResult   res;
+    Conv::Converter converter;
+    QEventLoop      loop;
+
+    QObject::connect(&converter, &Conv::Converter::trackProgress, [&res](const Track &track, TrackState state, Percent) {
+        res.states[track.trackNum()] = state;
+    });
+
+    QObject::connect(&converter, &Conv::Converter::trackStalled, [&res](const Track &, const QString &) {
+        res.stalls++;
+    });
+
+    QObject::connect(&converter, &Conv::Converter::trackFailed, [&res](const Track &, const Profile &, const QString &, const QString &) {
+        res.failures++;
+    });
+
+    if (json) {
+        QObject::connect(&converter, &Conv::Converter::outputProgress, json, &JsonOut::outputProgress);
+        QObject::connect(&converter, &Conv::Converter::trackFailed, json, &JsonOut::trackFailed);
+        QObject::connect(&converter, &Conv::Converter::finished, json, &JsonOut::converterFinished);
+    }
+
+    QObject::connect(&converter, &Conv::Converter::finished, &loop, &QEventLoop::quit);
+    QTimer::singleShot(60 * 1000, &loop, &QEventLoop::quit);
+
+    converter.start(Conv::Converter::Jobs() << job, profile);
+    if (converter.isRunning()) {
+        loop.exec();
+    }
+
+    return res;
+}
+
+/************************************************
+ * The first decoder stalls after the header, the
+ * watchdog kills it and the splitter is started
+ * again. The decoder that fails is not retried.
+ ************************************************/
+void TestFlacon::testSplitterRetry()
+{
+    const QString root = dir();
+
+    encodeAudioFile(mTmpDir + "1min.wav", root + "/disc.flac");
+
+    TestCueFile cueFile(root + "/disc.cue");
+    cueFile.setWavFile("disc.flac");
+    cueFile.addTrack("00:00:00");
+    cueFile.addTrack("00:30:00");
+    cueFile.write();
+
+    QScopedPointer<Disc> disc(loadFromCue(cueFile.fileName()));
+    QVERIFY(disc);
+
+    const QString flac = Settings::i()->programName("flac");
+    QVERIFY(!flac.isEmpty());
+
+    Settings::i()->setValue(Settings::Encoder_RetryCount, 2);
+    Settings::i()->setValue(Settings::Encoder_RetryDelay, 10);
+    Settings::i()->setValue(Settings::Encoder_StallTimeout, 1);
+
+    Settings::i()->selectProfile("WAV");
+    Profile profile = Settings::i()->currentProfile();
+    profile.setOutFileDir(root + "/out");
+
+    // Stall, then retry .........................
+    writeScript(root + "/stall.sh", QStringList()
+                                            << QString("echo run >> '%1/stall.runs'").arg(root)
+                                            << QString("if [ ! -f '%1/stall.marker' ]; then").arg(root)
+                                            << QString("    touch '%1/stall.marker'").arg(root)
+                                            << QString("    '%1' \"$@\" | head -c 100000").arg(flac)
+                                            << "    sleep 30"
+                                            << "    exit 0"
+                                            << "fi"
+                                            << QString("exec '%1' \"$@\"").arg(flac));
+
+    Settings::i()->setValue("Programs/flac", root + "/stall.sh");
+
+    ConvertResult res = runConverter(disc.data(), profile);
+    QCOMPARE(countLines(root + "/stall.runs"), 2);
+    QCOMPARE(res.stalls, 1);
+    QCOMPARE(res.failures, 1);
+    QCOMPARE(res.states.value(1), TrackState::OK);
+    QCOMPARE(res.states.value(2), TrackState::OK);
+    QVERIFY(QFile::exists(disc->track(0)->resultFilePath(profile)));
+    QVERIFY(QFile::exists(disc->track(1)->resultFilePath(profile)));
+
+    // Not transient error, no retry ...........
+    writeScript(root + "/fail.sh", QStringList()
+                                           << QString("echo run >> '%1/fail.runs'").arg(root)
+                                           << "exit 1");
+
+    Settings::i()->setValue("Programs/flac", root + "/fail.sh");
+
+    res = runConverter(disc.data(), profile);
+    QCOMPARE(countLines(root + "/fail.runs"), 1);
+    QCOMPARE(res.stalls, 0);
+    QCOMPARE(res.failures, 1);
+    QCOMPARE(res.states.value(1), TrackState::Error);
+}
+
+/************************************************
+ * The encoder of the second track fails several
+ * times. The request is retried up to RetryCount
+ * times, the first track is not affected.
+ ************************************************/
+void TestFlacon::testEncoderRetry()
+{
+    QFETCH(int, fails);
+    QFETCH(int, expectedRuns);
+    QFETCH(TrackState, expectedState);
+
+    const QString root = dir();
+
+    TestCueFile cueFile(root + "/disc.cue");
+    cueFile.setWavFile("disc.wav");
+    cueFile.addTrack("00:00:00");
+    cueFile.addTrack("00:30:00");
+    cueFile.write();
+    QVERIFY(QFile::copy(mTmpDir + "1min.wav", root + "/disc.wav"));
+
+    QScopedPointer<Disc> disc(loadFromCue(cueFile.fileName()));
+    QVERIFY(disc);
+
+    const QString flac = Settings::i()->programName("flac");
+    QVERIFY(!flac.isEmpty());
+
+    // The delay is long enough for the first track to finish
+    Settings::i()->setValue(Settings::Encoder_RetryCount, 2);
+    Settings::i()->setValue(Settings::Encoder_RetryDelay, 500);
+
+    // The temporary files of the second track are track-<uid>_02.*
+    writeScript(root + "/encoder.sh", QStringList()
+                                              << "case \"$*\" in"
+                                              << "*_02.encoded.*)"
+                                              << QString("    echo run >> '%1/encoder.runs'").arg(root)
+                                              << QString("    if [ $(wc -l < '%1/encoder.runs') -le %2 ]; then").arg(root).arg(fails)
+                                              << "        cat > /dev/null"
+                                              << "        exit 1"
+                                              << "    fi"
+                                              << "    ;;"
+                                              << "esac"
+                                              << QString("exec '%1' \"$@\"").arg(flac));
+
+    Settings::i()->setValue("Programs/flac", root + "/encoder.sh");
+
+    Settings::i()->selectProfile("FLAC");
+    Profile profile = Settings::i()->currentProfile();
+    profile.setOutFileDir(root + "/out");
+
+    QBuffer buf;
+    buf.open(QBuffer::WriteOnly);
+    JsonOut json;
+    json.setOutput(&buf);
+
+    ConvertResult res = runConverter(disc.data(), profile, &json);
+    json.printStatistic();
+
+    QCOMPARE(countLines(root + "/encoder.runs"), expectedRuns);
+    QCOMPARE(res.failures, qMin(fails, expectedRuns));
+    QCOMPARE(res.states.value(1), TrackState::OK);
+    QCOMPARE(res.states.value(2), expectedState);
+    QVERIFY(QFile::exists(disc->track(0)->resultFilePath(profile)));
+    QCOMPARE(QFile::exists(disc->track(1)->resultFilePath(profile)), expectedState == TrackState::OK);
+
+    // Every failed attempt is in the statistic
+    int         errors = 0;
+    QJsonObject summary;
+    for (const QByteArray &line : buf.data().split('\n')) {
+        QJsonObject event = QJsonDocument::fromJson(line).object();
+        if (event["event"].toString() == "error") {
+            ++errors;
+        }
+
+        if (event["event"].toString() == "summary") {
+            summary = event;
+        }
+    }
+
+    QCOMPARE(errors, res.failures);
+    QCOMPARE(summary["tracks"].toObject()[trackStateToString(expectedState)].toInt(), expectedState == TrackState::OK ? 2 : 1);
+}
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testEncoderRetry_data()
+{
+    QTest::addColumn<int>("fails", nullptr);
+    QTest::addColumn<int>("expectedRuns", nullptr);
+    QTest::addColumn<TrackState>("expectedState", nullptr);
+
+    QTest::newRow("transient") << 2 << 3 << TrackState::OK;
+    QTest::newRow("permanent") << 100 << 3 << TrackState::Error;
+}
@@ -0,0 +1,85 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "../scanner.h"
+
+#include <QTest>
+#include <QDir>
+#include <QFile>
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testScanner()
+{
+    const QString root = dir() + "/root";
+    QDir().mkpath(root + "/a/b");
+    QDir().mkpath(root + "/c");
+    QDir().mkpath(root + "/.hidden");
+
+    for (const QString &f : { "/a/1.flac", "/a/b/2.wv", "/c/3.APE", "/c/readme.txt", "/c/.4.flac", "/.hidden/5.flac" }) {
+        QFile file(root + f);
+        QVERIFY(file.open(QFile::WriteOnly));
+    }
+
+#ifdef Q_OS_UNIX
+    // The loop and the second path to the same directory
+    QVERIFY(QFile::link(root, root + "/c/loop"));
+    QVERIFY(QFile::link(root + "/a", root + "/link_a"));
+#endif
+
+    QStringList found;
+    int         batches = 0;
+    Scanner     scanner;
+    connect(&scanner, &Scanner::found, [&](const QStringList &files) {
+        batches++;
+        for (const QString &f : files) {
+            found << QFileInfo(f).canonicalFilePath();
+        }
+    });
+
+    scanner.start(root);
+    QVERIFY(scanner.isRunning());
+    scanner.waitForFinished();
+    QVERIFY(!scanner.isRunning());
+
+    found.sort();
+    QStringList expected;
+    expected << QFileInfo(root + "/a/1.flac").canonicalFilePath();
+    expected << QFileInfo(root + "/a/b/2.wv").canonicalFilePath();
+    expected << QFileInfo(root + "/c/3.APE").canonicalFilePath();
+    expected.sort();
+
+    QCOMPARE(found, expected);
+    QVERIFY(batches > 0);
+
+    // The stopped scanner is finished without results
+    found.clear();
+    scanner.start(root);
+    scanner.stop();
+    scanner.waitForFinished();
+    QVERIFY(!scanner.isRunning());
+}
@@ -0,0 +1,81 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "../converter/trace.h"
+
+#include <QTest>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <thread>
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testTrace()
+{
+    Conv::Trace::setEnabled(false);
+    {
+        Conv::TraceScope trace("disabled");
+    }
+
+    Conv::Trace::setEnabled(true);
+    {
+        Conv::TraceScope trace("main", 1);
+        QTest::qSleep(5);
+    }
+
+    std::thread worker([]() {
+        Conv::TraceScope trace("worker", 2);
+    });
+    worker.join();
+    Conv::Trace::setEnabled(false);
+
+    QString fileName = dir() + "/trace.json";
+    QVERIFY(Conv::Trace::save(fileName));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+
+    QJsonParseError err;
+    QJsonDocument   doc = QJsonDocument::fromJson(file.readAll(), &err);
+    QCOMPARE(err.error, QJsonParseError::NoError);
+
+    QMap<QString, QJsonObject> events;
+    for (const QJsonValue &v : doc.object()["traceEvents"].toArray()) {
+        QJsonObject e = v.toObject();
+        if (e["ph"].toString() == "X") {
+            events[e["name"].toString()] = e;
+        }
+    }
+
+    QCOMPARE(events.keys(), QStringList() << "main"
+                                          << "worker");
+    QVERIFY(events["main"]["dur"].toDouble() >= 5000);
+    QCOMPARE(events["main"]["args"].toObject()["track"].toInt(), 1);
+    QVERIFY(events["main"]["tid"].toInt() != events["worker"]["tid"].toInt());
+}
@@ -0,0 +1,88 @@
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ * (c)LGPL2+
+ *
+ * Flacon - audio File Encoder
+ * https://github.com/flacon/flacon
+ *
+ * Copyright: 2026
+ *   agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "testflacon.h"
+#include "tools.h"
+#include "disc.h"
+#include "../converter/trackmanifest.h"
+
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+/************************************************
+ *
+ ************************************************/
+void TestFlacon::testTrackManifest()
+{
+    const QString root = dir();
+
+    QVERIFY(QFile::copy(mTmpDir + "1sec.wav", root + "/disc.wav"));
+
+    writeTextFile(root + "/disc.cue", QStringList()
+                                              << "TITLE \"Album\""
+                                              << "FILE \"disc.wav\" WAVE"
+                                              << "  TRACK 01 AUDIO"
+                                              << "    INDEX 01 00:00:00"
+                                              << "  TRACK 02 AUDIO"
+                                              << "    INDEX 01 00:00:50");
+
+    QScopedPointer<Disc> disc(loadFromCue(root + "/disc.cue"));
+    QVERIFY(disc);
+    const Track &track = *disc->track(0);
+
+    Settings::i()->selectProfile("WAV");
+    Profile profile = Settings::i()->currentProfile();
+    profile.setOutFileDir(root + "/out");
+
+    const QString outFile = track.resultFilePath(profile);
+    QDir().mkpath(QFileInfo(outFile).path());
+    writeTextFile(outFile, "audio");
+
+    // Matching ................................
+    QVERIFY(!Conv::TrackManifest(track, profile).isUpToDate());
+    Conv::TrackManifest(track, profile).save();
+    QVERIFY(Conv::TrackManifest(track, profile).isUpToDate());
+
+    // Changed profile .........................
+    Profile changed = profile;
+    changed.setGainType(GainType::Album);
+    QCOMPARE(track.resultFilePath(changed), outFile);
+    QVERIFY(!Conv::TrackManifest(track, changed).isUpToDate());
+
+    // Changed output file .....................
+    writeTextFile(outFile, "changed audio");
+    QVERIFY(!Conv::TrackManifest(track, profile).isUpToDate());
+    Conv::TrackManifest(track, profile).save();
+    QVERIFY(Conv::TrackManifest(track, profile).isUpToDate());
+
+    // Changed source ..........................
+    QFile source(root + "/disc.wav");
+    QVERIFY(source.open(QFile::Append));
+    source.write(QByteArray(4, '\0'));
+    source.close();
+    QVERIFY(!Conv::TrackManifest(track, profile).isUpToDate());
+}
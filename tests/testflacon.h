@@ -82,8 +82,17 @@ private slots:
     void testInputAudioFile();
     void testInputAudioFile_data();
 
+    void testProbeHeader();
+    void testProbeHeader_data();
+
+    void testFlacMetadata();
+
+    void testFlacSplitter();
+    void testFlacSplitter_data();
+
     void testDecoder();
     void testDecoder_data();
+    void testDecoderToFile();
 
     void testByteArraySplit_data();
     void testByteArraySplit();
@@ -118,11 +127,39 @@ private slots:
     void testLoadDiscFromAudio();
     void testLoadDiscFromAudio_data();
 
+    void testLoadDiscsAsync();
+
     void testLoadDiscFromAudioErrors();
     void testLoadDiscFromAudioErrors_data();
 
     void testConvert();
     void testConvert_data();
+    void testConvertWholeImage();
+
+    void testCancellationToken();
+    void testCancellationTokenPause();
+    void testConverterStop();
+    void testStallWatchdog();
+    void testSplitterRetry();
+    void testEncoderRetry();
+    void testEncoderRetry_data();
+
+    void testTrace();
+    void testProcessUsage();
+    void testScanner();
+
+    void testProbeCache();
+    void testConversionCache();
+
+    void testCueIndex();
+    void testCoverIndex();
+
+    void testTrackManifest();
+    void testJournal();
+    void testJsonOut();
+
+    void testCoverImage();
+    void testCoverCache();
 
 private:
     void writeTextFile(const QString &fileName, const QString &content);
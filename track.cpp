@@ -146,14 +146,22 @@ void Track::setCodecName(const QString &value)
  ************************************************/
 QString Track::resultFileName() const
 {
-    QString pattern = project->currentProfile().outFilePattern();
+    return resultFileName(project->currentProfile());
+}
+
+/************************************************
+
+ ************************************************/
+QString Track::resultFileName(const Profile &profile) const
+{
+    QString pattern = profile.outFilePattern();
     if (pattern.isEmpty())
         pattern = QString("%a/%y - %A/%n - %t");
 
     int n = pattern.lastIndexOf(QDir::separator());
     if (n < 0) {
         PatternExpander expander(*this);
-        return safeFilePathLen(expander.expand(pattern) + "." + project->currentProfile().ext());
+        return safeFilePathLen(expander.expand(pattern) + "." + profile.ext());
     }
 
     // If the disc is a collection, the files fall into different directories.
@@ -164,7 +172,7 @@ QString Track::resultFileName() const
     PatternExpander trackExpander(*this);
 
     return safeFilePathLen(
-            albumExpander.expand(pattern.left(n)) + trackExpander.expand(pattern.mid(n)) + "." + project->currentProfile().ext());
+            albumExpander.expand(pattern.left(n)) + trackExpander.expand(pattern.mid(n)) + "." + profile.ext());
 }
 
 /************************************************
@@ -273,15 +281,23 @@ void Track::setDiscCount(DiscNum value)
  ************************************************/
 QString Track::resultFilePath() const
 {
-    QString fileName = resultFileName();
+    return resultFilePath(project->currentProfile());
+}
+
+/************************************************
+
+ ************************************************/
+QString Track::resultFilePath(const Profile &profile) const
+{
+    QString fileName = resultFileName(profile);
     if (fileName.isEmpty())
         return "";
 
-    QString dir = calcResultFilePath();
+    QString dir = calcResultFilePath(profile);
     if (dir.endsWith("/") || fileName.startsWith("/"))
-        return calcResultFilePath() + fileName;
+        return dir + fileName;
     else
-        return calcResultFilePath() + "/" + fileName;
+        return dir + "/" + fileName;
 }
 
 /************************************************
@@ -295,9 +311,9 @@ Duration Track::duration() const
 /************************************************
 
  ************************************************/
-QString Track::calcResultFilePath() const
+QString Track::calcResultFilePath(const Profile &profile) const
 {
-    QString dir = project->currentProfile().outFileDir();
+    QString dir = profile.outFileDir();
 
     if (dir == "~" || dir == "~//")
         return QDir::homePath();
@@ -508,6 +524,20 @@ QString UcharDet::textCodecName() const
     return textCodec()->name();
 }
 
+/************************************************
+ * The null value means the codepage is read
+ * from the settings.
+ ************************************************/
+static thread_local QString threadDefaultCodepage;
+
+/************************************************
+ *
+ ************************************************/
+void UcharDet::setThreadDefaultCodepage(const QString &value)
+{
+    threadDefaultCodepage = value;
+}
+
 /************************************************
  *
  ************************************************/
@@ -515,8 +545,10 @@ QTextCodec *UcharDet::textCodec() const
 {
     uchardet_data_end(mData->mUchcharDet);
     QTextCodec *res = QTextCodec::codecForName(uchardet_get_charset(mData->mUchcharDet));
-    if (!res)
-        res = QTextCodec::codecForName(Settings::i()->value(Settings::Tags_DefaultCodepage).toString().toLocal8Bit());
+    if (!res) {
+        QString codepage = threadDefaultCodepage.isNull() ? Settings::i()->value(Settings::Tags_DefaultCodepage).toString() : threadDefaultCodepage;
+        res              = QTextCodec::codecForName(codepage.toLocal8Bit());
+    }
 
     if (!res || res->name() == "US-ASCII")
         res = QTextCodec::codecForName("UTF-8");
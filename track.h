@@ -33,6 +33,7 @@
 #include <QDebug>
 
 class Disc;
+class Profile;
 
 class Track
 {
@@ -105,6 +106,9 @@ public:
     QString resultFileName() const;
     QString resultFilePath() const;
 
+    QString resultFileName(const Profile &profile) const;
+    QString resultFilePath(const Profile &profile) const;
+
     Duration duration() const;
 
     CueIndex cueIndex(int indexNum) const;
@@ -121,7 +125,7 @@ private:
     int            mIndex = -1;
     InputAudioFile mAudiofile;
 
-    QString calcResultFilePath() const;
+    QString calcResultFilePath(const Profile &profile) const;
     QString safeFilePathLen(const QString &path) const;
 };
 
@@ -165,6 +169,10 @@ public:
     QString     textCodecName() const;
     QTextCodec *textCodec() const;
 
+    // The threads that can't read the settings set
+    // the default codepage from the main thread.
+    static void setThreadDefaultCodepage(const QString &value);
+
 private:
     struct Data;
     Data *mData;
@@ -58,6 +58,39 @@ PreGapType strToPreGapType(const QString &str)
     return PreGapType::AddToFirstTrack;
 }
 
+/************************************************
+
+ ************************************************/
+QString trackStateToString(TrackState state)
+{
+    switch (state) {
+        case TrackState::NotRunning:
+            return "NotRunning";
+        case TrackState::Canceled:
+            return "Canceled";
+        case TrackState::Error:
+            return "Error";
+        case TrackState::Aborted:
+            return "Aborted";
+        case TrackState::OK:
+            return "OK";
+        case TrackState::Splitting:
+            return "Splitting";
+        case TrackState::Encoding:
+            return "Encoding";
+        case TrackState::Queued:
+            return "Queued";
+        case TrackState::WaitGain:
+            return "WaitGain";
+        case TrackState::CalcGain:
+            return "CalcGain";
+        case TrackState::WriteGain:
+            return "WriteGain";
+    }
+
+    return QString::number(int(state));
+}
+
 /************************************************
 
  ************************************************/
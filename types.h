@@ -178,6 +178,8 @@ enum class TrackState {
 
 Q_DECLARE_METATYPE(TrackState)
 
+QString trackStateToString(TrackState state);
+
 enum BitsPerSample {
     AsSourcee = 0,
     Bit_16    = 16,
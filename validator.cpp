@@ -325,6 +325,11 @@ bool Validator::validateAudioFiles(const Disk *disk, QStringList &errors, QStrin
         }
     }
 
+    if (mProfile.isWholeImage() && audioFileTracks.count() > 1) {
+        errors << tr("The disc consists of several audio files, it can't be converted to a single file.", "error message");
+        res = false;
+    }
+
     return res;
 }
 